@@ -0,0 +1,392 @@
+/* Evaluation of agent expressions by GDB.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This is a host-side version of the bytecode interpreter of
+   gdbserver (see gdbserver/ax.c), used to evaluate breakpoint
+   conditions without walking their expression trees.  */
+
+#include "defs.h"
+#include "ax.h"
+#include "ax-eval.h"
+#include "gdbcore.h"
+#include "regcache.h"
+#include "target.h"
+
+/* The maximum depth of the stack.  */
+
+#define AX_EVAL_STACK_MAX 100
+
+/* A cache of the memory read during an evaluation.  Conditions often
+   read several fields of the same object.  */
+
+class ax_memory_cache
+{
+public:
+
+  /* Read LEN bytes of memory at ADDR into BUF.  Throws an error if
+     the memory can't be read.  */
+  void read (CORE_ADDR addr, gdb_byte *buf, int len);
+
+private:
+
+  /* The size and number of the cached lines.  */
+  static const int line_size = 64;
+  static const int line_count = 4;
+
+  struct line
+  {
+    CORE_ADDR addr;
+    bool valid;
+    gdb_byte data[line_size];
+  };
+
+  line m_lines[line_count] = {};
+
+  /* The line to replace next.  */
+  int m_next = 0;
+};
+
+void
+ax_memory_cache::read (CORE_ADDR addr, gdb_byte *buf, int len)
+{
+  CORE_ADDR line_addr = addr & ~(CORE_ADDR) (line_size - 1);
+
+  /* Read accesses that cross lines directly.  */
+  if (addr + len > line_addr + line_size)
+    {
+      read_memory (addr, buf, len);
+      return;
+    }
+
+  for (line &l : m_lines)
+    if (l.valid && l.addr == line_addr)
+      {
+	memcpy (buf, l.data + (addr - line_addr), len);
+	return;
+      }
+
+  line &l = m_lines[m_next];
+
+  if (target_read_memory (line_addr, l.data, line_size) != 0)
+    {
+      /* Part of the line may be unreadable; read just what we
+	 need.  */
+      read_memory (addr, buf, len);
+      return;
+    }
+
+  l.addr = line_addr;
+  l.valid = true;
+  m_next = (m_next + 1) % line_count;
+  memcpy (buf, l.data + (addr - line_addr), len);
+}
+
+/* Return the GDB number of the register whose number in agent
+   expressions of GDBARCH is AX_REG.  */
+
+static int
+ax_eval_regnum (struct gdbarch *gdbarch, int ax_reg)
+{
+  for (int regnum = 0; regnum < gdbarch_num_regs (gdbarch); regnum++)
+    if (gdbarch_remote_register_number (gdbarch, regnum) == ax_reg)
+      return regnum;
+
+  error (_("Invalid register %d in agent expression."), ax_reg);
+}
+
+/* See ax-eval.h.  */
+
+bool
+ax_eval_supported (struct agent_expr *x)
+{
+  ax_reqs (x);
+  if (x->flaw != agent_flaw_none
+      || x->max_height >= AX_EVAL_STACK_MAX
+      || x->min_height < 0)
+    return false;
+
+  for (int pc = 0; pc < x->len; pc += 1 + aop_map[x->buf[pc]].op_size)
+    {
+      switch (x->buf[pc])
+	{
+	case aop_add:
+	case aop_sub:
+	case aop_mul:
+	case aop_div_signed:
+	case aop_div_unsigned:
+	case aop_rem_signed:
+	case aop_rem_unsigned:
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	case aop_log_not:
+	case aop_bit_and:
+	case aop_bit_or:
+	case aop_bit_xor:
+	case aop_bit_not:
+	case aop_equal:
+	case aop_less_signed:
+	case aop_less_unsigned:
+	case aop_ext:
+	case aop_zero_ext:
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	case aop_if_goto:
+	case aop_goto:
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	case aop_reg:
+	case aop_end:
+	case aop_dup:
+	case aop_pop:
+	case aop_swap:
+	case aop_pick:
+	case aop_rot:
+	  break;
+
+	default:
+	  return false;
+	}
+    }
+
+  return true;
+}
+
+/* See ax-eval.h.  */
+
+ULONGEST
+ax_eval (const struct agent_expr *x, struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = x->gdbarch;
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  const gdb_byte *code = x->buf;
+  ULONGEST stack[AX_EVAL_STACK_MAX];
+  ax_memory_cache memory;
+  gdb_byte buf[8];
+  int pc = 0;
+  int sp = 0;
+  int arg;
+
+  /* As in gdbserver, the top of the stack is kept in TOP, and the
+     elements below it in STACK.  */
+  ULONGEST top = 0;
+
+  while (pc < x->len)
+    {
+      enum agent_op op = (enum agent_op) code[pc++];
+
+      switch (op)
+	{
+	case aop_add:
+	  top += stack[--sp];
+	  break;
+
+	case aop_sub:
+	  top = stack[--sp] - top;
+	  break;
+
+	case aop_mul:
+	  top *= stack[--sp];
+	  break;
+
+	case aop_div_signed:
+	  if (top == 0)
+	    error (_("Division by zero"));
+	  top = ((LONGEST) stack[--sp]) / ((LONGEST) top);
+	  break;
+
+	case aop_div_unsigned:
+	  if (top == 0)
+	    error (_("Division by zero"));
+	  top = stack[--sp] / top;
+	  break;
+
+	case aop_rem_signed:
+	  if (top == 0)
+	    error (_("Division by zero"));
+	  top = ((LONGEST) stack[--sp]) % ((LONGEST) top);
+	  break;
+
+	case aop_rem_unsigned:
+	  if (top == 0)
+	    error (_("Division by zero"));
+	  top = stack[--sp] % top;
+	  break;
+
+	case aop_lsh:
+	  top = stack[--sp] << top;
+	  break;
+
+	case aop_rsh_signed:
+	  top = ((LONGEST) stack[--sp]) >> top;
+	  break;
+
+	case aop_rsh_unsigned:
+	  top = stack[--sp] >> top;
+	  break;
+
+	case aop_log_not:
+	  top = !top;
+	  break;
+
+	case aop_bit_and:
+	  top &= stack[--sp];
+	  break;
+
+	case aop_bit_or:
+	  top |= stack[--sp];
+	  break;
+
+	case aop_bit_xor:
+	  top ^= stack[--sp];
+	  break;
+
+	case aop_bit_not:
+	  top = ~top;
+	  break;
+
+	case aop_equal:
+	  top = (stack[--sp] == top);
+	  break;
+
+	case aop_less_signed:
+	  top = (((LONGEST) stack[--sp]) < ((LONGEST) top));
+	  break;
+
+	case aop_less_unsigned:
+	  top = (stack[--sp] < top);
+	  break;
+
+	case aop_ext:
+	  arg = code[pc++];
+	  if (arg > 0 && arg < 64)
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (arg - 1);
+
+	      top &= ((ULONGEST) 1 << arg) - 1;
+	      top = (top ^ mask) - mask;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  arg = code[pc++];
+	  if (arg < 64)
+	    top &= ((ULONGEST) 1 << arg) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    int len = aop_map[op].data_size / 8;
+
+	    memory.read ((CORE_ADDR) top, buf, len);
+	    top = extract_unsigned_integer (buf, len, byte_order);
+	  }
+	  break;
+
+	case aop_if_goto:
+	  if (top)
+	    pc = (code[pc] << 8) + code[pc + 1];
+	  else
+	    pc += 2;
+	  if (--sp >= 0)
+	    top = stack[sp];
+	  break;
+
+	case aop_goto:
+	  pc = (code[pc] << 8) + code[pc + 1];
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  stack[sp++] = top;
+	  top = 0;
+	  for (int i = 0; i < aop_map[op].op_size; i++)
+	    top = (top << 8) + code[pc++];
+	  break;
+
+	case aop_reg:
+	  stack[sp++] = top;
+	  arg = (code[pc] << 8) + code[pc + 1];
+	  pc += 2;
+	  {
+	    int regnum = ax_eval_regnum (gdbarch, arg);
+
+	    if (regcache_raw_read_unsigned (regcache, regnum, &top)
+		!= REG_VALID)
+	      error (_("Register %d is not available."), regnum);
+	  }
+	  break;
+
+	case aop_end:
+	  if (sp <= 0)
+	    error (_("Agent expression left nothing on the stack."));
+	  return top;
+
+	case aop_dup:
+	  stack[sp++] = top;
+	  break;
+
+	case aop_pop:
+	  if (--sp >= 0)
+	    top = stack[sp];
+	  break;
+
+	case aop_swap:
+	  stack[sp] = top;
+	  top = stack[sp - 1];
+	  stack[sp - 1] = stack[sp];
+	  break;
+
+	case aop_pick:
+	  arg = code[pc++];
+	  stack[sp] = top;
+	  top = stack[sp - arg];
+	  ++sp;
+	  break;
+
+	case aop_rot:
+	  {
+	    ULONGEST tem = stack[sp - 1];
+
+	    stack[sp - 1] = stack[sp - 2];
+	    stack[sp - 2] = top;
+	    top = tem;
+	  }
+	  break;
+
+	default:
+	  error (_("Unsupported agent expression opcode 0x%x."), op);
+	}
+
+      /* ax_eval_supported checked the stack height statically, so
+	 this can only fail if X was modified since.  */
+      gdb_assert (sp >= 0 && sp < AX_EVAL_STACK_MAX);
+    }
+
+  error (_("Agent expression has no end."));
+}
@@ -0,0 +1,42 @@
+/* Evaluation of agent expressions by GDB.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef AX_EVAL_H
+#define AX_EVAL_H
+
+struct agent_expr;
+struct regcache;
+
+/* Return true if the agent expression X can be evaluated by ax_eval.
+   Expressions that use trace state variables, collect data or print
+   can only be run by an agent.  This also computes the requirements
+   of X, as ax_reqs does.  */
+
+extern bool ax_eval_supported (struct agent_expr *x);
+
+/* Evaluate the agent expression X, for which ax_eval_supported
+   returned true, and return the value at the top of the stack when it
+   ends.  Registers are read from REGCACHE and memory from the current
+   inferior.  Throws an error if memory or a register can't be read,
+   or on division by zero.  */
+
+extern ULONGEST ax_eval (const struct agent_expr *x,
+			 struct regcache *regcache);
+
+#endif /* AX_EVAL_H */
@@ -84,6 +84,7 @@
 #include "progspace-and-thread.h"
 #include "common/array-view.h"
 #include "common/gdb_optional.h"
+#include "ax-eval.h"
 
 /* Enums for exception-handling support.  */
 enum exception_event_kind
@@ -100,6 +101,8 @@ static void map_breakpoint_numbers (const char *,
 
 static void breakpoint_re_set_default (struct breakpoint *);
 
+static void update_host_cond_bytecode (struct bp_location *loc);
+
 static void
   create_sals_from_location_default (const struct event_location *location,
 				     struct linespec_result *canonical,
@@ -388,6 +391,20 @@ show_always_inserted_mode (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* If on (default), GDB evaluates the breakpoint conditions it can
+   compile to agent expressions with its bytecode interpreter, instead
+   of walking their expression trees.  */
+static int condition_bytecode = 1;
+
+static void
+show_condition_bytecode (struct ui_file *file, int from_tty,
+			 struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Evaluation of breakpoint conditions "
+			    "as bytecode is %s.\n"),
+		    value);
+}
+
 /* See breakpoint.h.  */
 
 int
@@ -541,6 +558,14 @@ static struct bp_location **bp_locations;
 
 static unsigned bp_locations_count;
 
+/* The generation of BP_LOCATIONS, incremented each time
+   update_global_location_list rebuilds it.  The locations in
+   BP_LOCATIONS have this generation in their GLOBAL_LIST_GENERATION;
+   locations not yet added to it have zero, which is never a valid
+   generation.  */
+
+static unsigned int bp_locations_generation = 1;
+
 /* Maximum alignment offset between bp_target_info.PLACED_ADDRESS and
    ADDRESS for the current elements of BP_LOCATIONS which get a valid
    result from bp_location_has_shadow.  You can use it for roughly
@@ -855,6 +880,7 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
       for (loc = b->loc; loc; loc = loc->next)
 	{
 	  loc->cond.reset ();
+	  loc->host_cond_bytecode.reset ();
 
 	  /* No need to free the condition agent expression
 	     bytecode (if we have one).  We will handle this
@@ -899,6 +925,7 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
 			     block_for_pc (loc->address), 0);
 	      if (*arg)
 		error (_("Junk at end of expression"));
+	      update_host_cond_bytecode (loc);
 	    }
 	}
     }
@@ -2113,6 +2140,19 @@ parse_cond_to_aexpr (CORE_ADDR scope, struct expression *cond)
   return aexpr;
 }
 
+/* Compile the condition of LOC to bytecode for evaluation by GDB, if
+   it can be.  */
+
+static void
+update_host_cond_bytecode (struct bp_location *loc)
+{
+  loc->host_cond_bytecode = parse_cond_to_aexpr (loc->address,
+						 loc->cond.get ());
+  if (loc->host_cond_bytecode != NULL
+      && !ax_eval_supported (loc->host_cond_bytecode.get ()))
+    loc->host_cond_bytecode.reset ();
+}
+
 /* Based on location BL, create a list of breakpoint conditions to be
    passed on to the target.  If we have duplicated locations with different
    conditions, we will add such conditions to the list.  The idea is that the
@@ -4202,6 +4242,7 @@ bpstats::bpstats (const bpstats &other)
     commands (other.commands),
     print (other.print),
     stop (other.stop),
+    cond_false (other.cond_false),
     print_it (other.print_it)
 {
   if (other.old_val != NULL)
@@ -4209,6 +4250,16 @@ bpstats::bpstats (const bpstats &other)
   incref_bp_location (bp_location_at);
 }
 
+/* See breakpoint.h.  */
+
+void
+bpstat_note_stop_all_threads (bpstat bs)
+{
+  for (; bs != NULL; bs = bs->next)
+    if (bs->cond_false && bs->breakpoint_at != NULL)
+      bs->breakpoint_at->cond_false_stop_all_count++;
+}
+
 /* Return a copy of a bpstat.  Like "bs1 = bs2" but all storage that
    is part of the bpstat is copied as well.  */
 
@@ -4687,6 +4738,34 @@ breakpoint_cond_eval (expression *exp)
   return res;
 }
 
+/* Evaluate COND, the condition of the location BL, and return the
+   result.  Use the bytecode of the condition if it has one, and set
+   *BYTECODE if so.  */
+
+static bool
+breakpoint_location_cond_eval (const struct bp_location *bl,
+			       expression *cond, bool *bytecode)
+{
+  if (bl->host_cond_bytecode != NULL && condition_bytecode)
+    {
+      try
+	{
+	  ULONGEST result = ax_eval (bl->host_cond_bytecode.get (),
+				     get_current_regcache ());
+
+	  *bytecode = true;
+	  return result != 0;
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* Let the expression evaluator try, and report the error
+	     if it fails too.  */
+	}
+    }
+
+  return breakpoint_cond_eval (cond);
+}
+
 /* Allocate a new bpstat.  Link it to the FIFO list by BS_LINK_POINTER.  */
 
 bpstats::bpstats (struct bp_location *bl, bpstat **bs_link_pointer)
@@ -4696,6 +4775,7 @@ bpstats::bpstats (struct bp_location *bl, bpstat **bs_link_pointer)
     commands (NULL),
     print (0),
     stop (0),
+    cond_false (0),
     print_it (print_it_normal)
 {
   incref_bp_location (bl);
@@ -4710,6 +4790,7 @@ bpstats::bpstats ()
     commands (NULL),
     print (0),
     stop (0),
+    cond_false (0),
     print_it (print_it_normal)
 {
 }
@@ -5249,15 +5330,31 @@ bpstat_check_breakpoint_conditions (bpstat bs, thread_info *thread)
 	}
       if (within_current_scope)
 	{
+	  std::chrono::steady_clock::time_point start
+	    = std::chrono::steady_clock::now ();
+	  bool bytecode = false;
+	  bool evaluated = false;
+
 	  try
 	    {
-	      condition_result = breakpoint_cond_eval (cond);
+	      condition_result = breakpoint_location_cond_eval (bl, cond,
+								&bytecode);
+	      evaluated = true;
 	    }
 	  catch (const gdb_exception &ex)
 	    {
 	      exception_fprintf (gdb_stderr, ex,
 				 "Error in testing breakpoint condition:\n");
 	    }
+
+	  b->cond_time += std::chrono::steady_clock::now () - start;
+	  b->cond_evaluations++;
+	  if (bytecode)
+	    b->cond_bytecode_evaluations++;
+	  /* A condition that could not be evaluated stops, but was not
+	     true.  */
+	  if (evaluated && condition_result)
+	    b->cond_true_count++;
 	}
       else
 	{
@@ -5273,6 +5370,12 @@ bpstat_check_breakpoint_conditions (bpstat bs, thread_info *thread)
   if (cond && !condition_result)
     {
       bs->stop = 0;
+      bs->cond_false = 1;
+
+      /* A target that is not in non-stop mode has stopped every
+	 thread to report this hit.  */
+      if (!target_is_non_stop_p ())
+	b->cond_false_stop_all_count++;
     }
   else if (b->ignore_count > 0)
     {
@@ -6648,6 +6751,56 @@ maintenance_info_breakpoints (const char *args, int from_tty)
   default_collect_info ();
 }
 
+/* The "maintenance info breakpoint-conditions" command.  */
+
+static void
+maintenance_info_breakpoint_conditions (const char *args, int from_tty)
+{
+  struct breakpoint *b;
+  bool found = false;
+
+  if (args != NULL && *args != '\0')
+    error (_("Invalid argument."));
+
+  ALL_BREAKPOINTS (b)
+    {
+      if (b->cond_string == NULL && b->cond_evaluations == 0)
+	continue;
+
+      if (!found)
+	printf_filtered (_("%-7s %-11s %-11s %-11s %-9s %-12s %-11s %s\n"),
+			 "Num", "Evaluated", "True", "Bytecode", "Compiled",
+			 "Time/eval", "Stop-all", "Condition");
+      found = true;
+
+      int locs = 0, compiled = 0;
+      for (bp_location *bl = b->loc; bl != NULL; bl = bl->next)
+	{
+	  locs++;
+	  if (bl->host_cond_bytecode != NULL)
+	    compiled++;
+	}
+
+      double usecs = 0;
+      if (b->cond_evaluations != 0)
+	usecs = (std::chrono::duration<double, std::micro> (b->cond_time)
+		 .count () / b->cond_evaluations);
+
+      std::string compiled_str = string_printf ("%d/%d", compiled, locs);
+      std::string time_str = string_printf ("%.2fus", usecs);
+      printf_filtered ("%-7d %-11s %-11s %-11s %-9s %-12s %-11s %s\n",
+		       b->number, pulongest (b->cond_evaluations),
+		       pulongest (b->cond_true_count),
+		       pulongest (b->cond_bytecode_evaluations),
+		       compiled_str.c_str (), time_str.c_str (),
+		       pulongest (b->cond_false_stop_all_count),
+		       b->cond_string != NULL ? b->cond_string : "");
+    }
+
+  if (!found)
+    printf_filtered (_("No breakpoint conditions.\n"));
+}
+
 static int
 breakpoint_has_pc (struct breakpoint *b,
 		   struct program_space *pspace,
@@ -8876,6 +9029,7 @@ init_breakpoint_sal (struct breakpoint *b, struct gdbarch *gdbarch,
 				   block_for_pc (loc->address), 0);
 	  if (*arg)
               error (_("Garbage '%s' follows condition"), arg);
+	  update_host_cond_bytecode (loc);
 	}
 
       /* Dynamic printf requires and uses additional arguments on the
@@ -11519,6 +11673,15 @@ bp_locations_compare (const void *ap, const void *bp)
   return (a > b) - (a < b);
 }
 
+/* A less-than comparison of bp_location A and B for std::sort and
+   std::merge, using the same ordering as bp_locations_compare.  */
+
+static bool
+bp_location_is_less_than (const bp_location *a, const bp_location *b)
+{
+  return bp_locations_compare (&a, &b) < 0;
+}
+
 /* Set bp_locations_placed_address_before_address_max and
    bp_locations_shadow_len_after_address_max according to the current
    content of the bp_locations array.  */
@@ -11722,17 +11885,45 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   bp_locations = NULL;
   bp_locations_count = 0;
 
+  /* Rather than sorting all the locations again, mark the locations
+     still owned by a breakpoint with the new generation, and collect
+     those that aren't in the old array yet.  Only these need to be
+     sorted; they are then merged with the locations kept from the old
+     array, which is already sorted.  With thousands of locations,
+     this makes adding, removing or changing a few of them much
+     cheaper.  */
+  unsigned int old_generation = bp_locations_generation;
+  if (++bp_locations_generation == 0)
+    bp_locations_generation = 1;
+
+  std::vector<bp_location *> added;
   ALL_BREAKPOINTS (b)
     for (loc = b->loc; loc; loc = loc->next)
-      bp_locations_count++;
+      {
+	if (loc->global_list_generation != old_generation)
+	  added.push_back (loc);
+	loc->global_list_generation = bp_locations_generation;
+	bp_locations_count++;
+      }
+
+  std::vector<bp_location *> kept;
+  kept.reserve (bp_locations_count - added.size ());
+  for (old_locp = old_locations.get ();
+       old_locp < old_locations.get () + old_locations_count;
+       old_locp++)
+    if ((*old_locp)->global_list_generation == bp_locations_generation)
+      kept.push_back (*old_locp);
+  gdb_assert (kept.size () + added.size () == bp_locations_count);
+
+  /* The sort keys of the kept locations may have been changed in
+     place since the last update; sort them again if so.  */
+  if (!std::is_sorted (kept.begin (), kept.end (), bp_location_is_less_than))
+    std::sort (kept.begin (), kept.end (), bp_location_is_less_than);
+  std::sort (added.begin (), added.end (), bp_location_is_less_than);
 
   bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
-  locp = bp_locations;
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
-  qsort (bp_locations, bp_locations_count, sizeof (*bp_locations),
-	 bp_locations_compare);
+  std::merge (kept.begin (), kept.end (), added.begin (), added.end (),
+	      bp_locations, bp_location_is_less_than);
 
   bp_locations_target_extensions_update ();
 
@@ -11756,7 +11947,8 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
 
       /* Tells if 'old_loc' is found among the new locations.  If
 	 not, we have to free it.  */
-      int found_object = 0;
+      int found_object
+	= old_loc->global_list_generation == bp_locations_generation;
       /* Tells if the location should remain inserted in the target.  */
       int keep_in_target = 0;
       int removed = 0;
@@ -11783,9 +11975,6 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
 	      force_breakpoint_reinsertion (*loc2p);
 	      last_pspace_num = old_loc->pspace->num;
 	    }
-
-	  if (*loc2p == old_loc)
-	    found_object = 1;
 	}
 
       /* We have already handled this address, update it so that we don't
@@ -13527,6 +13716,7 @@ update_breakpoint_locations (struct breakpoint *b,
 	      new_loc->cond = parse_exp_1 (&s, sal.pc,
 					   block_for_pc (sal.pc),
 					   0);
+	      update_host_cond_bytecode (new_loc);
 	    }
 	  catch (const gdb_exception_error &e)
 	    {
@@ -15479,8 +15669,8 @@ breakpoints_relocate (struct objfile *objfile, struct section_offsets *delta)
     }
 
   if (changed)
-    qsort (bp_locations, bp_locations_count, sizeof (*bp_locations),
-	   bp_locations_compare);
+    std::sort (bp_locations, bp_locations + bp_locations_count,
+	       bp_location_is_less_than);
 }
 
 void
@@ -15720,6 +15910,15 @@ Convenience variable \"$bpnum\" contains the number of the last\n\
 breakpoint set."),
 	   &maintenanceinfolist);
 
+  add_cmd ("breakpoint-conditions", class_maintenance,
+	   maintenance_info_breakpoint_conditions, _("\
+Statistics about the evaluation of breakpoint conditions by GDB.\n\
+For each breakpoint with a condition, show how many times GDB evaluated\n\
+the condition, how many times it was true, how many times its bytecode\n\
+was used, how many of its locations have bytecode, the average time\n\
+per evaluation, and how many false hits stopped all threads."),
+	   &maintenanceinfolist);
+
   add_prefix_cmd ("catch", class_breakpoint, catch_command, _("\
 Set catchpoints to catch events."),
 		  &catch_cmdlist, "catch ",
@@ -15959,6 +16158,20 @@ when execution stops."),
 				&breakpoint_set_cmdlist,
 				&breakpoint_show_cmdlist);
 
+  add_setshow_boolean_cmd ("condition-bytecode", class_breakpoint,
+			   &condition_bytecode, _("\
+Set whether GDB evaluates breakpoint conditions as bytecode."), _("\
+Show whether GDB evaluates breakpoint conditions as bytecode."), _("\
+When on, the breakpoint conditions that GDB evaluates itself are compiled\n\
+to agent expressions, when possible, and run by a bytecode interpreter\n\
+instead of being evaluated as expressions each time the breakpoint is hit.\n\
+Conditions that can't be compiled, such as those calling functions, are\n\
+always evaluated as expressions."),
+			   NULL,
+			   show_condition_bytecode,
+			   &breakpoint_set_cmdlist,
+			   &breakpoint_show_cmdlist);
+
   add_setshow_enum_cmd ("condition-evaluation", class_breakpoint,
 			condition_evaluation_enums,
 			&condition_evaluation_mode_1, _("\
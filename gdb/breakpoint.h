@@ -27,6 +27,7 @@
 #include "common/break-common.h"
 #include "probe.h"
 #include "location.h"
+#include <chrono>
 #include <vector>
 #include "common/array-view.h"
 #include "cli/cli-script.h"
@@ -342,6 +343,11 @@ public:
      condition evaluation.  */
   agent_expr_up cond_bytecode;
 
+  /* Conditional expression in agent expression bytecode form, for
+     evaluation by GDB itself.  NULL if the condition can't be
+     compiled, or uses operations only an agent can perform.  */
+  agent_expr_up host_cond_bytecode;
+
   /* Signals that the condition has changed since the last time
      we updated the global location list.  This means the condition
      needs to be sent to the target again.  This is used together
@@ -463,6 +469,12 @@ public:
      it becomes 0 this location is retired.  */
   int events_till_retirement = 0;
 
+  /* The generation of the global location list this location was last
+     found in, or zero if it was never added to it.  Used by
+     update_global_location_list to find the added and removed
+     locations without sorting all of them again.  */
+  unsigned int global_list_generation = 0;
+
   /* Line number which was used to place this location.
 
      Breakpoint placed into a comment keeps it's user specified line number
@@ -761,6 +773,22 @@ struct breakpoint
      you can back up to just before the abort.  */
   int hit_count = 0;
 
+  /* Statistics about the evaluation of the condition by GDB: the
+     number of evaluations, how many were true, how many used the
+     condition's bytecode, and the time they took.  Shown by "maint
+     info breakpoint-conditions".  */
+  ULONGEST cond_evaluations = 0;
+  ULONGEST cond_true_count = 0;
+  ULONGEST cond_bytecode_evaluations = 0;
+  std::chrono::steady_clock::duration cond_time {};
+
+  /* Number of hits whose condition was false but which still stopped
+     every thread: either the target stops all threads to report any
+     event, or GDB had to stop them to step over the breakpoint in
+     line.  Other false hits only stop the thread that hit the
+     breakpoint.  */
+  ULONGEST cond_false_stop_all_count = 0;
+
   /* Is breakpoint's condition not yet parsed because we found no
      location initially so had no context to parse the condition
      in.  */
@@ -904,6 +932,12 @@ extern void bpstat_clear (bpstat *);
    is part of the bpstat is copied as well.  */
 extern bpstat bpstat_copy (bpstat);
 
+/* Record that GDB is about to stop all threads to step a thread over
+   a breakpoint, BS being that thread's stop chain.  Breakpoints whose
+   condition was false in BS have their cond_false_stop_all_count
+   incremented.  */
+extern void bpstat_note_stop_all_threads (bpstat bs);
+
 /* Build the (raw) bpstat chain for the stop information given by ASPACE,
    BP_ADDR, and WS.  Returns the head of the bpstat chain.  */
 
@@ -1148,6 +1182,10 @@ struct bpstats
     /* Nonzero if this breakpoint tells us to stop.  */
     char stop;
 
+    /* Nonzero if GDB evaluated the breakpoint's condition and it was
+       false.  */
+    char cond_false;
+
     /* Tell bpstat_print and print_bp_stop_message how to print stuff
        associated with this element of the bpstat chain.  */
     enum bp_print_how print_it;
@@ -34,6 +34,9 @@
 #include "common/rsp-low.h"
 #include "gdbcmd.h"
 #include "cli/cli-utils.h"
+#include "gdbarch.h"
+#include "observable.h"
+#include "progspace.h"
 
 /* For maintenance commands.  */
 #include "record-btrace.h"
@@ -41,6 +44,7 @@
 #include <inttypes.h>
 #include <ctype.h>
 #include <algorithm>
+#include <unordered_map>
 
 /* Command lists for btrace maintenance commands.  */
 static struct cmd_list_element *maint_btrace_cmdlist;
@@ -694,6 +698,183 @@ ftrace_classify_insn (struct gdbarch *gdbarch, CORE_ADDR pc)
   return iclass;
 }
 
+/* The size and class of an instruction.  */
+
+struct btrace_decoded_insn
+{
+  /* The size of the instruction, or zero if it could not be
+     computed.  */
+  int size;
+
+  enum btrace_insn_class iclass;
+};
+
+/* A per-architecture cache of the decoded instructions of BTS traces.
+   Traces revisit the same code over and over, and decoding an
+   instruction means disassembling it.  The cache is shared by all
+   threads and all trace fetches.  The inferior may change its code
+   while it runs, for instance when it is generated by a JIT, so each
+   entry keeps the bytes of the instruction, and is only used while
+   memory still holds them.  */
+
+struct btrace_insn_cache
+{
+  /* The longest instruction whose bytes an entry can hold; longer
+     instructions are not cached.  */
+  static const int max_insn_size = 16;
+
+  /* A decoded instruction, and the bytes it was decoded from.  */
+  struct entry
+  {
+    btrace_decoded_insn insn;
+    gdb_byte bytes[max_insn_size];
+  };
+
+  /* The key of an instruction: its program space and address.  */
+  struct key
+  {
+    struct program_space *pspace;
+    CORE_ADDR pc;
+
+    bool operator== (const key &other) const
+    {
+      return pspace == other.pspace && pc == other.pc;
+    }
+  };
+
+  struct key_hash
+  {
+    size_t operator() (const key &k) const
+    {
+      return (std::hash<CORE_ADDR> () (k.pc)
+	      ^ std::hash<struct program_space *> () (k.pspace));
+    }
+  };
+
+  /* The value of btrace_insn_cache_generation when INSNS was filled.  */
+  unsigned int generation = 0;
+
+  std::unordered_map<key, entry, key_hash> insns;
+
+  /* Statistics, for "maint info btrace".  */
+  ULONGEST hits = 0;
+  ULONGEST misses = 0;
+};
+
+static struct gdbarch_data *btrace_insn_cache_data;
+
+/* Incremented whenever code may have changed.  This discards the
+   contents of all the caches of decoded instructions.  */
+
+static unsigned int btrace_insn_cache_generation;
+
+static void *
+btrace_insn_cache_init (struct gdbarch *gdbarch)
+{
+  /* Architectures are never freed.  */
+  return new btrace_insn_cache;
+}
+
+/* Return the cache of decoded instructions of GDBARCH.  */
+
+static struct btrace_insn_cache *
+get_btrace_insn_cache (struct gdbarch *gdbarch)
+{
+  struct btrace_insn_cache *cache
+    = (struct btrace_insn_cache *) gdbarch_data (gdbarch,
+						 btrace_insn_cache_data);
+
+  if (cache->generation != btrace_insn_cache_generation)
+    {
+      cache->insns.clear ();
+      cache->generation = btrace_insn_cache_generation;
+    }
+
+  return cache;
+}
+
+/* Discard all the decoded instructions.  */
+
+static void
+btrace_insn_cache_invalidate ()
+{
+  btrace_insn_cache_generation++;
+}
+
+/* The "new_objfile" observer.  */
+
+static void
+btrace_insn_cache_new_objfile (struct objfile *objfile)
+{
+  btrace_insn_cache_invalidate ();
+}
+
+/* The "memory_changed" observer.  */
+
+static void
+btrace_insn_cache_memory_changed (struct inferior *inf, CORE_ADDR addr,
+				  ssize_t len, const bfd_byte *data)
+{
+  btrace_insn_cache_invalidate ();
+}
+
+/* The "inferior_exit" observer.  */
+
+static void
+btrace_insn_cache_inferior_exit (struct inferior *inf)
+{
+  btrace_insn_cache_invalidate ();
+}
+
+/* Return the size and class of the instruction at PC in the current
+   program space, using the cache of GDBARCH.  */
+
+static struct btrace_decoded_insn
+ftrace_decode_insn (struct gdbarch *gdbarch, CORE_ADDR pc)
+{
+  struct btrace_insn_cache *cache = get_btrace_insn_cache (gdbarch);
+  const btrace_insn_cache::key key = { current_program_space, pc };
+  btrace_insn_cache::entry entry;
+
+  /* The code at PC may have been replaced since it was decoded.  */
+  auto it = cache->insns.find (key);
+  if (it != cache->insns.end ()
+      && target_read_code (pc, entry.bytes, it->second.insn.size) == 0
+      && memcmp (entry.bytes, it->second.bytes,
+		 it->second.insn.size) == 0)
+    {
+      cache->hits++;
+      return it->second.insn;
+    }
+
+  cache->misses++;
+
+  struct btrace_decoded_insn insn;
+
+  insn.size = 0;
+  try
+    {
+      insn.size = gdb_insn_length (gdbarch, pc);
+    }
+  catch (const gdb_exception_error &error)
+    {
+    }
+
+  insn.iclass = ftrace_classify_insn (gdbarch, pc);
+
+  /* Don't remember failures; the memory may become readable.  */
+  if (insn.size > 0 && insn.size <= btrace_insn_cache::max_insn_size
+      && target_read_code (pc, entry.bytes, insn.size) == 0)
+    {
+      entry.insn = insn;
+      cache->insns[key] = entry;
+    }
+  else if (it != cache->insns.end ())
+    cache->insns.erase (it);
+
+  return insn;
+}
+
 /* Try to match the back trace at LHS to the back trace at RHS.  Returns the
    number of matching function segments or zero if the back traces do not
    match.  BTINFO is the branch trace information for the current thread.  */
@@ -1079,6 +1260,7 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
 	{
 	  struct btrace_function *bfun;
 	  struct btrace_insn insn;
+	  struct btrace_decoded_insn decoded;
 	  int size;
 
 	  /* We should hit the end of the block.  Warn if we went too far.  */
@@ -1101,18 +1283,12 @@ btrace_compute_ftrace_bts (struct thread_info *tp,
 	  if (blk != 0)
 	    level = std::min (level, bfun->level);
 
-	  size = 0;
-	  try
-	    {
-	      size = gdb_insn_length (gdbarch, pc);
-	    }
-	  catch (const gdb_exception_error &error)
-	    {
-	    }
+	  decoded = ftrace_decode_insn (gdbarch, pc);
+	  size = decoded.size;
 
 	  insn.pc = pc;
 	  insn.size = size;
-	  insn.iclass = ftrace_classify_insn (gdbarch, pc);
+	  insn.iclass = decoded.iclass;
 	  insn.flags = 0;
 
 	  ftrace_update_insns (bfun, insn);
@@ -1999,6 +2175,8 @@ btrace_free_objfile (struct objfile *objfile)
 {
   DEBUG ("free objfile");
 
+  btrace_insn_cache_invalidate ();
+
   for (thread_info *tp : all_non_exited_threads ())
     btrace_clear (tp);
 }
@@ -3442,9 +3620,18 @@ maint_info_btrace_cmd (const char *args, int from_tty)
       break;
 
     case BTRACE_FORMAT_BTS:
-      printf_unfiltered (_("Number of packets: %u.\n"),
-			 VEC_length (btrace_block_s,
-				     btinfo->data.variant.bts.blocks));
+      {
+	struct btrace_insn_cache *cache
+	  = get_btrace_insn_cache (target_gdbarch ());
+
+	printf_unfiltered (_("Number of packets: %u.\n"),
+			   VEC_length (btrace_block_s,
+				       btinfo->data.variant.bts.blocks));
+	printf_unfiltered (_("Instruction cache: %s entries, %s hits, "
+			     "%s misses.\n"),
+			   pulongest (cache->insns.size ()),
+			   pulongest (cache->hits), pulongest (cache->misses));
+      }
       break;
 
 #if defined (HAVE_LIBIPT)
@@ -3483,6 +3670,15 @@ show_maint_btrace_pt_skip_pad  (struct ui_file *file, int from_tty,
 void
 _initialize_btrace (void)
 {
+  btrace_insn_cache_data
+    = gdbarch_data_register_post_init (btrace_insn_cache_init);
+
+  /* Code may change when objfiles are loaded, when memory is written,
+     when the inferior runs or when it exits.  */
+  gdb::observers::new_objfile.attach (btrace_insn_cache_new_objfile);
+  gdb::observers::memory_changed.attach (btrace_insn_cache_memory_changed);
+  gdb::observers::inferior_exit.attach (btrace_insn_cache_inferior_exit);
+
   add_cmd ("btrace", class_maintenance, maint_info_btrace_cmd,
 	   _("Info about branch tracing data."), &maintenanceinfolist);
 
@@ -37,6 +37,10 @@
 #include <sys/stat.h>
 #include "elf/external.h"
 #include "inferior.h"
+#include "common/filestuff.h"
+#include "common/scoped_fd.h"
+#include "common/thread-pool.h"
+#include <unordered_map>
 
 #define BUILD_ID_VERBOSE_NONE 0
 #define BUILD_ID_VERBOSE_FILENAMES 1
@@ -464,13 +468,99 @@ build_id_verify (bfd *abfd, size_t check_len, const bfd_byte *check)
   return retval;
 }
 
+/* Existence checks of the candidate build-id paths.  A lookup probes
+   the same relative path under every debug-file directory, and on a
+   network file system each probe can take milliseconds, so when there
+   are worker threads the first candidates of all the directories are
+   checked at once up front.  Paths that were not probed that way are
+   checked on demand.  */
+
+class build_id_prober
+{
+public:
+
+  build_id_prober () = default;
+  DISABLE_COPY_AND_ASSIGN (build_id_prober);
+
+  /* Check every path in PATHS on the worker threads.  */
+  void probe (const std::vector<std::string> &paths);
+
+  /* Return true if access (PATH, F_OK) succeeds.  */
+  bool accessible (const std::string &path) const;
+
+  /* Return true if lstat (PATH) succeeds.  */
+  bool present (const std::string &path) const;
+
+private:
+
+  struct result
+  {
+    bool accessible;
+    bool present;
+  };
+
+  std::unordered_map<std::string, result> m_results;
+};
+
+void
+build_id_prober::probe (const std::vector<std::string> &paths)
+{
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0
+      || paths.size () < 2)
+    return;
+
+  std::vector<result> results (paths.size ());
+  std::vector<std::future<void>> pending;
+
+  for (size_t i = 0; i < paths.size (); ++i)
+    pending.push_back (gdb::thread_pool::g_thread_pool->post_task
+		       ([&paths, &results, i] ()
+			{
+			  struct stat statbuf;
+
+			  results[i].accessible
+			    = access (paths[i].c_str (), F_OK) == 0;
+			  results[i].present
+			    = lstat (paths[i].c_str (), &statbuf) == 0;
+			}));
+
+  for (std::future<void> &f : pending)
+    f.wait ();
+
+  for (size_t i = 0; i < paths.size (); ++i)
+    m_results.emplace (paths[i], results[i]);
+}
+
+bool
+build_id_prober::accessible (const std::string &path) const
+{
+  auto it = m_results.find (path);
+
+  if (it != m_results.end ())
+    return it->second.accessible;
+  return access (path.c_str (), F_OK) == 0;
+}
+
+bool
+build_id_prober::present (const std::string &path) const
+{
+  auto it = m_results.find (path);
+  struct stat statbuf;
+
+  if (it != m_results.end ())
+    return it->second.present;
+  return lstat (path.c_str (), &statbuf) == 0;
+}
+
 /* Helper for build_id_to_debug_bfd.  LINK is a path to a potential
    build-id-based separate debug file, potentially a symlink to the real file.
-   If the file exists and matches BUILD_ID, return a BFD reference to it.  */
+   If the file exists and matches BUILD_ID, return a BFD reference to it.
+   PROBER answers whether LINK exists.  */
 
 static gdb_bfd_ref_ptr
 build_id_to_debug_bfd_1 (const std::string &link, size_t build_id_len,
-			 const bfd_byte *build_id)
+			 const bfd_byte *build_id,
+			 const build_id_prober &prober)
 {
   if (separate_debug_file_debug)
     {
@@ -480,7 +570,7 @@ build_id_to_debug_bfd_1 (const std::string &link, size_t build_id_len,
 
   /* lrealpath() is expensive even for the usually non-existent files.  */
   gdb::unique_xmalloc_ptr<char> filename;
-  if (access (link.c_str (), F_OK) == 0)
+  if (prober.accessible (link))
     filename.reset (lrealpath (link.c_str ()));
 
   if (filename == NULL)
@@ -550,63 +640,102 @@ link_resolve (const char *symlink, int level)
   return retval;
 }
 
-/* See build-id.h.  */
+/* Return where the file named after BUILD_ID would be in DEBUGDIR.
+   If DEBUGDIR is "/usr/lib/debug" and the build-id is abcdef, this
+   gives "/usr/lib/debug/.build-id/ab/cdef".  */
 
-gdb_bfd_ref_ptr
-build_id_to_debug_bfd (size_t build_id_len, const bfd_byte *build_id,
-		       char **link_return, int add_debug_suffix)
+static std::string
+build_id_link (const char *debugdir, size_t build_id_len,
+	       const bfd_byte *build_id)
+{
+  const gdb_byte *data = build_id;
+  size_t size = build_id_len;
+  std::string link = debugdir;
+
+  link += "/.build-id/";
+
+  if (size > 0)
+    {
+      size--;
+      string_appendf (link, "%02x", (unsigned) *data++);
+    }
+  if (size > 0)
+    link += "/";
+  while (size-- > 0)
+    string_appendf (link, "%02x", (unsigned) *data++);
+
+  return link;
+}
+
+/* Worker for build_id_to_debug_bfd, which caches its results.  Search
+   the debug-file directories for BUILD_ID.  Store in *LINK_RETURN the
+   link that was found, or, if nothing was found, the links that
+   debug_print_missing should report.  */
+
+static gdb_bfd_ref_ptr
+build_id_to_debug_bfd_2 (size_t build_id_len, const bfd_byte *build_id,
+			 std::string *link_return, int add_debug_suffix)
 {
   std::string link, link_all;
   gdb_bfd_ref_ptr abfd;
 
+  /* Don't look under the sysroot if it is the target system
+     ("target:").  It could work in theory, but the lrealpath in
+     build_id_to_debug_bfd_1 only works with local paths.  */
+  bool use_sysroot = strcmp (gdb_sysroot, TARGET_SYSROOT_PREFIX) != 0;
+
   /* Keep backward compatibility so that DEBUG_FILE_DIRECTORY being "" will
      cause "/.build-id/..." lookups.  */
 
   std::vector<gdb::unique_xmalloc_ptr<char>> debugdir_vec
     = dirnames_to_char_ptr_vec (debug_file_directory);
 
+  /* Check the first candidates of every directory concurrently; the
+     loop below then rarely has to touch the file system for a
+     directory that does not have the file.  */
+  build_id_prober prober;
+  {
+    std::vector<std::string> candidates;
+
+    for (const gdb::unique_xmalloc_ptr<char> &debugdir : debugdir_vec)
+      {
+	std::string dir_link = build_id_link (debugdir.get (), build_id_len,
+					      build_id);
+
+	candidates.push_back (dir_link);
+	if (use_sysroot)
+	  {
+	    dir_link = gdb_sysroot + dir_link;
+	    candidates.push_back (dir_link);
+	  }
+	if (add_debug_suffix)
+	  candidates.push_back (dir_link + ".debug");
+      }
+
+    prober.probe (candidates);
+  }
+
   for (const gdb::unique_xmalloc_ptr<char> &debugdir : debugdir_vec)
     {
-      const gdb_byte *data = build_id;
-      size_t size = build_id_len;
       gdb::unique_xmalloc_ptr<char> filename;
       unsigned seqno;
-      struct stat statbuf_trash;
       std::string link0;
 
-      /* Compute where the file named after the build-id would be.
-
-	 If debugdir is "/usr/lib/debug" and the build-id is abcdef, this will
-         give "/usr/lib/debug/.build-id/ab/cdef.debug".  */
-      link = debugdir.get ();
-      link += "/.build-id/";
-
-      if (size > 0)
-	{
-	  size--;
-	  string_appendf (link, "%02x", (unsigned) *data++);
-	}
-      if (size > 0)
-	link += "/";
-      while (size-- > 0)
-	string_appendf (link, "%02x", (unsigned) *data++);
+      link = build_id_link (debugdir.get (), build_id_len, build_id);
 
       gdb_bfd_ref_ptr debug_bfd
-	= build_id_to_debug_bfd_1 (link, build_id_len, build_id);
+	= build_id_to_debug_bfd_1 (link, build_id_len, build_id, prober);
       if (debug_bfd != NULL)
 	return debug_bfd;
 
       /* Try to look under the sysroot as well.  If the sysroot is
          "/the/sysroot", it will give
-         "/the/sysroot/usr/lib/debug/.build-id/ab/cdef.debug".
-
-         Don't do it if the sysroot is the target system ("target:").  It
-         could work in theory, but the lrealpath in build_id_to_debug_bfd_1
-         only works with local paths.  */
-      if (strcmp (gdb_sysroot, TARGET_SYSROOT_PREFIX) != 0)
+         "/the/sysroot/usr/lib/debug/.build-id/ab/cdef.debug".  */
+      if (use_sysroot)
 	{
 	  link = gdb_sysroot + link;
-	  debug_bfd = build_id_to_debug_bfd_1 (link, build_id_len, build_id);
+	  debug_bfd = build_id_to_debug_bfd_1 (link, build_id_len, build_id,
+					       prober);
 	  if (debug_bfd != NULL)
 	    return debug_bfd;
 	}
@@ -636,7 +765,7 @@ build_id_to_debug_bfd (size_t build_id_len, const bfd_byte *build_id,
 	    }
 
 	  /* `access' automatically dereferences LINK.  */
-	  if (lstat (link.c_str (), &statbuf_trash) != 0)
+	  if (!prober.present (link))
 	    {
 	      /* Stop increasing SEQNO.  */
 	      break;
@@ -684,22 +813,417 @@ build_id_to_debug_bfd (size_t build_id_len, const bfd_byte *build_id,
 	}
     }
 
-  if (link_return != NULL)
+  *link_return = abfd != NULL ? link : link_all;
+  return abfd;
+}
+
+/* A remembered result of build_id_to_debug_bfd_2.  */
+
+struct build_id_cache_entry
+{
+  /* The separate debug file that was found, or empty if none was.  */
+  std::string filename;
+
+  /* The link build_id_to_debug_bfd_2 returned.  */
+  std::string link;
+
+  /* For a failed lookup, the build_id_dirs_stamp of the directories
+     that were searched.  */
+  std::string stamp;
+};
+
+/* Results of build-id lookups, both successful and failed, keyed by
+   the hex build-id followed by ".debug" if ADD_DEBUG_SUFFIX was
+   set.  */
+static std::unordered_map<std::string, build_id_cache_entry> build_id_cache;
+
+/* The debug-file-directory and sysroot, separated by a tab, that the
+   entries of BUILD_ID_CACHE were computed with.  */
+static std::string build_id_cache_dirs;
+
+/* True if BUILD_ID_CACHE has been loaded from BUILD_ID_CACHE_FILE.  */
+static bool build_id_cache_loaded;
+
+/* The file "set build-id-cache-file" names, in which lookup results
+   are kept across sessions.  NULL or empty if there is none.  */
+static char *build_id_cache_file;
+
+/* True if a failure to write BUILD_ID_CACHE_FILE has been reported.  */
+static bool build_id_cache_warned;
+
+/* "set build-id-cache-negative": whether failed lookups are
+   remembered.  */
+static int build_id_cache_negative = 1;
+
+/* Rewrite BUILD_ID_CACHE_FILE without its overridden lines once it
+   has more than this many lines and most of them are overridden.  */
+#define BUILD_ID_CACHE_COMPACT_MIN 32
+
+/* Warn, once per cache file, that WHAT failed on BUILD_ID_CACHE_FILE
+   with the error in errno.  */
+
+static void
+build_id_cache_write_error (const char *what)
+{
+  if (build_id_cache_warned)
+    return;
+  build_id_cache_warned = true;
+
+  warning (_("Could not %s build-id cache file \"%s\": %s"),
+	   what, build_id_cache_file, safe_strerror (errno));
+}
+
+/* Append the modification time of PATH to STAMP, or "-" if it does
+   not exist.  Clear *SETTLED if PATH was modified during the current
+   second, as another change in the same second would not show.  */
+
+static void
+build_id_stamp_append (std::string &stamp, const std::string &path,
+		       bool *settled)
+{
+  struct stat st;
+
+  if (!stamp.empty ())
+    stamp += ",";
+
+  if (stat (path.c_str (), &st) != 0)
+    {
+      stamp += "-";
+      return;
+    }
+
+  string_appendf (stamp, "%lld", (long long) st.st_mtime);
+  if (st.st_mtime >= time (NULL))
+    *settled = false;
+}
+
+/* Return a summary of the directories in which a lookup of BUILD_ID
+   can find a file: the modification times of the ".build-id"
+   directory of each debug directory and of the subdirectory the
+   BUILD_ID link would be in.  Installing a separate debug file for
+   BUILD_ID changes the result.  Set *SETTLED to false if the result
+   might not reflect a change that is still in progress.  */
+
+static std::string
+build_id_dirs_stamp (size_t build_id_len, const bfd_byte *build_id,
+		     bool *settled)
+{
+  bool use_sysroot = strcmp (gdb_sysroot, TARGET_SYSROOT_PREFIX) != 0;
+  std::string stamp;
+
+  *settled = true;
+  for (const gdb::unique_xmalloc_ptr<char> &debugdir
+	 : dirnames_to_char_ptr_vec (debug_file_directory))
+    {
+      std::string link = build_id_link (debugdir.get (), build_id_len,
+					build_id);
+      std::string subdir = link.substr (0, link.rfind ('/'));
+      std::string dir = subdir.substr (0, subdir.rfind ('/'));
+
+      build_id_stamp_append (stamp, dir, settled);
+      build_id_stamp_append (stamp, subdir, settled);
+      if (use_sysroot)
+	{
+	  build_id_stamp_append (stamp, gdb_sysroot + dir, settled);
+	  build_id_stamp_append (stamp, gdb_sysroot + subdir, settled);
+	}
+    }
+
+  return stamp;
+}
+
+/* Read one line from FILE into LINE, without its newline.  Return
+   false at end of file.  */
+
+static bool
+build_id_cache_read_line (FILE *file, std::string *line)
+{
+  int c;
+
+  line->clear ();
+  while ((c = getc (file)) != EOF && c != '\n')
+    *line += c;
+
+  return c != EOF || !line->empty ();
+}
+
+/* Replace the contents of BUILD_ID_CACHE_FILE with LINES.  Write a
+   temporary file and rename it, so that concurrent readers see either
+   the old or the new contents.  */
+
+static void
+build_id_cache_rewrite (const std::vector<std::string> &lines)
+{
+  std::string temp = std::string (build_id_cache_file) + ".XXXXXX";
+  scoped_fd fd (gdb_mkostemp_cloexec (&temp[0]));
+
+  if (fd.get () == -1)
+    {
+      build_id_cache_write_error ("compact");
+      return;
+    }
+
+  gdb_file_up file (fdopen (fd.get (), "w"));
+  if (file == NULL)
     {
-      if (abfd != NULL)
+      build_id_cache_write_error ("compact");
+      unlink (temp.c_str ());
+      return;
+    }
+  fd.release ();
+
+  bool ok = true;
+  for (const std::string &line : lines)
+    if (fprintf (file.get (), "%s\n", line.c_str ()) < 0)
+      {
+	ok = false;
+	break;
+      }
+
+  if (fclose (file.release ()) != 0)
+    ok = false;
+
+  if (!ok || rename (temp.c_str (), build_id_cache_file) != 0)
+    {
+      build_id_cache_write_error ("compact");
+      unlink (temp.c_str ());
+    }
+}
+
+/* Make BUILD_ID_CACHE match the current debug-file-directory and
+   sysroot, (re)loading the entries for them from BUILD_ID_CACHE_FILE
+   if they changed.
+
+   Each line of the file is a key, the debug-file-directory, the
+   sysroot, the build_id_dirs_stamp for a failed lookup, the file found
+   (empty for a failed lookup) and the link, separated by tabs.  Later
+   lines override earlier ones; once most lines are overridden, the
+   file is rewritten without them.  */
+
+static void
+build_id_cache_prepare ()
+{
+  std::string dirs = std::string (debug_file_directory) + "\t" + gdb_sysroot;
+
+  if (build_id_cache_loaded && dirs == build_id_cache_dirs)
+    return;
+
+  build_id_cache.clear ();
+  build_id_cache_dirs = dirs;
+  build_id_cache_loaded = true;
+
+  if (build_id_cache_file == NULL || *build_id_cache_file == '\0')
+    return;
+
+  gdb_file_up file = gdb_fopen_cloexec (build_id_cache_file, "r");
+  if (file == NULL)
+    return;
+
+  /* The latest line for each key, debug-file-directory and sysroot, in
+     the order of their first appearance.  */
+  std::vector<std::string> latest;
+  std::unordered_map<std::string, size_t> latest_index;
+  size_t n_lines = 0;
+
+  std::string line;
+  while (build_id_cache_read_line (file.get (), &line))
+    {
+      size_t key_end = line.find ('\t');
+      if (key_end == std::string::npos)
+	continue;
+
+      size_t dirs_end = line.find ('\t', key_end + 1);
+      if (dirs_end != std::string::npos)
+	dirs_end = line.find ('\t', dirs_end + 1);
+      if (dirs_end == std::string::npos)
+	continue;
+
+      n_lines++;
+      auto ins = latest_index.emplace (line.substr (0, dirs_end),
+				       latest.size ());
+      if (ins.second)
+	latest.push_back (line);
+      else
+	latest[ins.first->second] = line;
+
+      if (dirs_end != key_end + 1 + dirs.size ()
+	  || line.compare (key_end + 1, dirs.size (), dirs) != 0)
+	continue;
+
+      size_t filename_start = line.find ('\t', dirs_end + 1);
+      if (filename_start == std::string::npos)
+	continue;
+      filename_start++;
+
+      size_t link_start = line.find ('\t', filename_start);
+      if (link_start == std::string::npos)
+	continue;
+
+      build_id_cache_entry &entry = build_id_cache[line.substr (0, key_end)];
+      entry.stamp = line.substr (dirs_end + 1,
+				 filename_start - 1 - (dirs_end + 1));
+      entry.filename = line.substr (filename_start,
+				    link_start - filename_start);
+      entry.link = line.substr (link_start + 1);
+    }
+
+  file.reset ();
+
+  if (n_lines > BUILD_ID_CACHE_COMPACT_MIN && n_lines > 2 * latest.size ())
+    build_id_cache_rewrite (latest);
+}
+
+/* Remember that looking up KEY gave FILENAME and LINK, in memory and
+   in BUILD_ID_CACHE_FILE if there is one.  STAMP is the
+   build_id_dirs_stamp of a failed lookup.  */
+
+static void
+build_id_cache_store (const std::string &key, const char *filename,
+		      const std::string &link, const std::string &stamp)
+{
+  build_id_cache_entry &entry = build_id_cache[key];
+  entry.filename = filename;
+  entry.link = link;
+  entry.stamp = stamp;
+
+  if (build_id_cache_file == NULL || *build_id_cache_file == '\0')
+    return;
+
+  /* Don't write what could not be read back.  */
+  if (strpbrk (filename, "\t\n") != NULL
+      || link.find_first_of ("\t\n") != std::string::npos)
+    return;
+
+  gdb_file_up file = gdb_fopen_cloexec (build_id_cache_file, "a");
+  if (file == NULL)
+    {
+      build_id_cache_write_error ("open");
+      return;
+    }
+
+  if (fprintf (file.get (), "%s\t%s\t%s\t%s\t%s\n", key.c_str (),
+	       build_id_cache_dirs.c_str (), stamp.c_str (), filename,
+	       link.c_str ()) < 0
+      || fclose (file.release ()) != 0)
+    build_id_cache_write_error ("write");
+}
+
+/* See build-id.h.  */
+
+gdb_bfd_ref_ptr
+build_id_to_debug_bfd (size_t build_id_len, const bfd_byte *build_id,
+		       char **link_return, int add_debug_suffix)
+{
+  std::string key = bin2hex (build_id, build_id_len);
+  if (add_debug_suffix)
+    key += ".debug";
+
+  build_id_cache_prepare ();
+
+  auto it = build_id_cache.find (key);
+  if (it != build_id_cache.end ())
+    {
+      const build_id_cache_entry &entry = it->second;
+      gdb_bfd_ref_ptr abfd;
+
+      if (entry.filename.empty ())
 	{
-	  *link_return = xstrdup (link.c_str ());
-	  return abfd;
+	  bool settled;
+
+	  /* A separate debug file may have been installed since; trust
+	     the entry only if none of the directories changed.  */
+	  if (build_id_cache_negative
+	      && entry.stamp == build_id_dirs_stamp (build_id_len, build_id,
+						     &settled))
+	    {
+	      if (separate_debug_file_debug)
+		printf_unfiltered (_("  Cached: not found\n"));
+
+	      if (link_return != NULL)
+		*link_return = xstrdup (entry.link.c_str ());
+	      return {};
+	    }
 	}
       else
 	{
-	  *link_return = xstrdup (link_all.c_str ());
+	  /* The file may have been replaced since it was found; check it
+	     still has the right build-id before trusting the entry.  */
+	  abfd = gdb_bfd_open (entry.filename.c_str (), gnutarget, -1);
+	  if (abfd != NULL)
+	    {
+	      const struct bfd_build_id *found
+		= build_id_bfd_shdr_get (abfd.get ());
+
+	      if (found != NULL
+		  && found->size == build_id_len
+		  && memcmp (found->data, build_id, build_id_len) == 0)
+		{
+		  if (separate_debug_file_debug)
+		    printf_unfiltered (_("  Cached: %s\n"),
+				       entry.filename.c_str ());
+
+		  if (link_return != NULL)
+		    *link_return = xstrdup (entry.link.c_str ());
+		  return abfd;
+		}
+	    }
 	}
+
+      build_id_cache.erase (it);
     }
 
-  return {};
+  /* Take the stamp before searching, so that a file installed during
+     the search invalidates the result.  */
+  bool settled;
+  std::string stamp = build_id_dirs_stamp (build_id_len, build_id, &settled);
+
+  std::string link;
+  gdb_bfd_ref_ptr abfd = build_id_to_debug_bfd_2 (build_id_len, build_id,
+						  &link, add_debug_suffix);
+
+  if (abfd != NULL)
+    build_id_cache_store (key, bfd_get_filename (abfd.get ()), link, "");
+  else if (build_id_cache_negative && settled)
+    build_id_cache_store (key, "", link, stamp);
+
+  if (link_return != NULL)
+    *link_return = xstrdup (link.c_str ());
+  return abfd;
 }
 
+/* Implement the "set build-id-cache-file" command.  */
+
+static void
+set_build_id_cache_file (const char *args, int from_tty,
+			 struct cmd_list_element *c)
+{
+  build_id_cache_loaded = false;
+  build_id_cache_warned = false;
+}
+
+/* Implement the "show build-id-cache-negative" command.  */
+
+static void
+show_build_id_cache_negative (struct ui_file *file, int from_tty,
+			      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Remembering failed build-id lookups is %s.\n"),
+		    value);
+}
+
+/* Implement the "maint flush-build-id-cache" command.  */
+
+static void
+maintenance_flush_build_id_cache (const char *args, int from_tty)
+{
+  build_id_cache.clear ();
+  build_id_cache_loaded = false;
+
+  if (build_id_cache_file != NULL && *build_id_cache_file != '\0')
+    unlink (build_id_cache_file);
+}
+
+
 char *
 build_id_to_filename (const struct bfd_build_id *build_id, char **link_return)
 {
@@ -1321,5 +1845,35 @@ level 2 also prints the parsing of binaries to find the identificators."),
 			    show_build_id_verbose,
 			    &setlist, &showlist);
 
+  add_setshow_optional_filename_cmd ("build-id-cache-file", class_files,
+				     &build_id_cache_file, _("\
+Set the file in which build-id lookups are remembered."), _("\
+Show the file in which build-id lookups are remembered."), _("\
+The results of looking up separate debug files by build-id, including\n\
+failed lookups, are appended to this file and read back by later sessions\n\
+that use the same debug-file-directory and sysroot.  The file is compacted\n\
+when most of its lines are out of date.  If empty, results are only\n\
+remembered for the current session."),
+				     set_build_id_cache_file,
+				     NULL,
+				     &setlist, &showlist);
+
+  add_setshow_boolean_cmd ("build-id-cache-negative", class_files,
+			   &build_id_cache_negative, _("\
+Set whether failed build-id lookups are remembered."), _("\
+Show whether failed build-id lookups are remembered."), _("\
+When on, a failed lookup of a separate debug file by build-id is not\n\
+repeated until the debug directories it searched change.  When off,\n\
+failed lookups are always repeated."),
+			   NULL,
+			   show_build_id_cache_negative,
+			   &setlist, &showlist);
+
+  add_cmd ("flush-build-id-cache", class_maintenance,
+	   maintenance_flush_build_id_cache,
+	   _("Forget the results of previous build-id lookups.\n\
+This also removes the file named by \"set build-id-cache-file\"."),
+	   &maintenancelist);
+
   gdb::observers::executable_changed.attach (debug_print_executable_changed);
 }
@@ -0,0 +1,142 @@
+/* Thread pool
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "common-defs.h"
+#include "common/thread-pool.h"
+#include <signal.h>
+#if CXX_STD_THREAD
+#include <system_error>
+#endif
+
+namespace gdb
+{
+
+/* The global thread pool.  */
+
+thread_pool *thread_pool::g_thread_pool = new thread_pool ();
+
+thread_pool::~thread_pool ()
+{
+  /* Because this is a singleton, we don't need to clean up.  The
+     threads are detached so that they won't prevent process exit.  */
+}
+
+void
+thread_pool::set_thread_count (size_t num_threads)
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_tasks_mutex);
+
+  /* If the new size is larger, start some new threads.  */
+  if (m_thread_count < num_threads)
+    {
+      /* Worker threads must not handle any of the signals GDB cares
+	 about (SIGINT, SIGCHLD, ...); block everything while they are
+	 created so that they inherit a full mask.  */
+#ifdef HAVE_SIGPROCMASK
+      sigset_t mask, old_mask;
+
+      sigfillset (&mask);
+      sigprocmask (SIG_BLOCK, &mask, &old_mask);
+#endif
+
+      for (size_t i = m_thread_count; i < num_threads; ++i)
+	{
+	  try
+	    {
+	      std::thread thread (&thread_pool::thread_function, this);
+	      thread.detach ();
+	    }
+	  catch (const std::system_error &)
+	    {
+	      /* libstdc++ may not implement std::thread, and will
+		 throw an exception on use.  It seems fine to ignore
+		 this, and any other sort of startup failure here.  */
+	      num_threads = i;
+	      break;
+	    }
+	}
+
+#ifdef HAVE_SIGPROCMASK
+      sigprocmask (SIG_SETMASK, &old_mask, NULL);
+#endif
+    }
+  /* If the new size is smaller, terminate some existing threads.  */
+  if (num_threads < m_thread_count)
+    {
+      for (size_t i = num_threads; i < m_thread_count; ++i)
+	m_tasks.emplace ();
+      m_tasks_cv.notify_all ();
+    }
+
+  m_thread_count = num_threads;
+#else
+  /* No threads available, simply ignore the request.  */
+#endif /* CXX_STD_THREAD */
+}
+
+std::future<void>
+thread_pool::post_task (std::function<void ()> func)
+{
+  std::packaged_task<void ()> t (func);
+  std::future<void> f = t.get_future ();
+
+#if CXX_STD_THREAD
+  if (m_thread_count != 0)
+    {
+      std::lock_guard<std::mutex> guard (m_tasks_mutex);
+      m_tasks.emplace (std::move (t));
+      m_tasks_cv.notify_one ();
+      return f;
+    }
+#endif
+
+  /* Just execute it now.  */
+  t ();
+  return f;
+}
+
+#if CXX_STD_THREAD
+
+void
+thread_pool::thread_function ()
+{
+  while (true)
+    {
+      optional<std::packaged_task<void ()>> t;
+
+      {
+	/* We want to hold the lock while examining the task list, but
+	   not while invoking the task function.  */
+	std::unique_lock<std::mutex> guard (m_tasks_mutex);
+	while (m_tasks.empty ())
+	  m_tasks_cv.wait (guard);
+	t = std::move (m_tasks.front ());
+	m_tasks.pop ();
+      }
+
+      if (!t.has_value ())
+	break;
+      (*t) ();
+    }
+}
+
+#endif /* CXX_STD_THREAD */
+
+} /* namespace gdb */
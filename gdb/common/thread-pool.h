@@ -0,0 +1,98 @@
+/* Thread pool
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_THREAD_POOL_H
+#define COMMON_THREAD_POOL_H
+
+#include <queue>
+#include <functional>
+#include <future>
+#if CXX_STD_THREAD
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#include "common/gdb_optional.h"
+
+namespace gdb
+{
+
+/* A thread pool.
+
+   There is a single global thread pool, see g_thread_pool.  Tasks
+   posted to it must not call into the target, the frontend or any
+   other part of GDB that is not thread-safe; the usual pattern is for
+   the main thread to gather the inputs, post a task that only touches
+   those inputs, and wait for the returned future before using the
+   results.
+
+   When GDB is built without std::thread support, or when the thread
+   count is zero, tasks are run synchronously by post_task.  */
+
+class thread_pool
+{
+public:
+
+  /* The sole global thread pool.  */
+  static thread_pool *g_thread_pool;
+
+  ~thread_pool ();
+  DISABLE_COPY_AND_ASSIGN (thread_pool);
+
+  /* Set the thread count of this thread pool.  By default, no threads
+     are created -- the thread count must be set first.  */
+  void set_thread_count (size_t num_threads);
+
+  /* Return the number of executing threads.  */
+  size_t thread_count () const
+  {
+    return m_thread_count;
+  }
+
+  /* Post a task to the thread pool.  A future is returned, which can
+     be used to wait for the result.  */
+  std::future<void> post_task (std::function<void ()> func);
+
+private:
+
+  thread_pool () = default;
+
+#if CXX_STD_THREAD
+  /* The callback for each worker thread.  */
+  void thread_function ();
+#endif
+
+  /* The current thread count.  */
+  size_t m_thread_count = 0;
+
+#if CXX_STD_THREAD
+  /* The tasks that have not been processed yet.  An empty optional is
+     used to tell a worker thread to exit.  */
+  std::queue<optional<std::packaged_task<void ()>>> m_tasks;
+
+  /* A condition variable and mutex that are used for communication
+     between the main thread and the worker threads.  */
+  std::condition_variable m_tasks_cv;
+  std::mutex m_tasks_mutex;
+#endif
+};
+
+}
+
+#endif /* COMMON_THREAD_POOL_H */
@@ -0,0 +1,749 @@
+/* Compressed core file memory for GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "compressed-core.h"
+#include "common/filestuff.h"
+#include "common/thread-pool.h"
+#include <fcntl.h>
+#include <algorithm>
+#include <zlib.h>
+
+#ifndef O_LARGEFILE
+#define O_LARGEFILE 0
+#endif
+
+/* The magic that starts the trailer, and the current version of the
+   format.  */
+#define COMPRESSED_CORE_MAGIC "GDBZCORE"
+#define COMPRESSED_CORE_VERSION 1
+
+/* The amount of decompressed data the cache of a reader holds.  */
+#define COMPRESSED_CORE_CACHE_SIZE (64 * 1024 * 1024)
+
+/* Blocks are decompressed ahead of time by worker threads, which read
+   the file with pread.  */
+#if CXX_STD_THREAD && defined (HAVE_PREAD)
+#define COMPRESSED_CORE_PREFETCH 1
+#endif
+
+/* Sizes of an index entry and of the trailer, in bytes.  */
+#define COMPRESSED_CORE_ENTRY_SIZE (4 * 8)
+#define COMPRESSED_CORE_TRAILER_SIZE (8 + 3 * 8)
+
+/* Read LEN bytes at OFFSET of the file FD into BUF.  Return false on
+   error or short read.  This may run on worker threads.  */
+
+static bool
+read_at (int fd, gdb_byte *buf, size_t len, ULONGEST offset)
+{
+#ifndef HAVE_PREAD
+  if (lseek (fd, offset, SEEK_SET) == -1)
+    return false;
+#endif
+
+  while (len > 0)
+    {
+#ifdef HAVE_PREAD
+      ssize_t n = pread (fd, buf, len, offset);
+#else
+      ssize_t n = read (fd, buf, len);
+#endif
+
+      if (n == -1 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	return false;
+      buf += n;
+      len -= n;
+      offset += n;
+    }
+
+  return true;
+}
+
+/* Compress DATA into OUTPUT.  OUTPUT is left empty if the data
+   is all zeros.  Return the zlib status.  This runs on worker
+   threads.  */
+
+static int
+compress_chunk (const gdb::byte_vector &data, gdb::byte_vector *output)
+{
+  if (data[0] == 0
+      && memcmp (data.data (), data.data () + 1, data.size () - 1) == 0)
+    return Z_OK;
+
+  uLongf len = compressBound (data.size ());
+  output->resize (len);
+  int status = compress2 (output->data (), &len, data.data (), data.size (),
+			  Z_BEST_SPEED);
+  output->resize (status == Z_OK ? len : 0);
+  return status;
+}
+
+compressed_core_writer::compressed_core_writer (const char *filename)
+  : m_fd (gdb_open_cloexec (filename, O_WRONLY | O_BINARY | O_LARGEFILE, 0))
+{
+  if (m_fd.get () == -1)
+    perror_with_name (filename);
+
+  off_t end = lseek (m_fd.get (), 0, SEEK_END);
+  if (end == -1)
+    perror_with_name (filename);
+  m_offset = end;
+}
+
+compressed_core_writer::~compressed_core_writer ()
+{
+  /* The worker threads may still use the pending chunks.  */
+  for (const auto &chunk : m_pending)
+    chunk->done.wait ();
+}
+
+void
+compressed_core_writer::add_chunk (CORE_ADDR addr, gdb::byte_vector &&data)
+{
+  gdb_assert (!data.empty () && data.size () <= COMPRESSED_CORE_CHUNK_SIZE);
+
+  /* Keep just enough chunks in flight to keep the worker threads
+     busy, which also bounds the memory used.  */
+  while (m_pending.size ()
+	 > gdb::thread_pool::g_thread_pool->thread_count ())
+    write_oldest ();
+
+  std::unique_ptr<pending_chunk> chunk (new pending_chunk);
+  pending_chunk *c = chunk.get ();
+
+  c->addr = addr;
+  c->data = std::move (data);
+  c->done = gdb::thread_pool::g_thread_pool->post_task ([c] ()
+    {
+      c->status = compress_chunk (c->data, &c->output);
+    });
+  m_pending.push_back (std::move (chunk));
+}
+
+void
+compressed_core_writer::write_oldest ()
+{
+  std::unique_ptr<pending_chunk> chunk = std::move (m_pending.front ());
+  m_pending.pop_front ();
+
+  chunk->done.get ();
+  if (chunk->status != Z_OK)
+    error (_("Failed to compress core file contents: %s"),
+	   zError (chunk->status));
+
+  compressed_core_chunk entry;
+  entry.addr = chunk->addr;
+  entry.size = chunk->data.size ();
+  entry.offset = m_offset;
+  entry.compressed_size = chunk->output.size ();
+
+  write_bytes (chunk->output.data (), chunk->output.size ());
+  m_index.push_back (entry);
+}
+
+void
+compressed_core_writer::write_bytes (const gdb_byte *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = write (m_fd.get (), buf, len);
+
+      if (n == -1 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	{
+	  if (n == 0)
+	    errno = ENOSPC;
+	  perror_with_name (_("Failed to write core file contents"));
+	}
+      buf += n;
+      len -= n;
+      m_offset += n;
+    }
+}
+
+void
+compressed_core_writer::finish ()
+{
+  while (!m_pending.empty ())
+    write_oldest ();
+
+  ULONGEST index_offset = m_offset;
+  gdb::byte_vector index (m_index.size () * COMPRESSED_CORE_ENTRY_SIZE);
+  gdb_byte *p = index.data ();
+
+  for (const compressed_core_chunk &entry : m_index)
+    {
+      store_unsigned_integer (p, 8, BFD_ENDIAN_LITTLE, entry.addr);
+      store_unsigned_integer (p + 8, 8, BFD_ENDIAN_LITTLE, entry.size);
+      store_unsigned_integer (p + 16, 8, BFD_ENDIAN_LITTLE, entry.offset);
+      store_unsigned_integer (p + 24, 8, BFD_ENDIAN_LITTLE,
+			      entry.compressed_size);
+      p += COMPRESSED_CORE_ENTRY_SIZE;
+    }
+  write_bytes (index.data (), index.size ());
+
+  gdb_byte trailer[COMPRESSED_CORE_TRAILER_SIZE];
+
+  memcpy (trailer, COMPRESSED_CORE_MAGIC, 8);
+  store_unsigned_integer (trailer + 8, 8, BFD_ENDIAN_LITTLE,
+			  COMPRESSED_CORE_VERSION);
+  store_unsigned_integer (trailer + 16, 8, BFD_ENDIAN_LITTLE, index_offset);
+  store_unsigned_integer (trailer + 24, 8, BFD_ENDIAN_LITTLE,
+			  m_index.size ());
+  write_bytes (trailer, sizeof (trailer));
+}
+
+compressed_core_reader::compressed_core_reader
+  (scoped_fd &&fd, std::vector<compressed_core_chunk> &&index)
+  : m_fd (std::move (fd)),
+    m_index (std::move (index))
+{
+}
+
+compressed_core_reader::~compressed_core_reader ()
+{
+#if CXX_STD_THREAD
+  /* The prefetcher may still use this reader.  */
+  if (m_prefetch.valid ())
+    m_prefetch.wait ();
+#endif
+}
+
+/* Warn that the compressed memory index of the core file FILENAME is
+   corrupt.  */
+
+static void
+warn_corrupt_index (const char *filename)
+{
+  warning (_("Core file \"%s\" has a corrupt compressed memory index."),
+	   filename);
+}
+
+std::unique_ptr<compressed_core_reader>
+compressed_core_reader::open (const char *filename)
+{
+  scoped_fd fd (gdb_open_cloexec (filename,
+				  O_RDONLY | O_BINARY | O_LARGEFILE, 0));
+  if (fd.get () == -1)
+    return NULL;
+
+  gdb_byte trailer[COMPRESSED_CORE_TRAILER_SIZE];
+  off_t end = lseek (fd.get (), 0, SEEK_END);
+
+  if (end < (off_t) sizeof (trailer)
+      || !read_at (fd.get (), trailer, sizeof (trailer),
+		   end - sizeof (trailer))
+      || memcmp (trailer, COMPRESSED_CORE_MAGIC, 8) != 0)
+    return NULL;
+
+  ULONGEST version
+    = extract_unsigned_integer (trailer + 8, 8, BFD_ENDIAN_LITTLE);
+  ULONGEST index_offset
+    = extract_unsigned_integer (trailer + 16, 8, BFD_ENDIAN_LITTLE);
+  ULONGEST count
+    = extract_unsigned_integer (trailer + 24, 8, BFD_ENDIAN_LITTLE);
+  ULONGEST index_end = end - sizeof (trailer);
+
+  if (version != COMPRESSED_CORE_VERSION)
+    {
+      warning (_("Core file \"%s\" has compressed memory in an unsupported "
+		 "format (version %s)."), filename, pulongest (version));
+      return NULL;
+    }
+
+  if (index_offset > index_end
+      || count > index_end / COMPRESSED_CORE_ENTRY_SIZE
+      || index_end - index_offset != count * COMPRESSED_CORE_ENTRY_SIZE)
+    {
+      warn_corrupt_index (filename);
+      return NULL;
+    }
+
+  gdb::byte_vector data (index_end - index_offset);
+  if (!read_at (fd.get (), data.data (), data.size (), index_offset))
+    {
+      warn_corrupt_index (filename);
+      return NULL;
+    }
+
+  std::vector<compressed_core_chunk> index (count);
+  const gdb_byte *p = data.data ();
+
+  for (ULONGEST i = 0; i < count; i++, p += COMPRESSED_CORE_ENTRY_SIZE)
+    {
+      compressed_core_chunk &entry = index[i];
+
+      entry.addr = extract_unsigned_integer (p, 8, BFD_ENDIAN_LITTLE);
+      entry.size = extract_unsigned_integer (p + 8, 8, BFD_ENDIAN_LITTLE);
+      entry.offset = extract_unsigned_integer (p + 16, 8, BFD_ENDIAN_LITTLE);
+      entry.compressed_size
+	= extract_unsigned_integer (p + 24, 8, BFD_ENDIAN_LITTLE);
+
+      if (entry.size == 0
+	  || entry.size > COMPRESSED_CORE_CHUNK_SIZE
+	  || entry.offset > index_offset
+	  || entry.compressed_size > index_offset - entry.offset
+	  || (i > 0 && entry.addr - index[i - 1].addr < index[i - 1].size))
+	{
+	  warn_corrupt_index (filename);
+	  return NULL;
+	}
+    }
+
+  return std::unique_ptr<compressed_core_reader>
+    (new compressed_core_reader (std::move (fd), std::move (index)));
+}
+
+/* Parse the gzip member header at BUF, of LEN bytes.  Return the total
+   size of the member if it is a BGZF block, and 0 otherwise.  */
+
+static ULONGEST
+bgzf_block_size (const gdb_byte *buf, size_t len)
+{
+  /* Check the magic, the deflate method and the FEXTRA flag.  */
+  if (len < 12
+      || buf[0] != 0x1f || buf[1] != 0x8b || buf[2] != 8
+      || (buf[3] & 4) == 0)
+    return 0;
+
+  size_t xlen = buf[10] | (buf[11] << 8);
+  const gdb_byte *p = buf + 12;
+  const gdb_byte *end = p + std::min (xlen, len - 12);
+
+  /* Look for the "BC" subfield, which holds the block size minus
+     one.  */
+  while (end - p >= 4)
+    {
+      size_t slen = p[2] | (p[3] << 8);
+
+      if (p[0] == 'B' && p[1] == 'C' && slen == 2 && end - p >= 6)
+	return (p[4] | (p[5] << 8)) + 1;
+      p += 4 + slen;
+    }
+
+  return 0;
+}
+
+/* Add to INDEX the BGZF blocks of the file FD, of FILE_SIZE bytes,
+   starting with the block at COFFSET, which holds the data at UOFFSET
+   of the decompressed file.  Return false if a block is corrupt.  */
+
+static bool
+bgzf_scan_blocks (int fd, ULONGEST file_size, ULONGEST coffset,
+		  ULONGEST uoffset, std::vector<compressed_core_chunk> *index)
+{
+  while (coffset < file_size)
+    {
+      gdb_byte header[64];
+      gdb_byte trailer[4];
+      size_t len = std::min ((ULONGEST) sizeof (header), file_size - coffset);
+
+      if (!read_at (fd, header, len, coffset))
+	return false;
+
+      /* A block is at least a header and the CRC32 and ISIZE
+	 words.  */
+      ULONGEST bsize = bgzf_block_size (header, len);
+      if (bsize < 18 + 8 || bsize > file_size - coffset
+	  || !read_at (fd, trailer, sizeof (trailer), coffset + bsize - 4))
+	return false;
+
+      ULONGEST isize = extract_unsigned_integer (trailer, 4,
+						 BFD_ENDIAN_LITTLE);
+      if (isize > 65536)
+	return false;
+
+      /* Skip empty blocks, such as the end-of-file marker.  */
+      if (isize != 0)
+	index->push_back ({uoffset, isize, coffset, bsize});
+
+      coffset += bsize;
+      uoffset += isize;
+    }
+
+  return true;
+}
+
+/* Read the bgzip index FILENAME.gzi, if there is one, into INDEX, for
+   the BGZF file FILENAME of FILE_SIZE bytes.  Set *COFFSET and
+   *UOFFSET to the start of the last block it describes, from which
+   the rest of the blocks must be scanned.  */
+
+static void
+bgzf_read_gzi (const char *filename, ULONGEST file_size,
+	       std::vector<compressed_core_chunk> *index,
+	       ULONGEST *coffset, ULONGEST *uoffset)
+{
+  std::string gzi_name = std::string (filename) + ".gzi";
+  scoped_fd gzi (gdb_open_cloexec (gzi_name.c_str (),
+				   O_RDONLY | O_BINARY | O_LARGEFILE, 0));
+  if (gzi.get () == -1)
+    return;
+
+  gdb_byte buf[16];
+  if (!read_at (gzi.get (), buf, 8, 0))
+    return;
+
+  /* The .gzi file lists the offsets of the start of every block but
+     the first, as (compressed, decompressed) pairs.  */
+  ULONGEST count = extract_unsigned_integer (buf, 8, BFD_ENDIAN_LITTLE);
+  if (count > file_size / (18 + 8))
+    return;
+
+  gdb::byte_vector data (count * 16);
+  if (!read_at (gzi.get (), data.data (), data.size (), 8))
+    return;
+
+  std::vector<compressed_core_chunk> blocks;
+  ULONGEST c = 0, u = 0;
+
+  for (ULONGEST i = 0; i < count; i++)
+    {
+      ULONGEST next_c = extract_unsigned_integer (&data[i * 16], 8,
+						  BFD_ENDIAN_LITTLE);
+      ULONGEST next_u = extract_unsigned_integer (&data[i * 16 + 8], 8,
+						  BFD_ENDIAN_LITTLE);
+
+      if (next_c <= c || next_c >= file_size || next_u < u
+	  || next_u - u > 65536)
+	{
+	  warning (_("Ignoring corrupt BGZF index \"%s\"."), gzi_name.c_str ());
+	  return;
+	}
+
+      if (next_u != u)
+	blocks.push_back ({u, next_u - u, c, next_c - c});
+      c = next_c;
+      u = next_u;
+    }
+
+  *index = std::move (blocks);
+  *coffset = c;
+  *uoffset = u;
+}
+
+std::unique_ptr<compressed_core_reader>
+compressed_core_reader::open_bgzf (const char *filename)
+{
+  scoped_fd fd (gdb_open_cloexec (filename,
+				  O_RDONLY | O_BINARY | O_LARGEFILE, 0));
+  if (fd.get () == -1)
+    return NULL;
+
+  gdb_byte header[64];
+  off_t file_size = lseek (fd.get (), 0, SEEK_END);
+  if (file_size < 2)
+    return NULL;
+
+  size_t len = std::min ((off_t) sizeof (header), file_size);
+  if (!read_at (fd.get (), header, len, 0)
+      || header[0] != 0x1f || header[1] != 0x8b)
+    return NULL;
+
+  if (bgzf_block_size (header, len) == 0)
+    error (_("\"%s\" is compressed with gzip, but not in blocks, so it "
+	     "can't be read without decompressing it first.  Compress it "
+	     "with bgzip instead."), filename);
+
+  std::vector<compressed_core_chunk> index;
+  ULONGEST coffset = 0, uoffset = 0;
+
+  bgzf_read_gzi (filename, file_size, &index, &coffset, &uoffset);
+  if (!bgzf_scan_blocks (fd.get (), file_size, coffset, uoffset, &index))
+    error (_("\"%s\" has a corrupt BGZF block."), filename);
+
+  return std::unique_ptr<compressed_core_reader>
+    (new compressed_core_reader (std::move (fd), std::move (index)));
+}
+
+ULONGEST
+compressed_core_reader::memory_size () const
+{
+  ULONGEST total = 0;
+
+  for (const compressed_core_chunk &entry : m_index)
+    total += entry.size;
+  return total;
+}
+
+/* Decompress the zlib or gzip stream at IN, of IN_LEN bytes, into the
+   OUT_LEN bytes at OUT.  Return false on error, or if the stream does
+   not decompress to exactly OUT_LEN bytes.  */
+
+static bool
+inflate_block (const gdb_byte *in, size_t in_len, gdb_byte *out,
+	       size_t out_len)
+{
+  z_stream zs;
+
+  memset (&zs, 0, sizeof (zs));
+  /* Detect the zlib or gzip header automatically.  */
+  if (inflateInit2 (&zs, 15 + 32) != Z_OK)
+    return false;
+
+  zs.next_in = (Bytef *) in;
+  zs.avail_in = in_len;
+  zs.next_out = out;
+  zs.avail_out = out_len;
+
+  int status = inflate (&zs, Z_FINISH);
+  bool ok = status == Z_STREAM_END && zs.total_out == out_len;
+
+  inflateEnd (&zs);
+  return ok;
+}
+
+compressed_core_reader::block_contents
+compressed_core_reader::decompress (size_t i) const
+{
+  const compressed_core_chunk &entry = m_index[i];
+  std::shared_ptr<gdb::byte_vector> contents
+    (new gdb::byte_vector (entry.size));
+
+  if (entry.compressed_size == 0)
+    memset (contents->data (), 0, entry.size);
+  else
+    {
+      gdb::byte_vector input (entry.compressed_size);
+
+      if (!read_at (m_fd.get (), input.data (), input.size (), entry.offset)
+	  || !inflate_block (input.data (), input.size (), contents->data (),
+			     entry.size))
+	return NULL;
+    }
+
+  return contents;
+}
+
+compressed_core_reader::block_contents
+compressed_core_reader::lookup (size_t i)
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_cache_mutex);
+#endif
+
+  auto it = m_cached.find (i);
+  if (it == m_cached.end ())
+    return NULL;
+
+  /* Make it the most recently used block.  */
+  m_lru.splice (m_lru.begin (), m_lru, it->second);
+  return it->second->second;
+}
+
+void
+compressed_core_reader::insert (size_t i, block_contents contents)
+{
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (m_cache_mutex);
+#endif
+
+  if (m_cached.find (i) != m_cached.end ())
+    return;
+
+  m_lru.emplace_front (i, contents);
+  m_cached[i] = m_lru.begin ();
+  m_cached_bytes += contents->size ();
+
+  /* Readers of the evicted blocks keep their own reference to
+     them.  */
+  while (m_cached_bytes > COMPRESSED_CORE_CACHE_SIZE && m_lru.size () > 1)
+    {
+      m_cached_bytes -= m_lru.back ().second->size ();
+      m_cached.erase (m_lru.back ().first);
+      m_lru.pop_back ();
+    }
+}
+
+void
+compressed_core_reader::prefetch (size_t i)
+{
+#if COMPRESSED_CORE_PREFETCH
+  if (i >= m_index.size ()
+      || gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return;
+
+  /* Don't wait for the previous prefetch; reading is sequential
+     enough that skipping one block now and then is fine.  */
+  if (m_prefetch.valid ()
+      && (m_prefetch.wait_for (std::chrono::seconds (0))
+	  != std::future_status::ready))
+    return;
+
+  {
+    std::lock_guard<std::mutex> guard (m_cache_mutex);
+
+    if (m_cached.find (i) != m_cached.end ())
+      return;
+  }
+
+  m_prefetch_chunk = i;
+  m_prefetch = gdb::thread_pool::g_thread_pool->post_task ([this, i] ()
+    {
+      block_contents contents = decompress (i);
+
+      if (contents != NULL)
+	insert (i, contents);
+    });
+#endif
+}
+
+compressed_core_reader::block_contents
+compressed_core_reader::chunk_contents (size_t i)
+{
+  block_contents contents = lookup (i);
+
+#if CXX_STD_THREAD
+  /* If the block is being prefetched, wait for it rather than
+     decompressing it twice.  */
+  if (contents == NULL && i == m_prefetch_chunk && m_prefetch.valid ())
+    {
+      m_prefetch.wait ();
+      contents = lookup (i);
+    }
+#endif
+
+  if (contents == NULL)
+    {
+      contents = decompress (i);
+      if (contents == NULL)
+	return NULL;
+      insert (i, contents);
+    }
+
+  prefetch (i + 1);
+  return contents;
+}
+
+enum target_xfer_status
+compressed_core_reader::xfer (gdb_byte *readbuf, ULONGEST offset,
+			      ULONGEST len, ULONGEST *xfered_len)
+{
+  auto it = std::upper_bound (m_index.begin (), m_index.end (), offset,
+			      [] (ULONGEST addr,
+				  const compressed_core_chunk &entry)
+			      {
+				return addr < entry.addr;
+			      });
+  if (it == m_index.begin ())
+    return TARGET_XFER_EOF;
+  --it;
+  if (offset - it->addr >= it->size)
+    return TARGET_XFER_EOF;
+
+  block_contents contents = chunk_contents (it - m_index.begin ());
+  if (contents == NULL)
+    return TARGET_XFER_E_IO;
+
+  ULONGEST skip = offset - it->addr;
+  ULONGEST n = std::min (len, it->size - skip);
+
+  memcpy (readbuf, contents->data () + skip, n);
+  *xfered_len = n;
+  return TARGET_XFER_OK;
+}
+
+/* bfd_openr_iovec OPEN_P implementation for gdb_bfd_open_bgzf.
+   OPEN_CLOSURE is the 'compressed_core_reader *', which the stream
+   takes over.  */
+
+static void *
+bgzf_open (struct bfd *nbfd, void *open_closure)
+{
+  return open_closure;
+}
+
+/* bfd_openr_iovec PREAD_P implementation for gdb_bfd_open_bgzf.  */
+
+static file_ptr
+bgzf_pread (struct bfd *nbfd, void *stream, void *buf, file_ptr nbytes,
+	    file_ptr offset)
+{
+  compressed_core_reader *reader = (compressed_core_reader *) stream;
+  file_ptr res = 0;
+
+  while (nbytes > 0)
+    {
+      ULONGEST xfered;
+      enum target_xfer_status status
+	= reader->xfer ((gdb_byte *) buf + res, offset + res, nbytes, &xfered);
+
+      if (status == TARGET_XFER_E_IO)
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  return -1;
+	}
+      if (status != TARGET_XFER_OK)
+	break;
+
+      res += xfered;
+      nbytes -= xfered;
+    }
+
+  return res;
+}
+
+/* bfd_openr_iovec CLOSE_P implementation for gdb_bfd_open_bgzf.  */
+
+static int
+bgzf_close (struct bfd *nbfd, void *stream)
+{
+  delete (compressed_core_reader *) stream;
+
+  /* Zero means success.  */
+  return 0;
+}
+
+/* bfd_openr_iovec STAT_P implementation for gdb_bfd_open_bgzf.  */
+
+static int
+bgzf_stat (struct bfd *abfd, void *stream, struct stat *sb)
+{
+  compressed_core_reader *reader = (compressed_core_reader *) stream;
+
+  memset (sb, 0, sizeof (struct stat));
+  sb->st_size = reader->memory_size ();
+  return 0;
+}
+
+/* See compressed-core.h.  */
+
+gdb_bfd_ref_ptr
+gdb_bfd_open_bgzf (const char *filename, const char *target)
+{
+  std::unique_ptr<compressed_core_reader> reader
+    = compressed_core_reader::open_bgzf (filename);
+  if (reader == NULL)
+    return NULL;
+
+  /* bgzf_open can't fail, so the BFD owns the reader unless creating
+     it failed before opening the stream.  */
+  compressed_core_reader *stream = reader.release ();
+  gdb_bfd_ref_ptr abfd = gdb_bfd_openr_iovec (filename, target, bgzf_open,
+					      stream, bgzf_pread, bgzf_close,
+					      bgzf_stat);
+  if (abfd == NULL)
+    delete stream;
+
+  return abfd;
+}
@@ -0,0 +1,227 @@
+/* Compressed core file memory for GDB, the GNU debugger.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMPRESSED_CORE_H
+#define COMPRESSED_CORE_H
+
+#include "target.h"
+#include "common/byte-vector.h"
+#include "common/scoped_fd.h"
+#include "gdb_bfd.h"
+#include <deque>
+#include <future>
+#include <list>
+#include <unordered_map>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
+/* A compressed core file is an ordinary core file written by BFD,
+   whose memory segments have no contents in the file (their p_filesz
+   is zero), followed by the compressed contents of those segments:
+
+     chunk data
+     index: COUNT entries of four little-endian 64-bit words,
+	    (address, size, file offset, compressed size)
+     trailer: the 8-byte magic "GDBZCORE", then three little-endian
+	      64-bit words, (version, file offset of the index, COUNT)
+
+   Each chunk holds at most COMPRESSED_CORE_CHUNK_SIZE bytes of
+   memory, compressed with zlib.  A compressed size of zero means the
+   chunk is all zeros.  The index is sorted by address, so any byte of
+   memory can be read by decompressing a single chunk.  Tools that
+   don't know about the trailer see a valid core file whose memory
+   segments are not dumped.  */
+
+#define COMPRESSED_CORE_CHUNK_SIZE (1024 * 1024)
+
+/* An entry of the chunk index.  */
+
+struct compressed_core_chunk
+{
+  /* The data the chunk holds: its memory address, or its offset in
+     the decompressed file.  */
+  CORE_ADDR addr;
+  ULONGEST size;
+
+  /* Where its compressed contents are in the file.  */
+  ULONGEST offset;
+  ULONGEST compressed_size;
+};
+
+/* Append compressed memory contents to a core file.  */
+
+class compressed_core_writer
+{
+public:
+
+  /* Start appending to the core file FILENAME, which must be
+     complete.  Throws an error if it cannot be opened.  */
+  explicit compressed_core_writer (const char *filename);
+
+  ~compressed_core_writer ();
+
+  DISABLE_COPY_AND_ASSIGN (compressed_core_writer);
+
+  /* Add DATA, the contents of the memory at ADDR.  DATA must be at
+     most COMPRESSED_CORE_CHUNK_SIZE bytes long.  Chunks are compressed
+     on worker threads when there are any, and written in order.  */
+  void add_chunk (CORE_ADDR addr, gdb::byte_vector &&data);
+
+  /* Write the remaining chunks, the index and the trailer.  */
+  void finish ();
+
+private:
+
+  /* A chunk being compressed.  */
+  struct pending_chunk
+  {
+    CORE_ADDR addr;
+    gdb::byte_vector data;
+
+    /* The compressed data, and the zlib status of the compression.  */
+    gdb::byte_vector output;
+    int status = 0;
+
+    /* Set when the chunk has been compressed.  */
+    std::future<void> done;
+  };
+
+  /* Wait for the oldest pending chunk to be compressed and write
+     it.  */
+  void write_oldest ();
+
+  /* Append LEN bytes at BUF to the file.  */
+  void write_bytes (const gdb_byte *buf, size_t len);
+
+  scoped_fd m_fd;
+
+  /* The current size of the file.  */
+  ULONGEST m_offset = 0;
+
+  /* The chunks being compressed, oldest first.  */
+  std::deque<std::unique_ptr<pending_chunk>> m_pending;
+
+  /* The chunks written so far.  */
+  std::vector<compressed_core_chunk> m_index;
+};
+
+/* Random access to data made of independently compressed blocks,
+   either the memory of a compressed core file, or a whole core file
+   compressed with BGZF (the blocked gzip format of bgzip).  Blocks
+   are decompressed on demand, kept in a cache, and the block after
+   the last one read is decompressed ahead of time by a worker thread
+   when there is one.  */
+
+class compressed_core_reader
+{
+public:
+
+  /* Return a reader for the compressed memory of the core file
+     FILENAME, or NULL if it has none.  Offsets are memory
+     addresses.  */
+  static std::unique_ptr<compressed_core_reader> open (const char *filename);
+
+  /* Return a reader for the file FILENAME if it is compressed with
+     BGZF, or NULL if it is not compressed with gzip.  Offsets are
+     offsets in the decompressed file.  The block index is read from
+     FILENAME.gzi if it exists, and built by reading the block headers
+     otherwise.  Throws an error if the file is compressed with gzip
+     but not in blocks, since it could not be read at random.  */
+  static std::unique_ptr<compressed_core_reader>
+    open_bgzf (const char *filename);
+
+  ~compressed_core_reader ();
+
+  DISABLE_COPY_AND_ASSIGN (compressed_core_reader);
+
+  /* Read data at OFFSET into READBUF, as for the xfer_partial target
+     method.  Return TARGET_XFER_EOF if there is no data at
+     OFFSET.  */
+  enum target_xfer_status xfer (gdb_byte *readbuf, ULONGEST offset,
+				ULONGEST len, ULONGEST *xfered_len);
+
+  /* Return the number of blocks and the total size of the data they
+     hold.  */
+  size_t chunk_count () const
+  {
+    return m_index.size ();
+  }
+  ULONGEST memory_size () const;
+
+private:
+
+  compressed_core_reader (scoped_fd &&fd,
+			  std::vector<compressed_core_chunk> &&index);
+
+  /* The decompressed contents of a block.  */
+  typedef std::shared_ptr<const gdb::byte_vector> block_contents;
+
+  /* Return the contents of block I, decompressing it if it is not in
+     the cache, or NULL on error.  */
+  block_contents chunk_contents (size_t i);
+
+  /* Decompress block I.  Return NULL on error.  This may run on a
+     worker thread.  */
+  block_contents decompress (size_t i) const;
+
+  /* Return block I from the cache, or NULL if it is not cached.  */
+  block_contents lookup (size_t i);
+
+  /* Add CONTENTS, the contents of block I, to the cache, evicting the
+     least recently used blocks if needed.  */
+  void insert (size_t i, block_contents contents);
+
+  /* Start decompressing block I in the background, unless it is
+     cached or a worker thread is already busy with another block.  */
+  void prefetch (size_t i);
+
+  scoped_fd m_fd;
+
+  /* The block index, sorted by offset.  */
+  std::vector<compressed_core_chunk> m_index;
+
+  /* The cache of decompressed blocks, most recently used first, and
+     the position of each block in it.  */
+  std::list<std::pair<size_t, block_contents>> m_lru;
+  std::unordered_map<size_t,
+		     std::list<std::pair<size_t,
+					 block_contents>>::iterator> m_cached;
+  ULONGEST m_cached_bytes = 0;
+
+#if CXX_STD_THREAD
+  /* Protects the cache, which the prefetcher fills.  */
+  std::mutex m_cache_mutex;
+
+  /* The block being prefetched, and the completion of its
+     decompression.  */
+  size_t m_prefetch_chunk = (size_t) -1;
+  std::future<void> m_prefetch;
+#endif
+};
+
+/* If the file FILENAME is compressed with BGZF, return a BFD that
+   reads its decompressed contents at random, with TARGET as for
+   gdb_bfd_open.  Return NULL if FILENAME is not compressed with
+   gzip.  */
+
+extern gdb_bfd_ref_ptr gdb_bfd_open_bgzf (const char *filename,
+					  const char *target);
+
+#endif /* COMPRESSED_CORE_H */
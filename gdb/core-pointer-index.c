@@ -0,0 +1,425 @@
+/* Index of the pointers held in core file memory, for GDB.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "core-pointer-index.h"
+#include "common/byte-vector.h"
+#include "common/filestuff.h"
+#include "common/gdb_unlinker.h"
+#include "common/pathstuff.h"
+#include "common/scope-exit.h"
+#include "common/scoped_fd.h"
+#include "common/thread-pool.h"
+#include "gdbcore.h"
+#include <algorithm>
+#include <deque>
+#include <sys/stat.h>
+
+/* The magic at the start of a saved index.  */
+
+static const char pointer_index_magic[8]
+  = { 'G', 'D', 'B', 'P', 'T', 'R', 'X', '1' };
+
+/* The size of the header of a saved index.  */
+
+#define POINTER_INDEX_HEADER_SIZE (sizeof (pointer_index_magic) + 4 * 8)
+
+/* The size of the blocks of memory scanned by worker threads.  */
+
+#define POINTER_INDEX_CHUNK_SIZE (1024 * 1024)
+
+/* Whether values of BYTE_ORDER must be swapped to be read on the
+   host.  */
+
+static bool
+needs_swap (enum bfd_endian byte_order)
+{
+#ifdef WORDS_BIGENDIAN
+  return byte_order != BFD_ENDIAN_BIG;
+#else
+  return byte_order == BFD_ENDIAN_BIG;
+#endif
+}
+
+/* Return the unsigned value of SIZE bytes in BYTE_ORDER at P.  SWAP
+   is needs_swap (BYTE_ORDER).  Unlike extract_unsigned_integer, this
+   is fast for the usual sizes, and may be called on worker
+   threads.  */
+
+static uint64_t
+load_pointer (const gdb_byte *p, int size, enum bfd_endian byte_order,
+	      bool swap)
+{
+  switch (size)
+    {
+    case 8:
+      {
+	uint64_t v;
+
+	memcpy (&v, p, sizeof (v));
+	if (swap)
+	  v = (((v & 0xff) << 56) | ((v & 0xff00) << 40)
+	       | ((v & 0xff0000) << 24) | ((v & 0xff000000) << 8)
+	       | ((v >> 8) & 0xff000000) | ((v >> 24) & 0xff0000)
+	       | ((v >> 40) & 0xff00) | (v >> 56));
+	return v;
+      }
+    case 4:
+      {
+	uint32_t v;
+
+	memcpy (&v, p, sizeof (v));
+	if (swap)
+	  v = (((v & 0xff) << 24) | ((v & 0xff00) << 8)
+	       | ((v >> 8) & 0xff00) | (v >> 24));
+	return v;
+      }
+    default:
+      {
+	uint64_t v = 0;
+
+	for (int i = 0; i < size; ++i)
+	  v = (v << 8) | p[byte_order == BFD_ENDIAN_BIG ? i : size - 1 - i];
+	return v;
+      }
+    }
+}
+
+/* See core-pointer-index.h.  */
+
+std::unique_ptr<core_pointer_index>
+core_pointer_index::build
+  (std::vector<range> mapped, const std::vector<range> &scanned,
+   int ptr_size, enum bfd_endian byte_order,
+   gdb::function_view<bool (CORE_ADDR, gdb_byte *, size_t)> read)
+{
+  gdb_assert (ptr_size > 0 && ptr_size <= 8);
+
+  /* Sort and merge the mapped ranges, so that a value can be looked
+     up with a binary search.  */
+  std::sort (mapped.begin (), mapped.end (),
+	     [] (const range &a, const range &b)
+	     {
+	       return a.start < b.start;
+	     });
+  std::vector<range> merged;
+  for (const range &r : mapped)
+    {
+      if (r.start >= r.end)
+	continue;
+      if (!merged.empty () && r.start <= merged.back ().end)
+	merged.back ().end = std::max (merged.back ().end, r.end);
+      else
+	merged.push_back (r);
+    }
+
+  /* Split the scanned memory in chunks.  */
+  std::vector<range> chunks;
+  for (const range &r : scanned)
+    for (CORE_ADDR addr = r.start; addr < r.end;)
+      {
+	CORE_ADDR end = (r.end - addr > POINTER_INDEX_CHUNK_SIZE
+			 ? addr + POINTER_INDEX_CHUNK_SIZE : r.end);
+
+	chunks.push_back ({ addr, end });
+	addr = end;
+      }
+
+  /* The entries of each chunk, sorted.  */
+  std::vector<std::vector<entry>> runs (chunks.size ());
+  const bool swap = needs_swap (byte_order);
+
+  /* Each chunk is scanned by a worker thread while the next ones are
+     read; bound the number of chunks in flight.  */
+  const size_t max_pending
+    = 2 * (gdb::thread_pool::g_thread_pool->thread_count () + 1);
+  std::deque<std::future<void>> pending;
+  /* The merged runs of each pass; declared here so that they outlive
+     the tasks still pending if one of them throws.  */
+  std::vector<std::vector<entry>> merged_runs;
+  auto wait_pending = make_scope_exit ([&] ()
+    {
+      /* A future whose result was taken, rethrowing, is no longer
+	 valid.  */
+      for (auto &f : pending)
+	if (f.valid ())
+	  f.wait ();
+    });
+
+  for (size_t i = 0; i < chunks.size (); ++i)
+    {
+      QUIT;
+
+      CORE_ADDR addr = chunks[i].start;
+      std::shared_ptr<gdb::byte_vector> buf
+	(new gdb::byte_vector (chunks[i].end - addr));
+
+      if (!read (addr, buf->data (), buf->size ()))
+	continue;
+
+      while (pending.size () >= max_pending)
+	{
+	  pending.front ().get ();
+	  pending.pop_front ();
+	}
+
+      std::vector<entry> *run = &runs[i];
+      pending.push_back (gdb::thread_pool::g_thread_pool->post_task
+			 ([=, &merged] ()
+	{
+	  if (merged.empty ())
+	    return;
+
+	  const CORE_ADDR lo = merged.front ().start;
+	  const CORE_ADDR hi = merged.back ().end;
+	  const gdb_byte *data = buf->data ();
+	  size_t len = buf->size ();
+
+	  for (size_t off = (ptr_size - addr % ptr_size) % ptr_size;
+	       off + ptr_size <= len;
+	       off += ptr_size)
+	    {
+	      uint64_t value = load_pointer (data + off, ptr_size,
+					     byte_order, swap);
+
+	      if (value < lo || value >= hi)
+		continue;
+
+	      auto it = std::upper_bound (merged.begin (), merged.end (),
+					  value,
+					  [] (uint64_t v, const range &r)
+					  {
+					    return v < r.start;
+					  });
+	      if (value < (--it)->end)
+		run->push_back ({ value, addr + off });
+	    }
+
+	  std::sort (run->begin (), run->end ());
+	}));
+    }
+
+  for (auto &f : pending)
+    f.get ();
+  pending.clear ();
+
+  /* Merge the sorted runs two by two on worker threads.  */
+  runs.erase (std::remove_if (runs.begin (), runs.end (),
+			      [] (const std::vector<entry> &run)
+			      {
+				return run.empty ();
+			      }),
+	      runs.end ());
+  while (runs.size () > 1)
+    {
+      merged_runs.clear ();
+      merged_runs.resize ((runs.size () + 1) / 2);
+
+      for (size_t i = 0; i < merged_runs.size (); ++i)
+	pending.push_back (gdb::thread_pool::g_thread_pool->post_task
+			   ([&runs, &merged_runs, i] ()
+	  {
+	    std::vector<entry> &out = merged_runs[i];
+
+	    if (2 * i + 1 == runs.size ())
+	      out = std::move (runs[2 * i]);
+	    else
+	      {
+		const std::vector<entry> &a = runs[2 * i];
+		const std::vector<entry> &b = runs[2 * i + 1];
+
+		out.resize (a.size () + b.size ());
+		std::merge (a.begin (), a.end (), b.begin (), b.end (),
+			    out.begin ());
+	      }
+	  }));
+
+      for (auto &f : pending)
+	f.get ();
+      pending.clear ();
+      runs = std::move (merged_runs);
+    }
+
+  std::unique_ptr<core_pointer_index> index (new core_pointer_index ());
+  index->m_ptr_size = ptr_size;
+  if (!runs.empty ())
+    index->m_storage = std::move (runs[0]);
+  index->m_entries = index->m_storage.data ();
+  index->m_count = index->m_storage.size ();
+  return index;
+}
+
+/* See core-pointer-index.h.  */
+
+std::unique_ptr<core_pointer_index>
+core_pointer_index::read (const char *filename, const char *core_filename,
+			  int ptr_size)
+{
+  struct stat core_st, st;
+
+  if (stat (core_filename, &core_st) < 0 || stat (filename, &st) < 0)
+    return NULL;
+
+  gdb_file_up file = gdb_fopen_cloexec (filename, FOPEN_RB);
+  if (file == NULL)
+    return NULL;
+
+  gdb_byte header[POINTER_INDEX_HEADER_SIZE];
+  if (fread (header, sizeof (header), 1, file.get ()) != 1
+      || memcmp (header, pointer_index_magic,
+		 sizeof (pointer_index_magic)) != 0)
+    error (_("\"%s\" is not a pointer index."), filename);
+
+  const gdb_byte *p = header + sizeof (pointer_index_magic);
+  ULONGEST core_size = extract_unsigned_integer (p, 8, BFD_ENDIAN_LITTLE);
+  ULONGEST core_mtime = extract_unsigned_integer (p + 8, 8,
+						  BFD_ENDIAN_LITTLE);
+  ULONGEST file_ptr_size = extract_unsigned_integer (p + 16, 8,
+						     BFD_ENDIAN_LITTLE);
+  ULONGEST count = extract_unsigned_integer (p + 24, 8, BFD_ENDIAN_LITTLE);
+
+  /* An index made for an older core file with the same name is not
+     an error; it will be replaced.  */
+  if (core_size != (ULONGEST) core_st.st_size
+      || core_mtime != (ULONGEST) core_st.st_mtime
+      || file_ptr_size != (ULONGEST) ptr_size)
+    return NULL;
+
+  if (count > ((ULONGEST) st.st_size - POINTER_INDEX_HEADER_SIZE) / 16
+      || (ULONGEST) st.st_size != POINTER_INDEX_HEADER_SIZE + count * 16)
+    error (_("The pointer index \"%s\" is truncated."), filename);
+
+  std::unique_ptr<core_pointer_index> index (new core_pointer_index ());
+  index->m_ptr_size = ptr_size;
+  index->m_count = count;
+
+#if HAVE_SYS_MMAN_H && !defined (WORDS_BIGENDIAN)
+  /* The entries are in host order; use them in place.  */
+  index->m_mapping.reset (nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+			  fileno (file.get ()), 0);
+  if (index->m_mapping.get () == MAP_FAILED)
+    perror_with_name (("mmap"));
+  index->m_entries
+    = (const entry *) ((const gdb_byte *) index->m_mapping.get ()
+		       + POINTER_INDEX_HEADER_SIZE);
+#else
+  index->m_storage.resize (count);
+  gdb::byte_vector buf (16 * 4096);
+  for (size_t i = 0; i < count;)
+    {
+      size_t n = std::min ((size_t) count - i, buf.size () / 16);
+
+      if (fread (buf.data (), 16, n, file.get ()) != n)
+	error (_("Could not read the pointer index \"%s\"."), filename);
+      for (size_t j = 0; j < n; ++j, ++i)
+	{
+	  entry &e = index->m_storage[i];
+
+	  e.value = extract_unsigned_integer (&buf[16 * j], 8,
+					      BFD_ENDIAN_LITTLE);
+	  e.addr = extract_unsigned_integer (&buf[16 * j + 8], 8,
+					     BFD_ENDIAN_LITTLE);
+	}
+    }
+  index->m_entries = index->m_storage.data ();
+#endif
+
+  return index;
+}
+
+/* See core-pointer-index.h.  */
+
+void
+core_pointer_index::save (const char *filename,
+			  const char *core_filename) const
+{
+  struct stat st;
+  if (stat (core_filename, &st) < 0)
+    perror_with_name (core_filename);
+
+  gdb::char_vector filename_temp = make_temp_filename (filename);
+
+  /* Order matters here; we want FILE to be closed before
+     FILENAME_TEMP is unlinked, because on MS-Windows one cannot
+     delete a file that is still open.  */
+  gdb::optional<gdb::unlinker> unlink_file;
+  scoped_fd out_file_fd (gdb_mkostemp_cloexec (filename_temp.data (),
+					       O_BINARY));
+  if (out_file_fd.get () == -1)
+    perror_with_name (("mkstemp"));
+
+  gdb_file_up out_file = out_file_fd.to_file ("wb");
+  if (out_file == nullptr)
+    error (_("Can't open `%s' for writing"), filename_temp.data ());
+
+  unlink_file.emplace (filename_temp.data ());
+
+  gdb::byte_vector buf (POINTER_INDEX_HEADER_SIZE);
+  memcpy (buf.data (), pointer_index_magic, sizeof (pointer_index_magic));
+  gdb_byte *p = buf.data () + sizeof (pointer_index_magic);
+  store_unsigned_integer (p, 8, BFD_ENDIAN_LITTLE, st.st_size);
+  store_unsigned_integer (p + 8, 8, BFD_ENDIAN_LITTLE, st.st_mtime);
+  store_unsigned_integer (p + 16, 8, BFD_ENDIAN_LITTLE, m_ptr_size);
+  store_unsigned_integer (p + 24, 8, BFD_ENDIAN_LITTLE, m_count);
+  if (fwrite (buf.data (), buf.size (), 1, out_file.get ()) != 1)
+    error (_("couldn't write pointer index to \"%s\""), filename);
+
+  buf.resize (16 * 4096);
+  for (size_t i = 0; i < m_count;)
+    {
+      size_t n = std::min (m_count - i, buf.size () / 16);
+
+      for (size_t j = 0; j < n; ++j, ++i)
+	{
+	  store_unsigned_integer (&buf[16 * j], 8, BFD_ENDIAN_LITTLE,
+				  m_entries[i].value);
+	  store_unsigned_integer (&buf[16 * j + 8], 8, BFD_ENDIAN_LITTLE,
+				  m_entries[i].addr);
+	}
+      if (fwrite (buf.data (), 16, n, out_file.get ()) != n)
+	error (_("couldn't write pointer index to \"%s\""), filename);
+    }
+
+  if (fflush (out_file.get ()) != 0)
+    error (_("couldn't write pointer index to \"%s\""), filename);
+
+  /* We want to keep the file.  */
+  unlink_file->keep ();
+
+  /* Close and move the file in place.  */
+  out_file.reset ();
+  if (rename (filename_temp.data (), filename) != 0)
+    perror_with_name (("rename"));
+}
+
+/* See core-pointer-index.h.  */
+
+std::vector<CORE_ADDR>
+core_pointer_index::referrers (CORE_ADDR addr, ULONGEST len) const
+{
+  std::vector<CORE_ADDR> result;
+  const entry *end = m_entries + m_count;
+  const entry *it = std::lower_bound (m_entries, end, entry { addr, 0 });
+
+  for (; it != end && it->value - addr < len; ++it)
+    result.push_back (it->addr);
+
+  std::sort (result.begin (), result.end ());
+  return result;
+}
@@ -0,0 +1,115 @@
+/* Index of the pointers held in core file memory, for GDB.
+
+   Copyright (C) 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef CORE_POINTER_INDEX_H
+#define CORE_POINTER_INDEX_H
+
+#include "common/function-view.h"
+#include "common/scoped_mmap.h"
+
+/* A pointer index records, for each aligned pointer-sized value of
+   the memory of a core file that points into that memory, the
+   addresses that hold it.  It answers "what points to this object"
+   without scanning all of memory.
+
+   An index can be saved next to its core file, with the suffix
+   POINTER_INDEX_SUFFIX:
+
+     header: the 8-byte magic "GDBPTRX1", then four little-endian
+	     64-bit words, (size and modification time of the core
+	     file, pointer size, COUNT)
+     entries: COUNT pairs of little-endian 64-bit words,
+	      (pointer value, address holding it), sorted.  */
+
+#define POINTER_INDEX_SUFFIX ".ptrindex"
+
+class core_pointer_index
+{
+public:
+
+  /* A range of memory, [START, END).  */
+  struct range
+  {
+    CORE_ADDR start;
+    CORE_ADDR end;
+  };
+
+  /* Index the pointers of PTR_SIZE bytes in BYTE_ORDER held at
+     aligned addresses of the memory in SCANNED, keeping those that
+     point into MAPPED.  READ (ADDR, BUF, LEN) reads memory, and
+     returns false if it cannot; such memory is skipped.  Memory is
+     read on the calling thread and scanned on worker threads.  */
+  static std::unique_ptr<core_pointer_index> build
+    (std::vector<range> mapped, const std::vector<range> &scanned,
+     int ptr_size, enum bfd_endian byte_order,
+     gdb::function_view<bool (CORE_ADDR, gdb_byte *, size_t)> read);
+
+  /* Read the index saved in FILENAME for the core file CORE_FILENAME,
+     whose pointers are PTR_SIZE bytes.  Return NULL if there is no
+     such file, or if it was made for another version of the core
+     file.  Throws an error if the file is corrupt.  */
+  static std::unique_ptr<core_pointer_index> read
+    (const char *filename, const char *core_filename, int ptr_size);
+
+  DISABLE_COPY_AND_ASSIGN (core_pointer_index);
+
+  /* Save the index to FILENAME, for the core file CORE_FILENAME.
+     Throws an error on failure.  */
+  void save (const char *filename, const char *core_filename) const;
+
+  /* Return the addresses that hold pointers into [ADDR, ADDR + LEN),
+     sorted.  */
+  std::vector<CORE_ADDR> referrers (CORE_ADDR addr, ULONGEST len) const;
+
+  /* Return the number of pointers in the index.  */
+  size_t size () const
+  {
+    return m_count;
+  }
+
+private:
+
+  /* An entry of the index.  */
+  struct entry
+  {
+    uint64_t value;
+    uint64_t addr;
+
+    bool operator< (const entry &other) const
+    {
+      return (value < other.value
+	      || (value == other.value && addr < other.addr));
+    }
+  };
+
+  core_pointer_index () = default;
+
+  int m_ptr_size = 0;
+
+  /* The sorted entries, which are either in M_STORAGE or in
+     M_MAPPING.  */
+  const entry *m_entries = NULL;
+  size_t m_count = 0;
+  std::vector<entry> m_storage;
+#if HAVE_SYS_MMAN_H
+  scoped_mmap m_mapping;
+#endif
+};
+
+#endif /* CORE_POINTER_INDEX_H */
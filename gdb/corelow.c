@@ -46,7 +46,10 @@
 #include "auxv.h"
 #include "elf/common.h"
 #include "gdbcmd.h"
+#include "value.h"
 #include "build-id.h"
+#include "compressed-core.h"
+#include "core-pointer-index.h"
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -116,6 +119,14 @@ public:
 				  const char *human_name,
 				  bool required);
 
+  /* Return the pointer index of the core file, reading it from the
+     file saved next to the core file, or building it, on first
+     use.  */
+  const core_pointer_index &pointer_index ();
+
+  /* Save the pointer index next to the core file.  */
+  void save_pointer_index ();
+
 private: /* per-core data */
 
   /* The core's section table.  Note that these target sections are
@@ -133,6 +144,14 @@ private: /* per-core data */
   /* FIXME: kettenis/20031023: Eventually this field should
      disappear.  */
   struct gdbarch *m_core_gdbarch = NULL;
+
+  /* The reader of the compressed memory of the core file, if it has
+     any (see compressed-core.h).  */
+  std::unique_ptr<compressed_core_reader> m_compressed;
+
+  /* The index of the pointers in the memory of the core file, or NULL
+     if it was not needed yet.  */
+  std::unique_ptr<core_pointer_index> m_pointer_index;
 };
 
 core_target::core_target ()
@@ -148,6 +167,7 @@ core_target::core_target ()
 			   &m_core_section_table.sections_end))
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
+  m_compressed = compressed_core_reader::open (bfd_get_filename (core_bfd));
 }
 
 core_target::~core_target ()
@@ -427,15 +447,24 @@ core_target_open (const char *arg, int from_tty)
     flags |= O_RDWR;
   else
     flags |= O_RDONLY;
-  scratch_chan = gdb_open_cloexec (filename.get (), flags, 0);
-  if (scratch_chan < 0)
-    perror_with_name (filename.get ());
 
-  gdb_bfd_ref_ptr temp_bfd (gdb_bfd_fopen (filename.get (), gnutarget,
-					   write_files ? FOPEN_RUB : FOPEN_RB,
-					   scratch_chan));
+  /* A core file compressed with bgzip is read in place.  */
+  gdb_bfd_ref_ptr temp_bfd;
+  if (!write_files)
+    temp_bfd = gdb_bfd_open_bgzf (filename.get (), gnutarget);
+
   if (temp_bfd == NULL)
-    perror_with_name (filename.get ());
+    {
+      scratch_chan = gdb_open_cloexec (filename.get (), flags, 0);
+      if (scratch_chan < 0)
+	perror_with_name (filename.get ());
+
+      temp_bfd = gdb_bfd_fopen (filename.get (), gnutarget,
+				write_files ? FOPEN_RUB : FOPEN_RB,
+				scratch_chan);
+      if (temp_bfd == NULL)
+	perror_with_name (filename.get ());
+    }
 
   if (!bfd_check_format (temp_bfd.get (), bfd_core)
       && !gdb_check_format (temp_bfd.get ()))
@@ -760,6 +789,11 @@ void
 core_target::files_info ()
 {
   print_section_info (&m_core_section_table, core_bfd);
+
+  if (m_compressed != NULL)
+    printf_filtered (_("\tCompressed memory: %s bytes in %s chunks.\n"),
+		     pulongest (m_compressed->memory_size ()),
+		     pulongest (m_compressed->chunk_count ()));
 }
 
 struct spuid_list
@@ -800,6 +834,14 @@ core_target::xfer_partial (enum target_object object, const char *annex,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (m_compressed != NULL && readbuf != NULL)
+	{
+	  enum target_xfer_status status
+	    = m_compressed->xfer (readbuf, offset, len, xfered_len);
+
+	  if (status != TARGET_XFER_EOF)
+	    return status;
+	}
       return (section_table_xfer_memory_partial
 	      (readbuf, writebuf,
 	       offset, len, xfered_len,
@@ -1095,6 +1137,149 @@ core_target::has_registers ()
   return (core_bfd != NULL);
 }
 
+/* Return the name of the file holding the pointer index of the
+   current core file.  */
+
+static std::string
+pointer_index_filename ()
+{
+  return std::string (bfd_get_filename (core_bfd)) + POINTER_INDEX_SUFFIX;
+}
+
+const core_pointer_index &
+core_target::pointer_index ()
+{
+  if (m_pointer_index != NULL)
+    return *m_pointer_index;
+
+  int ptr_size = gdbarch_ptr_bit (m_core_gdbarch) / TARGET_CHAR_BIT;
+  std::string filename = pointer_index_filename ();
+
+  /* A corrupt saved index is only a cache gone bad; build a new
+     one.  */
+  try
+    {
+      m_pointer_index = core_pointer_index::read (filename.c_str (),
+						  bfd_get_filename (core_bfd),
+						  ptr_size);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      warning (_("%s  Rebuilding the pointer index."), except.what ());
+    }
+  if (m_pointer_index != NULL)
+    return *m_pointer_index;
+
+  /* Pointers may point anywhere in the core file memory, but only the
+     memory dumped in the file can hold them.  */
+  std::vector<core_pointer_index::range> mapped, scanned;
+  for (target_section *p = m_core_section_table.sections;
+       p < m_core_section_table.sections_end;
+       p++)
+    {
+      mapped.push_back ({ p->addr, p->endaddr });
+      if (m_compressed != NULL
+	  || (bfd_get_section_flags (p->the_bfd_section->owner,
+				     p->the_bfd_section)
+	      & SEC_HAS_CONTENTS) != 0)
+	scanned.push_back ({ p->addr, p->endaddr });
+    }
+
+  m_pointer_index = core_pointer_index::build
+    (std::move (mapped), scanned, ptr_size,
+     gdbarch_byte_order (m_core_gdbarch),
+     [this] (CORE_ADDR addr, gdb_byte *buf, size_t len)
+     {
+       return (target_read (this, TARGET_OBJECT_MEMORY, NULL, buf,
+			    addr, len) == (LONGEST) len);
+     });
+  return *m_pointer_index;
+}
+
+void
+core_target::save_pointer_index ()
+{
+  std::string filename = pointer_index_filename ();
+
+  pointer_index ().save (filename.c_str (), bfd_get_filename (core_bfd));
+}
+
+/* Return the current core target.  Throws an error if there is
+   none.  */
+
+static core_target *
+get_current_core_target ()
+{
+  core_target *targ
+    = dynamic_cast<core_target *> (find_target_at (process_stratum));
+
+  if (targ == NULL)
+    error (_("No core file now."));
+  return targ;
+}
+
+/* See gdbcore.h.  */
+
+std::vector<CORE_ADDR>
+core_file_referrers (CORE_ADDR addr, ULONGEST len)
+{
+  return get_current_core_target ()->pointer_index ().referrers (addr, len);
+}
+
+/* The "info referrers" command.  */
+
+static void
+info_referrers_command (const char *args, int from_tty)
+{
+  if (args == NULL || *args == '\0')
+    error_no_arg (_("address"));
+
+  struct gdbarch *gdbarch = get_current_arch ();
+  CORE_ADDR addr;
+  ULONGEST len = 1;
+
+  const char *s = args;
+  addr = value_as_address (parse_to_comma_and_eval (&s));
+  if (*s == ',')
+    {
+      ++s;
+      len = value_as_long (parse_to_comma_and_eval (&s));
+      if (len == 0)
+	error (_("Empty range."));
+    }
+  s = skip_spaces (s);
+  if (*s != '\0')
+    error (_("Junk at end of arguments."));
+
+  std::vector<CORE_ADDR> referrers = core_file_referrers (addr, len);
+
+  for (CORE_ADDR referrer : referrers)
+    {
+      QUIT;
+      print_address (gdbarch, referrer, gdb_stdout);
+      printf_filtered ("\n");
+    }
+
+  if (referrers.empty ())
+    printf_filtered (_("No references found.\n"));
+  else if (referrers.size () == 1)
+    printf_filtered (_("1 reference found.\n"));
+  else
+    printf_filtered (_("%s references found.\n"),
+		     pulongest (referrers.size ()));
+}
+
+/* The "save pointer-index" command.  */
+
+static void
+save_pointer_index_command (const char *args, int from_tty)
+{
+  if (args != NULL && *args != '\0')
+    error (_("Junk at end of arguments."));
+
+  get_current_core_target ()->save_pointer_index ();
+}
+
 /* Implement the to_info_proc method.  */
 
 bool
@@ -1121,4 +1306,19 @@ Set whether CORE-FILE loads the build-id associated files automatically."), _("\
 Show whether CORE-FILE loads the build-id associated files automatically."),
 			   NULL, NULL, NULL,
 			   &setlist, &showlist);
+
+  add_info ("referrers", info_referrers_command, _("\
+Print the addresses of the core file memory pointing to an object.\n\
+Usage: info referrers ADDRESS [, LENGTH]\n\
+List the pointer-aligned words of the core file memory whose value is in\n\
+[ADDRESS, ADDRESS + LENGTH).  LENGTH defaults to 1.\n\
+The first use builds an index of all the pointers of the core file, unless\n\
+one was saved with \"save pointer-index\"."));
+
+  add_cmd ("pointer-index", class_files, save_pointer_index_command, _("\
+Save the pointer index of the core file.\n\
+Usage: save pointer-index\n\
+The index is written next to the core file, with the suffix .ptrindex,\n\
+and is used by \"info referrers\" when the same core file is loaded again."),
+	   &save_cmdlist);
 }
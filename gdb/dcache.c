@@ -24,6 +24,7 @@
 #include "target-dcache.h"
 #include "inferior.h"
 #include "splay-tree.h"
+#include "common/byte-vector.h"
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -457,6 +458,65 @@ dcache_init (void)
 }
 
 
+/* Fill the lines of DCACHE that a read of LEN bytes at MEMADDR needs
+   and that are not cached yet with a single read_memory_ranges request
+   to OPS, reading consecutive missing lines as one range.  The lines
+   this does not fill are left to dcache_read_line.  */
+
+static void
+dcache_read_lines (struct target_ops *ops, DCACHE *dcache,
+		   CORE_ADDR memaddr, ULONGEST len)
+{
+  CORE_ADDR line_size = dcache->line_size;
+  ULONGEST count = (XFORM (dcache, memaddr) + len + line_size - 1) / line_size;
+  std::vector<mem_range> ranges;
+  unsigned n_lines = 0;
+
+  /* Leave room for the lines that are already cached.  */
+  for (ULONGEST i = 0; i < count && n_lines < dcache_size / 2; i++)
+    {
+      CORE_ADDR addr = MASK (dcache, memaddr) + i * line_size;
+      struct mem_region *region = lookup_mem_region (addr);
+
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) addr) != NULL
+	  || region->attrib.mode == MEM_WO
+	  || (region->hi != 0 && addr + line_size > region->hi))
+	continue;
+
+      if (!ranges.empty ()
+	  && ranges.back ().start + ranges.back ().length == addr)
+	ranges.back ().length += line_size;
+      else
+	ranges.emplace_back (addr, line_size);
+      n_lines++;
+    }
+
+  /* dcache_read_line handles a single line just as well.  */
+  if (n_lines < 2)
+    return;
+
+  gdb::byte_vector data (n_lines * line_size);
+  std::vector<ULONGEST> xfered;
+
+  if (!ops->read_memory_ranges (ranges, data.data (), &xfered))
+    return;
+
+  /* The contents of the ranges follow each other in DATA.  Only keep
+     the lines that were read completely.  */
+  const gdb_byte *p = data.data ();
+  for (size_t i = 0; i < xfered.size (); i++)
+    {
+      for (ULONGEST done = 0; done + line_size <= xfered[i]; done += line_size)
+	{
+	  struct dcache_block *db
+	    = dcache_alloc (dcache, ranges[i].start + done);
+
+	  memcpy (db->data, p + done, line_size);
+	}
+      p += xfered[i];
+    }
+}
+
 /* Read LEN bytes from dcache memory at MEMADDR, transferring to
    debugger address MYADDR.  If the data is presently cached, this
    fills the cache.  Arguments/return are like the target_xfer_partial
@@ -478,6 +538,9 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->ptid = inferior_ptid;
     }
 
+  /* Read the missing lines in one request if the target can.  */
+  dcache_read_lines (ops, dcache, memaddr, len);
+
   for (i = 0; i < len; i++)
     {
       if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
@@ -27,10 +27,18 @@
 #include "common/pathstuff.h"
 #include "dwarf-index-write.h"
 #include "dwarf2read.h"
+#include "minsyms.h"
 #include "objfiles.h"
 #include "common/selftest.h"
+#include "common/filestuff.h"
+#include "common/gdb_unlinker.h"
+#include "common/scoped_fd.h"
+#include "common/thread-pool.h"
+#include <algorithm>
 #include <string>
 #include <stdlib.h>
+#include <dirent.h>
+#include <utime.h>
 
 /* When set to 1, show debug messages about the index cache.  */
 static int debug_index_cache = 0;
@@ -38,6 +46,16 @@ static int debug_index_cache = 0;
 /* The index cache directory, used for "set/show index-cache directory".  */
 static char *index_cache_directory = NULL;
 
+/* The suffix of the files holding minimal symbols.  */
+#define MINSYMS_SUFFIX ".gdb-minsyms"
+
+/* The suffix of the files holding decompressed section contents.  */
+#define SECTION_SUFFIX ".gdb-section"
+
+/* The maximum size of the index cache in megabytes, or -1 if it is
+   unlimited, used for "set/show index-cache max-size".  */
+static int index_cache_max_size = -1;
+
 /* See dwarf-index.cache.h.  */
 index_cache global_index_cache;
 
@@ -108,7 +126,9 @@ index_cache::store (struct dwarf2_per_objfile *dwarf2_per_objfile)
       return;
     }
 
-  std::string build_id_str = build_id_to_string (build_id);
+  /* Account for the earlier stores first, so that the debug messages
+     come in order.  */
+  reap_stores (false);
 
   try
     {
@@ -124,10 +144,12 @@ index_cache::store (struct dwarf2_per_objfile *dwarf2_per_objfile)
         printf_unfiltered ("index cache: writing index cache for objfile %s\n",
 			 objfile_name (obj));
 
-      /* Write the index itself to the directory, using the build id as the
-         filename.  */
-      write_psymtabs_to_index (dwarf2_per_objfile, m_dir.c_str (),
-			       build_id_str.c_str (), dw_index_kind::GDB_INDEX);
+      /* Build the index now, since the objfile may go away, but write
+	 it in the background, using the build id as the filename.  */
+      gdb::byte_vector contents = build_gdb_index (dwarf2_per_objfile);
+      if (!contents.empty ())
+	queue_store (make_index_filename (build_id, INDEX4_SUFFIX),
+		     std::move (contents));
     }
   catch (const gdb_exception_error &except)
     {
@@ -137,6 +159,302 @@ index_cache::store (struct dwarf2_per_objfile *dwarf2_per_objfile)
     }
 }
 
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::queue_store (std::string &&filename, gdb::byte_vector &&contents)
+{
+  std::unique_ptr<pending_store> store (new pending_store);
+  store->filename = std::move (filename);
+  store->contents = std::move (contents);
+
+  pending_store *p = store.get ();
+  std::string dir = m_dir;
+  LONGEST max_size = (index_cache_max_size == -1 ? -1
+		      : (LONGEST) index_cache_max_size * 1024 * 1024);
+
+  m_pending_stores.push_back (std::move (store));
+  p->done = gdb::thread_pool::g_thread_pool->post_task
+    ([p, dir, max_size] ()
+     {
+       write_index_file (p, dir, max_size);
+     });
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::string
+index_cache::make_minsyms_filename (struct objfile *objfile,
+				    const bfd_build_id *build_id) const
+{
+  /* A separate debug file has the build id of the file it goes with,
+     but other minimal symbols.  */
+  return make_index_filename (build_id,
+			      (objfile->separate_debug_objfile_backlink != NULL
+			       ? ".debug" MINSYMS_SUFFIX : MINSYMS_SUFFIX));
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_minsyms (struct objfile *objfile, const std::string &key)
+{
+  if (!enabled () || m_dir.empty ())
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_shdr_get (objfile->obfd);
+  if (build_id == nullptr)
+    return;
+
+  reap_stores (false);
+
+  if (!mkdir_recursive (m_dir.c_str ()))
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: could not make cache directory: %s\n",
+			   safe_strerror (errno));
+      return;
+    }
+
+  gdb::byte_vector contents = serialize_minimal_symbols (objfile, key);
+  if (contents.empty ())
+    return;
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: writing minimal symbols for objfile %s\n",
+		       objfile_name (objfile));
+
+  queue_store (make_minsyms_filename (objfile, build_id),
+	       std::move (contents));
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::string
+index_cache::make_section_filename (asection *sectp,
+				    const bfd_build_id *build_id) const
+{
+  /* A separate debug file has the build id of the file it goes with,
+     so tell their sections apart by their position in the file.  The
+     size makes sure a stale file is not used.  */
+  std::string suffix
+    = string_printf ("-%s-%s" SECTION_SUFFIX,
+		     phex_nz (sectp->filepos, sizeof (sectp->filepos)),
+		     phex_nz (bfd_get_section_size (sectp),
+			      sizeof (bfd_size_type)));
+
+  return make_index_filename (build_id, suffix.c_str ());
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_section (asection *sectp, const gdb_byte *data)
+{
+  if (!enabled () || m_dir.empty ())
+    return;
+
+  const bfd_build_id *build_id = build_id_bfd_shdr_get (sectp->owner);
+  if (build_id == nullptr)
+    return;
+
+  reap_stores (false);
+
+  if (!mkdir_recursive (m_dir.c_str ()))
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: could not make cache directory: %s\n",
+			   safe_strerror (errno));
+      return;
+    }
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: writing section %s of %s\n",
+		       bfd_get_section_name (sectp->owner, sectp),
+		       bfd_get_filename (sectp->owner));
+
+  gdb::byte_vector contents (data, data + bfd_get_section_size (sectp));
+  queue_store (make_section_filename (sectp, build_id), std::move (contents));
+}
+
+/* Remove the least recently used index files of the cache directory
+   DIR until they take at most MAX_SIZE bytes.  Return the number of
+   files removed.  This runs on a worker thread.  */
+
+static unsigned int
+evict_index_files (const std::string &dir, LONGEST max_size)
+{
+  struct index_file
+  {
+    std::string name;
+    time_t atime;
+    off_t size;
+  };
+
+  gdb_dir_up d (opendir (dir.c_str ()));
+  if (d == NULL)
+    return 0;
+
+  std::vector<index_file> files;
+  LONGEST total = 0;
+  struct dirent *de;
+
+  auto has_suffix = [] (const char *name, size_t len, const char *suffix)
+    {
+      size_t suffix_len = strlen (suffix);
+
+      return len > suffix_len && strcmp (name + len - suffix_len, suffix) == 0;
+    };
+
+  while ((de = readdir (d.get ())) != NULL)
+    {
+      size_t len = strlen (de->d_name);
+
+      if (!has_suffix (de->d_name, len, INDEX4_SUFFIX)
+	  && !has_suffix (de->d_name, len, MINSYMS_SUFFIX)
+	  && !has_suffix (de->d_name, len, SECTION_SUFFIX))
+	continue;
+
+      std::string name = dir + SLASH_STRING + de->d_name;
+      struct stat st;
+
+      if (stat (name.c_str (), &st) != 0 || !S_ISREG (st.st_mode))
+	continue;
+
+      files.push_back ({std::move (name), st.st_atime, st.st_size});
+      total += st.st_size;
+    }
+
+  /* Cache hits update the access time of the index file, see
+     index_cache::lookup_gdb_index.  */
+  std::sort (files.begin (), files.end (),
+	     [] (const index_file &a, const index_file &b)
+	     {
+	       return a.atime < b.atime;
+	     });
+
+  unsigned int n_evicted = 0;
+
+  for (const index_file &file : files)
+    {
+      if (total <= max_size)
+	break;
+
+      /* Another GDB may have removed it already.  */
+      if (unlink (file.name.c_str ()) == 0)
+	{
+	  total -= file.size;
+	  n_evicted++;
+	}
+    }
+
+  return n_evicted;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::write_index_file (pending_store *store, const std::string &dir,
+			       LONGEST max_size)
+{
+  /* Write to a temporary file and rename it, so that other GDBs never
+     see a partial index.  */
+  gdb::char_vector filename_temp = make_temp_filename (store->filename);
+  scoped_fd fd (gdb_mkostemp_cloexec (filename_temp.data (), O_BINARY));
+  if (fd.get () == -1)
+    {
+      store->error = errno;
+      store->what = "mkstemp";
+      return;
+    }
+
+  gdb::unlinker unlink_file (filename_temp.data ());
+  const gdb_byte *buf = store->contents.data ();
+  size_t len = store->contents.size ();
+
+  while (len > 0)
+    {
+      ssize_t n = write (fd.get (), buf, len);
+
+      if (n == -1 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	{
+	  store->error = errno != 0 ? errno : EIO;
+	  store->what = "write";
+	  return;
+	}
+      buf += n;
+      len -= n;
+    }
+
+  /* The index isn't needed in memory anymore.  */
+  gdb::byte_vector ().swap (store->contents);
+
+  if (close (fd.release ()) != 0)
+    {
+      store->error = errno;
+      store->what = "close";
+      return;
+    }
+
+  if (rename (filename_temp.data (), store->filename.c_str ()) != 0)
+    {
+      store->error = errno;
+      store->what = "rename";
+      return;
+    }
+  unlink_file.keep ();
+
+  if (max_size != -1)
+    store->n_evicted = evict_index_files (dir, max_size);
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::reap_stores (bool wait)
+{
+  for (auto it = m_pending_stores.begin (); it != m_pending_stores.end ();)
+    {
+      pending_store *store = it->get ();
+
+      if (!wait
+	  && (store->done.wait_for (std::chrono::seconds (0))
+	      != std::future_status::ready))
+	{
+	  ++it;
+	  continue;
+	}
+      store->done.wait ();
+
+      if (store->error != 0)
+	{
+	  if (debug_index_cache)
+	    printf_unfiltered ("index cache: couldn't store %s: %s: %s\n",
+			       store->filename.c_str (), store->what,
+			       safe_strerror (store->error));
+	}
+      else
+	{
+	  if (debug_index_cache)
+	    printf_unfiltered ("index cache: stored %s\n",
+			       store->filename.c_str ());
+	  m_n_stores++;
+	}
+
+      if (store->n_evicted != 0)
+	{
+	  if (debug_index_cache)
+	    printf_unfiltered ("index cache: evicted %u index files\n",
+			       store->n_evicted);
+	  m_n_evictions += store->n_evicted;
+	}
+
+      it = m_pending_stores.erase (it);
+    }
+}
+
 #if HAVE_SYS_MMAN_H
 
 /* Hold the resources for an mmapped index file.  */
@@ -184,6 +502,10 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
       /* Yay, it worked!  Hand the resource to the caller.  */
       resource->reset (mmap_resource);
 
+      /* Mark the index as recently used for eviction, which doesn't
+	 rely on the file system updating access times.  */
+      utime (filename.c_str (), NULL);
+
       return gdb::array_view<const gdb_byte>
 	  ((const gdb_byte *) mmap_resource->mapping.get (),
 	   mmap_resource->mapping.size ());
@@ -198,10 +520,111 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
   return {};
 }
 
+/* See dwarf-index-cache.h.  */
+
+bool
+index_cache::lookup_minsyms (struct objfile *objfile, const std::string &key)
+{
+  if (!enabled () || m_dir.empty ())
+    return false;
+
+  const bfd_build_id *build_id = build_id_bfd_shdr_get (objfile->obfd);
+  if (build_id == nullptr)
+    return false;
+
+  std::string filename = make_minsyms_filename (objfile, build_id);
+
+  try
+    {
+      if (debug_index_cache)
+        printf_unfiltered ("index cache: trying to read %s\n",
+			   filename.c_str ());
+
+      index_cache_resource_mmap resource (filename.c_str ());
+      gdb::array_view<const gdb_byte> data
+	((const gdb_byte *) resource.mapping.get (), resource.mapping.size ());
+
+      if (install_cached_minimal_symbols (objfile, data, key))
+	{
+	  utime (filename.c_str (), NULL);
+	  m_n_minsym_hits++;
+	  return true;
+	}
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: %s is stale or corrupt\n",
+			   filename.c_str ());
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't read %s: %s\n",
+			   filename.c_str (), except.what ());
+    }
+
+  m_n_minsym_misses++;
+  return false;
+}
+
+/* See dwarf-index-cache.h.  */
+
+bool
+index_cache::lookup_section (asection *sectp, void **map_addr,
+			     bfd_size_type *map_len)
+{
+  if (!enabled () || m_dir.empty ())
+    return false;
+
+  const bfd_build_id *build_id = build_id_bfd_shdr_get (sectp->owner);
+  if (build_id == nullptr)
+    return false;
+
+  std::string filename = make_section_filename (sectp, build_id);
+
+  try
+    {
+      if (debug_index_cache)
+        printf_unfiltered ("index cache: trying to read %s\n",
+			   filename.c_str ());
+
+      scoped_mmap mapping = mmap_file (filename.c_str ());
+
+      if (mapping.size () == bfd_get_section_size (sectp))
+	{
+	  utime (filename.c_str (), NULL);
+	  m_n_section_hits++;
+	  *map_len = mapping.size ();
+	  *map_addr = mapping.release ();
+	  return true;
+	}
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: %s has the wrong size\n",
+			   filename.c_str ());
+    }
+  catch (const gdb_exception_error &except)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't read %s: %s\n",
+			   filename.c_str (), except.what ());
+    }
+
+  m_n_section_misses++;
+  return false;
+}
+
 #else /* !HAVE_SYS_MMAN_H */
 
 /* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
 
+bool
+index_cache::lookup_minsyms (struct objfile *objfile, const std::string &key)
+{
+  return false;
+}
+
+/* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
+
 gdb::array_view<const gdb_byte>
 index_cache::lookup_gdb_index (const bfd_build_id *build_id,
 			       std::unique_ptr<index_cache_resource> *resource)
@@ -209,6 +632,15 @@ index_cache::lookup_gdb_index (const bfd_build_id *build_id,
   return {};
 }
 
+/* See dwarf-index-cache.h.  This is a no-op on unsupported systems.  */
+
+bool
+index_cache::lookup_section (asection *sectp, void **map_addr,
+			     bfd_size_type *map_len)
+{
+  return false;
+}
+
 #endif
 
 /* See dwarf-index-cache.h.  */
@@ -300,6 +732,43 @@ show_index_cache_stats_command (const char *arg, int from_tty)
 		     indent, global_index_cache.n_hits ());
   printf_unfiltered (_("%sCache misses (this session): %u\n"),
 		     indent, global_index_cache.n_misses ());
+
+  /* Account for all the stores in progress.  */
+  global_index_cache.wait_for_stores ();
+  printf_unfiltered (_("%sCache stores (this session): %u\n"),
+		     indent, global_index_cache.n_stores ());
+  printf_unfiltered (_("%s   Evictions (this session): %u\n"),
+		     indent, global_index_cache.n_evictions ());
+  printf_unfiltered (_("%s  Minimal symbol hits (this session): %u\n"),
+		     indent, global_index_cache.n_minsym_hits ());
+  printf_unfiltered (_("%sMinimal symbol misses (this session): %u\n"),
+		     indent, global_index_cache.n_minsym_misses ());
+  printf_unfiltered (_("%s  Section hits (this session): %u\n"),
+		     indent, global_index_cache.n_section_hits ());
+  printf_unfiltered (_("%sSection misses (this session): %u\n"),
+		     indent, global_index_cache.n_section_misses ());
+}
+
+/* "show index-cache max-size" handler.  */
+
+static void
+show_index_cache_max_size (struct ui_file *file, int from_tty,
+			   struct cmd_list_element *c, const char *value)
+{
+  if (index_cache_max_size == -1)
+    fprintf_filtered (file, _("The maximum size of the index cache is "
+			      "unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The maximum size of the index cache is "
+			      "%s megabytes.\n"), value);
+}
+
+/* Final cleanup: don't exit while indexes are being written.  */
+
+static void
+wait_for_index_cache_stores (void *arg)
+{
+  global_index_cache.wait_for_stores ();
 }
 
 void
@@ -315,6 +784,8 @@ _initialize_index_cache ()
   else
     warning (_("Couldn't determine a path for the index cache directory."));
 
+  make_final_cleanup (wait_for_index_cache_stores, NULL);
+
   /* set index-cache */
   add_prefix_cmd ("index-cache", class_files, set_index_cache_command,
 		  _("Set index-cache options"), &set_index_cache_prefix_list,
@@ -342,6 +813,17 @@ _initialize_index_cache ()
 			    &set_index_cache_prefix_list,
 			    &show_index_cache_prefix_list);
 
+  /* set index-cache max-size */
+  add_setshow_zuinteger_unlimited_cmd ("max-size", class_files,
+				       &index_cache_max_size, _("\
+Set the maximum size of the index cache, in megabytes."), _("\
+Show the maximum size of the index cache, in megabytes."), _("\
+When storing an index makes the cache bigger than this, the least\n\
+recently used index files are removed.  \"unlimited\" means no limit."),
+				       NULL, show_index_cache_max_size,
+				       &set_index_cache_prefix_list,
+				       &show_index_cache_prefix_list);
+
   /* show index-cache stats */
   add_cmd ("stats", class_files, show_index_cache_stats_command,
 	   _("Show some stats about the index cache."),
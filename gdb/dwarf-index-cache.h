@@ -22,7 +22,10 @@
 
 #include "dwarf-index-common.h"
 #include "common/array-view.h"
+#include "common/byte-vector.h"
 #include "symfile.h"
+#include <future>
+#include <list>
 
 /* Base of the classes used to hold the resources of the indices loaded from
    the cache (e.g. mmapped files).  */
@@ -52,9 +55,38 @@ public:
   /* Disable the cache.  */
   void disable ();
 
-  /* Store an index for the specified object file in the cache.  */
+  /* Store an index for the specified object file in the cache.  The
+     index is built right away, but written to the cache directory by
+     a worker thread.  */
   void store (struct dwarf2_per_objfile *dwarf2_per_objfile);
 
+  /* Store the installed minimal symbols of OBJFILE in the cache.  KEY
+     identifies what they were read from, see
+     serialize_minimal_symbols.  */
+  void store_minsyms (struct objfile *objfile, const std::string &key);
+
+  /* Install the minimal symbols of OBJFILE from the cache, if they were
+     stored with KEY.  Return true on success.  */
+  bool lookup_minsyms (struct objfile *objfile, const std::string &key);
+
+  /* Store DATA, the decompressed contents of the compressed section
+     SECTP, in the cache, so that other GDBs can map them instead of
+     decompressing the section again.  */
+  void store_section (asection *sectp, const gdb_byte *data);
+
+  /* Look for the decompressed contents of the compressed section SECTP
+     in the cache.  If found, map them read-only, store the mapping in
+     *MAP_ADDR and *MAP_LEN, and return true.  The caller must munmap
+     the mapping.  */
+  bool lookup_section (asection *sectp, void **map_addr,
+		       bfd_size_type *map_len);
+
+  /* Wait for the indexes being written to the cache directory.  */
+  void wait_for_stores ()
+  {
+    reap_stores (true);
+  }
+
   /* Look for an index file matching BUILD_ID.  If found, return the contents
      as an array_view and store the underlying resources (allocated memory,
      mapped file, etc) in RESOURCE.  The returned array_view is valid as long
@@ -87,8 +119,74 @@ public:
       m_n_misses++;
   }
 
+  /* Return the number of minimal symbol tables found and not found in
+     the cache.  */
+  unsigned int n_minsym_hits () const
+  { return m_n_minsym_hits; }
+  unsigned int n_minsym_misses () const
+  { return m_n_minsym_misses; }
+
+  /* Return the number of section contents found and not found in the
+     cache.  */
+  unsigned int n_section_hits () const
+  { return m_n_section_hits; }
+  unsigned int n_section_misses () const
+  { return m_n_section_misses; }
+
+  /* Return the number of indexes stored and of index files evicted
+     from the cache.  Only the stores that have completed are
+     counted.  */
+  unsigned int n_stores () const
+  { return m_n_stores; }
+  unsigned int n_evictions () const
+  { return m_n_evictions; }
+
 private:
 
+  /* An index being written to the cache directory.  The worker thread
+     writing it records the outcome here, for the main thread to
+     report.  */
+  struct pending_store
+  {
+    /* The index file and its contents.  */
+    std::string filename;
+    gdb::byte_vector contents;
+
+    /* If writing the file failed, the errno value and the operation
+       that failed.  */
+    int error = 0;
+    const char *what = nullptr;
+
+    /* The number of index files evicted afterwards.  */
+    unsigned int n_evicted = 0;
+
+    /* Set when the worker thread is done.  */
+    std::future<void> done;
+  };
+
+  /* Write the index of STORE, then evict the least recently used
+     index files of directory DIR until they take at most MAX_SIZE
+     bytes, unless MAX_SIZE is -1.  This runs on a worker thread.  */
+  static void write_index_file (pending_store *store, const std::string &dir,
+				LONGEST max_size);
+
+  /* Account for the stores that have completed, waiting for all of
+     them if WAIT is true.  */
+  void reap_stores (bool wait);
+
+  /* Write CONTENTS to the cache file FILENAME on a worker thread.  */
+  void queue_store (std::string &&filename, gdb::byte_vector &&contents);
+
+  /* Return the name of the file holding the minimal symbols of
+     OBJFILE, whose build id is BUILD_ID.  */
+  std::string make_minsyms_filename (struct objfile *objfile,
+				     const bfd_build_id *build_id) const;
+
+  /* Return the name of the file holding the decompressed contents of
+     SECTP, whose BFD has the build id BUILD_ID.  */
+  std::string make_section_filename (asection *sectp,
+				     const bfd_build_id *build_id) const;
+
   /* Compute the absolute filename where the index of the objfile with build
      id BUILD_ID will be stored.  SUFFIX is appended at the end of the
      filename.  */
@@ -104,6 +202,24 @@ private:
   /* Number of cache hits and misses during this GDB session.  */
   unsigned int m_n_hits = 0;
   unsigned int m_n_misses = 0;
+
+  /* Number of minimal symbol tables found and not found in the cache
+     during this GDB session.  */
+  unsigned int m_n_minsym_hits = 0;
+  unsigned int m_n_minsym_misses = 0;
+
+  /* Number of section contents found and not found in the cache
+     during this GDB session.  */
+  unsigned int m_n_section_hits = 0;
+  unsigned int m_n_section_misses = 0;
+
+  /* Number of indexes stored and of index files evicted during this
+     GDB session.  */
+  unsigned int m_n_stores = 0;
+  unsigned int m_n_evictions = 0;
+
+  /* The indexes being written, oldest first.  */
+  std::list<std::unique_ptr<pending_store>> m_pending_stores;
 };
 
 /* The global instance of the index cache.  */
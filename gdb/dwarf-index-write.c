@@ -23,9 +23,11 @@
 #include "cli/cli-decode.h"
 #include "common/byte-vector.h"
 #include "common/filestuff.h"
+#include "common/function-view.h"
 #include "common/gdb_unlinker.h"
 #include "common/pathstuff.h"
 #include "common/scoped_fd.h"
+#include "common/thread-pool.h"
 #include "complaints.h"
 #include "dwarf-index-common.h"
 #include "dwarf2.h"
@@ -146,6 +148,12 @@ public:
     ::file_write (file, m_vec);
   }
 
+  /* Append the buffer to VEC.  */
+  void append_to (gdb::byte_vector *vec) const
+  {
+    vec->insert (vec->end (), m_vec.begin (), m_vec.end ());
+  }
+
 private:
   /* Grow SIZE bytes at the end of the buffer.  Returns a pointer to
      the start of the new block.  */
@@ -163,6 +171,8 @@ struct symtab_index_entry
 {
   /* The name of the symbol.  */
   const char *name;
+  /* The mapped_index_string_hash of NAME.  */
+  offset_type hash;
   /* The offset of the name in the constant pool.  */
   offset_type index_offset;
   /* A sorted vector of the indices of all the CUs that hold an object
@@ -182,24 +192,30 @@ struct mapped_symtab
   std::vector<symtab_index_entry> data;
 };
 
-/* Find a slot in SYMTAB for the symbol NAME.  Returns a reference to
-   the slot.
+/* Find a slot in SYMTAB for the symbol NAME, whose
+   mapped_index_string_hash is HASH.  Returns a reference to the slot.
 
    Function is used only during write_hash_table so no index format backward
    compatibility is needed.  */
 
 static symtab_index_entry &
-find_slot (struct mapped_symtab *symtab, const char *name)
+find_slot (struct mapped_symtab *symtab, const char *name, offset_type hash)
 {
-  offset_type index, step, hash = mapped_index_string_hash (INT_MAX, name);
+  offset_type index, step;
 
   index = hash & (symtab->data.size () - 1);
   step = ((hash * 17) & (symtab->data.size () - 1)) | 1;
 
   for (;;)
     {
-      if (symtab->data[index].name == NULL
-	  || strcmp (name, symtab->data[index].name) == 0)
+      const symtab_index_entry &entry = symtab->data[index];
+
+      /* Names are mostly shared through the BFD cache, so comparing
+	 the pointers and the hashes avoids most of the string
+	 comparisons.  */
+      if (entry.name == NULL
+	  || entry.name == name
+	  || (entry.hash == hash && strcmp (name, entry.name) == 0))
 	return symtab->data[index];
       index = (index + step) & (symtab->data.size () - 1);
     }
@@ -218,18 +234,19 @@ hash_expand (struct mapped_symtab *symtab)
   for (auto &it : old_entries)
     if (it.name != NULL)
       {
-	auto &ref = find_slot (symtab, it.name);
+	auto &ref = find_slot (symtab, it.name, it.hash);
 	ref = std::move (it);
       }
 }
 
-/* Add an entry to SYMTAB.  NAME is the name of the symbol.
+/* Add an entry to SYMTAB.  NAME is the name of the symbol, and HASH
+   its mapped_index_string_hash.
    CU_INDEX is the index of the CU in which the symbol appears.
    IS_STATIC is one if the symbol is static, otherwise zero (global).  */
 
 static void
 add_index_entry (struct mapped_symtab *symtab, const char *name,
-		 int is_static, gdb_index_symbol_kind kind,
+		 offset_type hash, int is_static, gdb_index_symbol_kind kind,
 		 offset_type cu_index)
 {
   offset_type cu_index_and_attrs;
@@ -238,10 +255,11 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   if (4 * symtab->n_elements / 3 >= symtab->data.size ())
     hash_expand (symtab);
 
-  symtab_index_entry &slot = find_slot (symtab, name);
+  symtab_index_entry &slot = find_slot (symtab, name, hash);
   if (slot.name == NULL)
     {
       slot.name = name;
+      slot.hash = hash;
       /* index_offset is set later.  */
     }
 
@@ -260,21 +278,64 @@ add_index_entry (struct mapped_symtab *symtab, const char *name,
   slot.cu_indices.push_back (cu_index_and_attrs);
 }
 
+/* Call FN (I) for each I in [0, N), on worker threads when there are
+   any, and wait for all of them to return.  */
+
+static void
+run_on_worker_threads (size_t n, gdb::function_view<void (size_t)> fn)
+{
+  std::vector<std::future<void>> results;
+
+  results.reserve (n);
+  for (size_t i = 0; i < n; ++i)
+    results.push_back (gdb::thread_pool::g_thread_pool->post_task ([=] ()
+      {
+	fn (i);
+      }));
+
+  /* Wait for all the tasks before rethrowing any exception, since
+     they all refer to FN.  */
+  for (auto &result : results)
+    result.wait ();
+  for (auto &result : results)
+    result.get ();
+}
+
+/* Return in how many parts to split work that is done on worker
+   threads: one per thread, and one for the main thread, which waits
+   for them.  */
+
+static size_t
+worker_thread_shards ()
+{
+  return gdb::thread_pool::g_thread_pool->thread_count () + 1;
+}
+
 /* Sort and remove duplicates of all symbols' cu_indices lists.  */
 
 static void
 uniquify_cu_indices (struct mapped_symtab *symtab)
 {
-  for (auto &entry : symtab->data)
+  const size_t n_shards = worker_thread_shards ();
+  const size_t size = symtab->data.size ();
+
+  run_on_worker_threads (n_shards, [&] (size_t shard)
     {
-      if (entry.name != NULL && !entry.cu_indices.empty ())
+      for (size_t i = size * shard / n_shards;
+	   i < size * (shard + 1) / n_shards;
+	   ++i)
 	{
-	  auto &cu_indices = entry.cu_indices;
-	  std::sort (cu_indices.begin (), cu_indices.end ());
-	  auto from = std::unique (cu_indices.begin (), cu_indices.end ());
-	  cu_indices.erase (from, cu_indices.end ());
+	  symtab_index_entry &entry = symtab->data[i];
+
+	  if (entry.name != NULL && !entry.cu_indices.empty ())
+	    {
+	      auto &cu_indices = entry.cu_indices;
+	      std::sort (cu_indices.begin (), cu_indices.end ());
+	      auto from = std::unique (cu_indices.begin (), cu_indices.end ());
+	      cu_indices.erase (from, cu_indices.end ());
+	    }
 	}
-    }
+    });
 }
 
 /* A form of 'const char *' suitable for container keys.  Only the
@@ -334,16 +395,43 @@ static void
 write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
 {
   {
-    /* Elements are sorted vectors of the indices of all the CUs that
-       hold an object of this name.  */
-    std::unordered_map<std::vector<offset_type>, offset_type,
-		       vector_hasher<offset_type>>
-      symbol_hash_table;
+    const size_t size = symtab->data.size ();
+
+    /* Hash the sorted vectors of the indices of all the CUs that hold
+       an object of each name on worker threads.  */
+    std::vector<size_t> hashes (size);
+    const size_t n_shards = worker_thread_shards ();
+    run_on_worker_threads (n_shards, [&] (size_t shard)
+      {
+	vector_hasher<offset_type> hasher;
+
+	for (size_t i = size * shard / n_shards;
+	     i < size * (shard + 1) / n_shards;
+	     ++i)
+	  if (symtab->data[i].name != NULL)
+	    hashes[i] = hasher (symtab->data[i].cu_indices);
+      });
+
+    /* Elements are the positions in SYMTAB of the symbols, which are
+       equal when their vectors of CU indices are.  */
+    auto slot_hash = [&] (size_t i)
+      {
+	return hashes[i];
+      };
+    auto slot_eq = [&] (size_t a, size_t b)
+      {
+	return symtab->data[a].cu_indices == symtab->data[b].cu_indices;
+      };
+    std::unordered_map<size_t, offset_type, decltype (slot_hash),
+		       decltype (slot_eq)>
+      symbol_hash_table (symtab->n_elements, slot_hash, slot_eq);
 
     /* We add all the index vectors to the constant pool first, to
        ensure alignment is ok.  */
-    for (symtab_index_entry &entry : symtab->data)
+    for (size_t i = 0; i < size; ++i)
       {
+	symtab_index_entry &entry = symtab->data[i];
+
 	if (entry.name == NULL)
 	  continue;
 	gdb_assert (entry.index_offset == 0);
@@ -353,15 +441,14 @@ write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
 	   lookup, and then destroys the new node if another node
 	   already had the same key.  C++17 try_emplace will avoid
 	   this.  */
-	const auto found
-	  = symbol_hash_table.find (entry.cu_indices);
+	const auto found = symbol_hash_table.find (i);
 	if (found != symbol_hash_table.end ())
 	  {
 	    entry.index_offset = found->second;
 	    continue;
 	  }
 
-	symbol_hash_table.emplace (entry.cu_indices, cpool.size ());
+	symbol_hash_table.emplace (i, cpool.size ());
 	entry.index_offset = cpool.size ();
 	cpool.append_data (MAYBE_SWAP (entry.cu_indices.size ()));
 	for (const auto index : entry.cu_indices)
@@ -369,18 +456,16 @@ write_hash_table (mapped_symtab *symtab, data_buf &output, data_buf &cpool)
       }
   }
 
-  /* Now write out the hash table.  */
-  std::unordered_map<c_str_view, offset_type, c_str_view_hasher> str_table;
+  /* Now write out the hash table.  The names in SYMTAB are all
+     different, so each of them is added to the constant pool.  */
   for (const auto &entry : symtab->data)
     {
       offset_type str_off, vec_off;
 
       if (entry.name != NULL)
 	{
-	  const auto insertpair = str_table.emplace (entry.name, cpool.size ());
-	  if (insertpair.second)
-	    cpool.append_cstr0 (entry.name);
-	  str_off = insertpair.first->second;
+	  str_off = cpool.size ();
+	  cpool.append_cstr0 (entry.name);
 	  vec_off = entry.index_offset;
 	}
       else
@@ -526,83 +611,57 @@ symbol_kind (struct partial_symbol *psym)
     }
 }
 
-/* Add a list of partial symbols to SYMTAB.  */
+/* A partial symbol to add to an index, and the unit it belongs to.  */
 
-static void
-write_psymbols (struct mapped_symtab *symtab,
-		std::unordered_set<partial_symbol *> &psyms_seen,
-		struct partial_symbol **psymp,
-		int count,
-		offset_type cu_index,
-		int is_static)
+struct index_psym
 {
-  for (; count-- > 0; ++psymp)
-    {
-      struct partial_symbol *psym = *psymp;
+  struct partial_symbol *psym;
 
-      if (psym->language == language_ada)
-	error (_("Ada is not currently supported by the index"));
+  /* The index of the unit in the CU or TU list of the index.  */
+  offset_type cu_index;
 
-      /* Only add a given psymbol once.  */
-      if (psyms_seen.insert (psym).second)
-	{
-	  gdb_index_symbol_kind kind = symbol_kind (psym);
+  /* For .gdb_index, the mapped_index_string_hash of the search name
+     of PSYM.  */
+  offset_type hash;
 
-	  add_index_entry (symtab, symbol_search_name (psym),
-			   is_static, kind, cu_index);
-	}
-    }
-}
+  bool is_static;
+  bool is_tu;
+
+  /* Set when PSYM was already added for an earlier unit.  */
+  bool duplicate;
+};
 
-/* A helper struct used when iterating over debug_types.  */
-struct signatured_type_index_data
+/* A unit whose partial symbols go in an index.  */
+
+struct index_unit
 {
-  signatured_type_index_data (data_buf &types_list_,
-                              std::unordered_set<partial_symbol *> &psyms_seen_)
-    : types_list (types_list_), psyms_seen (psyms_seen_)
-  {}
+  struct partial_symtab *psymtab;
+  offset_type cu_index;
 
-  struct objfile *objfile;
-  struct mapped_symtab *symtab;
-  data_buf &types_list;
-  std::unordered_set<partial_symbol *> &psyms_seen;
-  int cu_index;
+  /* Whether this is a type unit.  The psymtabs included by a compile
+     unit are walked as if their symbols appeared in it; those of a
+     type unit are not.  */
+  bool is_tu;
 };
 
-/* A helper function that writes a single signatured_type to an
-   obstack.  */
+/* The partial symbols of a contiguous range of units, being
+   collected by collect_index_psyms.  */
 
-static int
-write_one_signatured_type (void **slot, void *d)
+struct index_psym_shard
 {
-  struct signatured_type_index_data *info
-    = (struct signatured_type_index_data *) d;
-  struct signatured_type *entry = (struct signatured_type *) *slot;
-  struct partial_symtab *psymtab = entry->per_cu.v.psymtab;
-
-  write_psymbols (info->symtab,
-		  info->psyms_seen,
-		  (info->objfile->partial_symtabs->global_psymbols.data ()
-		   + psymtab->globals_offset),
-		  psymtab->n_global_syms, info->cu_index,
-		  0);
-  write_psymbols (info->symtab,
-		  info->psyms_seen,
-		  (info->objfile->partial_symtabs->static_psymbols.data ()
-		   + psymtab->statics_offset),
-		  psymtab->n_static_syms, info->cu_index,
-		  1);
-
-  info->types_list.append_uint (8, BFD_ENDIAN_LITTLE,
-				to_underlying (entry->per_cu.sect_off));
-  info->types_list.append_uint (8, BFD_ENDIAN_LITTLE,
-				to_underlying (entry->type_offset_in_tu));
-  info->types_list.append_uint (8, BFD_ENDIAN_LITTLE, entry->signature);
-
-  ++info->cu_index;
+  /* The units, [BEGIN, END).  */
+  size_t begin, end;
 
-  return 1;
-}
+  /* The partial symbols of the units, in order.  */
+  std::vector<index_psym> psyms;
+
+  /* For each partition of the partial symbols, the positions in PSYMS
+     of those it holds.  */
+  std::vector<std::vector<unsigned int>> by_partition;
+
+  /* Whether one of the symbols is an Ada symbol.  */
+  bool has_ada = false;
+};
 
 /* Recurse into all "included" dependencies and count their symbols as
    if they appeared in this psymtab.  */
@@ -620,35 +679,196 @@ recursively_count_psymbols (struct partial_symtab *psymtab,
   psyms_seen += psymtab->n_static_syms;
 }
 
-/* Recurse into all "included" dependencies and write their symbols as
-   if they appeared in this psymtab.  */
+/* Append COUNT partial symbols at PSYMP, which belong to UNIT, to
+   SHARD.  */
 
 static void
-recursively_write_psymbols (struct objfile *objfile,
-			    struct partial_symtab *psymtab,
-			    struct mapped_symtab *symtab,
-			    std::unordered_set<partial_symbol *> &psyms_seen,
-			    offset_type cu_index)
+collect_psymbols (index_psym_shard &shard, const index_unit &unit,
+		  struct partial_symbol **psymp, int count, bool is_static)
 {
-  int i;
+  for (; count-- > 0; ++psymp)
+    {
+      struct partial_symbol *psym = *psymp;
 
-  for (i = 0; i < psymtab->number_of_dependencies; ++i)
-    if (psymtab->dependencies[i]->user != NULL)
-      recursively_write_psymbols (objfile, psymtab->dependencies[i],
-				  symtab, psyms_seen, cu_index);
-
-  write_psymbols (symtab,
-		  psyms_seen,
-		  (objfile->partial_symtabs->global_psymbols.data ()
-		   + psymtab->globals_offset),
-		  psymtab->n_global_syms, cu_index,
-		  0);
-  write_psymbols (symtab,
-		  psyms_seen,
-		  (objfile->partial_symtabs->static_psymbols.data ()
-		   + psymtab->statics_offset),
-		  psymtab->n_static_syms, cu_index,
-		  1);
+      if (psym->language == language_ada)
+	shard.has_ada = true;
+
+      shard.psyms.push_back ({ psym, unit.cu_index, 0, is_static,
+			       unit.is_tu, false });
+    }
+}
+
+/* Recurse into all "included" dependencies of PSYMTAB unless UNIT is
+   a type unit, and append their symbols to SHARD as if they appeared
+   in PSYMTAB.  Then append those of PSYMTAB.  */
+
+static void
+recursively_collect_psymbols (struct objfile *objfile,
+			      struct partial_symtab *psymtab,
+			      const index_unit &unit,
+			      index_psym_shard &shard)
+{
+  if (!unit.is_tu)
+    for (int i = 0; i < psymtab->number_of_dependencies; ++i)
+      if (psymtab->dependencies[i]->user != NULL)
+	recursively_collect_psymbols (objfile, psymtab->dependencies[i],
+				      unit, shard);
+
+  collect_psymbols (shard, unit,
+		    (objfile->partial_symtabs->global_psymbols.data ()
+		     + psymtab->globals_offset),
+		    psymtab->n_global_syms, false);
+  collect_psymbols (shard, unit,
+		    (objfile->partial_symtabs->static_psymbols.data ()
+		     + psymtab->statics_offset),
+		    psymtab->n_static_syms, true);
+}
+
+/* Return the partial symbols of UNITS to add to an index, in order.
+   A given partial symbol is only added once, for the first unit that
+   has it.  If WANT_HASH, also compute the .gdb_index hash of their
+   names.
+
+   This is done in three steps, each split across the worker threads:
+   the units are split in contiguous shards whose symbols are
+   collected; the symbols are partitioned by address, and the
+   occurrences of each partition are deduplicated in order; finally
+   the duplicates are removed from each shard.  The symbols are
+   returned by shard, and the shards must be walked in order.  */
+
+static std::vector<std::vector<index_psym>>
+collect_index_psyms (struct objfile *objfile,
+		     const std::vector<index_unit> &units, bool want_hash)
+{
+  /* Split the units so that the shards have about as many symbols.  */
+  std::vector<size_t> counts (units.size ());
+  size_t total = 0;
+  for (size_t i = 0; i < units.size (); ++i)
+    {
+      if (units[i].is_tu)
+	counts[i] = (units[i].psymtab->n_global_syms
+		     + units[i].psymtab->n_static_syms);
+      else
+	recursively_count_psymbols (units[i].psymtab, counts[i]);
+      total += counts[i];
+    }
+
+  const size_t n_shards = worker_thread_shards ();
+  std::vector<index_psym_shard> shards (n_shards);
+  size_t next_unit = 0, next_total = 0;
+  for (size_t k = 0; k < n_shards; ++k)
+    {
+      shards[k].begin = next_unit;
+      while (next_unit < units.size ()
+	     && (k == n_shards - 1
+		 || next_total < total * (k + 1) / n_shards))
+	next_total += counts[next_unit++];
+      shards[k].end = next_unit;
+    }
+
+  run_on_worker_threads (n_shards, [&] (size_t k)
+    {
+      index_psym_shard &shard = shards[k];
+
+      for (size_t i = shard.begin; i < shard.end; ++i)
+	recursively_collect_psymbols (objfile, units[i].psymtab, units[i],
+				      shard);
+
+      shard.by_partition.resize (n_shards);
+      for (size_t i = 0; i < shard.psyms.size (); ++i)
+	shard.by_partition[htab_hash_pointer (shard.psyms[i].psym)
+			   % n_shards].push_back (i);
+    });
+
+  for (const index_psym_shard &shard : shards)
+    if (shard.has_ada)
+      error (_("Ada is not currently supported by the index"));
+
+  /* Generating an index for gdb itself shows a ratio of
+     TOTAL_SEEN_SYMS/UNIQUE_SYMS or ~5.  4 seems like a good bet to
+     avoid too many rehashes.  */
+  run_on_worker_threads (n_shards, [&] (size_t partition)
+    {
+      std::unordered_set<partial_symbol *> psyms_seen
+	(total / 4 / n_shards);
+
+      for (index_psym_shard &shard : shards)
+	for (unsigned int i : shard.by_partition[partition])
+	  if (!psyms_seen.insert (shard.psyms[i].psym).second)
+	    shard.psyms[i].duplicate = true;
+    });
+
+  std::vector<std::vector<index_psym>> result (n_shards);
+  run_on_worker_threads (n_shards, [&] (size_t k)
+    {
+      std::vector<index_psym> &psyms = shards[k].psyms;
+
+      psyms.erase (std::remove_if (psyms.begin (), psyms.end (),
+				   [] (const index_psym &psym)
+				   {
+				     return psym.duplicate;
+				   }),
+		   psyms.end ());
+
+      if (want_hash)
+	for (index_psym &psym : psyms)
+	  psym.hash = mapped_index_string_hash
+	    (INT_MAX, symbol_search_name (psym.psym));
+
+      result[k] = std::move (psyms);
+    });
+
+  return result;
+}
+
+/* Return the compile units of DWARF2_PER_OBJFILE whose partial
+   symbols go in an index.  */
+
+static std::vector<index_unit>
+index_compile_units (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  std::vector<index_unit> units;
+
+  for (int i = 0; i < dwarf2_per_objfile->all_comp_units.size (); ++i)
+    {
+      struct partial_symtab *psymtab
+	= dwarf2_per_objfile->all_comp_units[i]->v.psymtab;
+
+      /* CU of a shared file from 'dwz -m' may be unused by this main file.
+	 It may be referenced from a local scope but in such case it does not
+	 need to be present in the index.  */
+      if (psymtab != NULL && psymtab->user == NULL)
+	units.push_back ({ psymtab, (offset_type) i, false });
+    }
+
+  return units;
+}
+
+/* A helper function that appends a single signatured_type to a
+   vector.  */
+
+static int
+add_one_signatured_type (void **slot, void *d)
+{
+  std::vector<signatured_type *> *types
+    = (std::vector<signatured_type *> *) d;
+
+  types->push_back ((struct signatured_type *) *slot);
+  return 1;
+}
+
+/* Return the signatured types of DWARF2_PER_OBJFILE, in the order of
+   the TU list of the index.  */
+
+static std::vector<signatured_type *>
+index_type_units (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  std::vector<signatured_type *> types;
+
+  if (dwarf2_per_objfile->signatured_types)
+    htab_traverse_noresize (dwarf2_per_objfile->signatured_types,
+			    add_one_signatured_type, &types);
+  return types;
 }
 
 /* DWARF-5 .debug_names builder.  */
@@ -823,29 +1043,6 @@ public:
     return m_abbrev_table.size ();
   }
 
-  /* Recurse into all "included" dependencies and store their symbols
-     as if they appeared in this psymtab.  */
-  void recursively_write_psymbols
-    (struct objfile *objfile,
-     struct partial_symtab *psymtab,
-     std::unordered_set<partial_symbol *> &psyms_seen,
-     int cu_index)
-  {
-    for (int i = 0; i < psymtab->number_of_dependencies; ++i)
-      if (psymtab->dependencies[i]->user != NULL)
-	recursively_write_psymbols (objfile, psymtab->dependencies[i],
-				    psyms_seen, cu_index);
-
-    write_psymbols (psyms_seen,
-		    (objfile->partial_symtabs->global_psymbols.data ()
-		     + psymtab->globals_offset),
-		    psymtab->n_global_syms, cu_index, false, unit_kind::cu);
-    write_psymbols (psyms_seen,
-		    (objfile->partial_symtabs->static_psymbols.data ()
-		     + psymtab->statics_offset),
-		    psymtab->n_static_syms, cu_index, true, unit_kind::cu);
-  }
-
   /* Return number of bytes the .debug_names section will have.  This
      must be called only after calling the build method.  */
   size_t bytes () const
@@ -878,32 +1075,6 @@ public:
     m_debugstrlookup.file_write (file_str);
   }
 
-  /* A helper user data for write_one_signatured_type.  */
-  class write_one_signatured_type_data
-  {
-  public:
-    write_one_signatured_type_data (debug_names &nametable_,
-                                    signatured_type_index_data &&info_)
-    : nametable (nametable_), info (std::move (info_))
-    {}
-    debug_names &nametable;
-    struct signatured_type_index_data info;
-  };
-
-  /* A helper function to pass write_one_signatured_type to
-     htab_traverse_noresize.  */
-  static int
-  write_one_signatured_type (void **slot, void *d)
-  {
-    write_one_signatured_type_data *data = (write_one_signatured_type_data *) d;
-    struct signatured_type_index_data *info = &data->info;
-    struct signatured_type *entry = (struct signatured_type *) *slot;
-
-    data->nametable.write_one_signatured_type (entry, info);
-
-    return 1;
-  }
-
 private:
 
   /* Storage for symbol names mapping them to their .debug_str section
@@ -1172,49 +1343,6 @@ private:
       }
   }
 
-  /* Call insert for all partial symbols and mark them in PSYMS_SEEN.  */
-  void write_psymbols (std::unordered_set<partial_symbol *> &psyms_seen,
-		       struct partial_symbol **psymp, int count, int cu_index,
-		       bool is_static, unit_kind kind)
-  {
-    for (; count-- > 0; ++psymp)
-      {
-	struct partial_symbol *psym = *psymp;
-
-	if (psym->language == language_ada)
-	  error (_("Ada is not currently supported by the index"));
-
-	/* Only add a given psymbol once.  */
-	if (psyms_seen.insert (psym).second)
-	  insert (psym, cu_index, is_static, kind);
-      }
-  }
-
-  /* A helper function that writes a single signatured_type
-     to a debug_names.  */
-  void
-  write_one_signatured_type (struct signatured_type *entry,
-			     struct signatured_type_index_data *info)
-  {
-    struct partial_symtab *psymtab = entry->per_cu.v.psymtab;
-
-    write_psymbols (info->psyms_seen,
-		    (info->objfile->partial_symtabs->global_psymbols.data ()
-		     + psymtab->globals_offset),
-		    psymtab->n_global_syms, info->cu_index, false,
-		    unit_kind::tu);
-    write_psymbols (info->psyms_seen,
-		    (info->objfile->partial_symtabs->static_psymbols.data ()
-		     + psymtab->statics_offset),
-		    psymtab->n_static_syms, info->cu_index, true,
-		    unit_kind::tu);
-
-    info->types_list.append_uint (dwarf5_offset_size (), m_dwarf5_byte_order,
-				  to_underlying (entry->per_cu.sect_off));
-
-    ++info->cu_index;
-  }
-
   /* Store value of each symbol.  */
   std::unordered_map<c_str_view, std::set<symbol_value>, c_str_view_hasher>
     m_name_to_value_set;
@@ -1267,33 +1395,11 @@ check_dwarf64_offsets (struct dwarf2_per_objfile *dwarf2_per_objfile)
   return false;
 }
 
-/* The psyms_seen set is potentially going to be largish (~40k
-   elements when indexing a -g3 build of GDB itself).  Estimate the
-   number of elements in order to avoid too many rehashes, which
-   require rebuilding buckets and thus many trips to
-   malloc/free.  */
+/* Build a new .gdb_index section for OBJFILE in OUT.  */
 
-static size_t
-psyms_seen_size (struct dwarf2_per_objfile *dwarf2_per_objfile)
-{
-  size_t psyms_count = 0;
-  for (dwarf2_per_cu_data *per_cu : dwarf2_per_objfile->all_comp_units)
-    {
-      struct partial_symtab *psymtab = per_cu->v.psymtab;
-
-      if (psymtab != NULL && psymtab->user == NULL)
-	recursively_count_psymbols (psymtab, psyms_count);
-    }
-  /* Generating an index for gdb itself shows a ratio of
-     TOTAL_SEEN_SYMS/UNIQUE_SYMS or ~5.  4 seems like a good bet.  */
-  return psyms_count / 4;
-}
-
-/* Write new .gdb_index section for OBJFILE into OUT_FILE.
-   Return how many bytes were expected to be written into OUT_FILE.  */
-
-static size_t
-write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile, FILE *out_file)
+static void
+write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile,
+		gdb::byte_vector *out)
 {
   struct objfile *objfile = dwarf2_per_objfile->objfile;
   mapped_symtab symtab;
@@ -1309,9 +1415,6 @@ write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile, FILE *out_file)
   /* The CU list is already sorted, so we don't need to do additional
      work here.  Also, the debug_types entries do not appear in
      all_comp_units, but only in their own hash table.  */
-
-  std::unordered_set<partial_symbol *> psyms_seen
-    (psyms_seen_size (dwarf2_per_objfile));
   for (int i = 0; i < dwarf2_per_objfile->all_comp_units.size (); ++i)
     {
       struct dwarf2_per_cu_data *per_cu
@@ -1324,10 +1427,6 @@ write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile, FILE *out_file)
       if (psymtab == NULL)
 	continue;
 
-      if (psymtab->user == NULL)
-	recursively_write_psymbols (objfile, psymtab, &symtab,
-				    psyms_seen, i);
-
       const auto insertpair = cu_index_htab.emplace (psymtab, i);
       gdb_assert (insertpair.second);
 
@@ -1341,19 +1440,28 @@ write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile, FILE *out_file)
   write_address_map (objfile, addr_vec, cu_index_htab);
 
   /* Write out the .debug_type entries, if any.  */
+  std::vector<index_unit> units = index_compile_units (dwarf2_per_objfile);
   data_buf types_cu_list;
-  if (dwarf2_per_objfile->signatured_types)
+  offset_type cu_index = dwarf2_per_objfile->all_comp_units.size ();
+  for (signatured_type *entry : index_type_units (dwarf2_per_objfile))
     {
-      signatured_type_index_data sig_data (types_cu_list,
-					   psyms_seen);
-
-      sig_data.objfile = objfile;
-      sig_data.symtab = &symtab;
-      sig_data.cu_index = dwarf2_per_objfile->all_comp_units.size ();
-      htab_traverse_noresize (dwarf2_per_objfile->signatured_types,
-			      write_one_signatured_type, &sig_data);
+      units.push_back ({ entry->per_cu.v.psymtab, cu_index++, true });
+
+      types_cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
+				 to_underlying (entry->per_cu.sect_off));
+      types_cu_list.append_uint (8, BFD_ENDIAN_LITTLE,
+				 to_underlying (entry->type_offset_in_tu));
+      types_cu_list.append_uint (8, BFD_ENDIAN_LITTLE, entry->signature);
     }
 
+  /* Add the symbols of all the units to the symbol table, in
+     order.  */
+  for (const auto &shard : collect_index_psyms (objfile, units, true))
+    for (const index_psym &psym : shard)
+      add_index_entry (&symtab, symbol_search_name (psym.psym), psym.hash,
+		       psym.is_static, symbol_kind (psym.psym),
+		       psym.cu_index);
+
   /* Now that we've processed all symbols we can shrink their cu_indices
      lists.  */
   uniquify_cu_indices (&symtab);
@@ -1390,14 +1498,15 @@ write_gdbindex (struct dwarf2_per_objfile *dwarf2_per_objfile, FILE *out_file)
 
   gdb_assert (contents.size () == size_of_contents);
 
-  contents.file_write (out_file);
-  cu_list.file_write (out_file);
-  types_cu_list.file_write (out_file);
-  addr_vec.file_write (out_file);
-  symtab_vec.file_write (out_file);
-  constant_pool.file_write (out_file);
+  out->reserve (total_len);
+  contents.append_to (out);
+  cu_list.append_to (out);
+  types_cu_list.append_to (out);
+  addr_vec.append_to (out);
+  symtab_vec.append_to (out);
+  constant_pool.append_to (out);
 
-  return total_len;
+  gdb_assert (out->size () == total_len);
 }
 
 /* DWARF-5 augmentation string for GDB's DW_IDX_GNU_* extension.  */
@@ -1422,8 +1531,6 @@ write_debug_names (struct dwarf2_per_objfile *dwarf2_per_objfile,
   data_buf cu_list;
   debug_names nametable (dwarf2_per_objfile, dwarf5_is_dwarf64,
 			 dwarf5_byte_order);
-  std::unordered_set<partial_symbol *>
-    psyms_seen (psyms_seen_size (dwarf2_per_objfile));
   for (int i = 0; i < dwarf2_per_objfile->all_comp_units.size (); ++i)
     {
       const dwarf2_per_cu_data *per_cu = dwarf2_per_objfile->all_comp_units[i];
@@ -1435,29 +1542,30 @@ write_debug_names (struct dwarf2_per_objfile *dwarf2_per_objfile,
       if (psymtab == NULL)
 	continue;
 
-      if (psymtab->user == NULL)
-	nametable.recursively_write_psymbols (objfile, psymtab, psyms_seen, i);
-
       cu_list.append_uint (nametable.dwarf5_offset_size (), dwarf5_byte_order,
 			   to_underlying (per_cu->sect_off));
     }
 
   /* Write out the .debug_type entries, if any.  */
+  std::vector<index_unit> units = index_compile_units (dwarf2_per_objfile);
   data_buf types_cu_list;
-  if (dwarf2_per_objfile->signatured_types)
+  offset_type tu_index = 0;
+  for (signatured_type *entry : index_type_units (dwarf2_per_objfile))
     {
-      debug_names::write_one_signatured_type_data sig_data (nametable,
-			signatured_type_index_data (types_cu_list, psyms_seen));
-
-      sig_data.info.objfile = objfile;
-      /* It is used only for gdb_index.  */
-      sig_data.info.symtab = nullptr;
-      sig_data.info.cu_index = 0;
-      htab_traverse_noresize (dwarf2_per_objfile->signatured_types,
-			      debug_names::write_one_signatured_type,
-			      &sig_data);
+      units.push_back ({ entry->per_cu.v.psymtab, tu_index++, true });
+
+      types_cu_list.append_uint (nametable.dwarf5_offset_size (),
+				 dwarf5_byte_order,
+				 to_underlying (entry->per_cu.sect_off));
     }
 
+  for (const auto &shard : collect_index_psyms (objfile, units, false))
+    for (const index_psym &psym : shard)
+      nametable.insert (psym.psym, psym.cu_index, psym.is_static,
+			(psym.is_tu
+			 ? debug_names::unit_kind::tu
+			 : debug_names::unit_kind::cu));
+
   nametable.build ();
 
   /* No addr_vec - DWARF-5 uses .debug_aranges generated by GCC.  */
@@ -1543,12 +1651,11 @@ assert_file_size (FILE *file, const char *filename, size_t expected_size)
   gdb_assert (file_size == expected_size);
 }
 
-/* See dwarf-index-write.h.  */
+/* Throw an error if no index can be made for DWARF2_PER_OBJFILE.
+   Return false if there is nothing to index.  */
 
-void
-write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
-			 const char *dir, const char *basename,
-			 dw_index_kind index_kind)
+static bool
+check_can_write_index (struct dwarf2_per_objfile *dwarf2_per_objfile)
 {
   struct objfile *objfile = dwarf2_per_objfile->objfile;
 
@@ -1558,8 +1665,32 @@ write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
   if (VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types) > 1)
     error (_("Cannot make an index when the file has multiple .debug_types sections"));
 
-  if (!objfile->partial_symtabs->psymtabs
-      || !objfile->partial_symtabs->psymtabs_addrmap)
+  return (objfile->partial_symtabs->psymtabs != NULL
+	  && objfile->partial_symtabs->psymtabs_addrmap != NULL);
+}
+
+/* See dwarf-index-write.h.  */
+
+gdb::byte_vector
+build_gdb_index (struct dwarf2_per_objfile *dwarf2_per_objfile)
+{
+  gdb::byte_vector contents;
+
+  if (check_can_write_index (dwarf2_per_objfile))
+    write_gdbindex (dwarf2_per_objfile, &contents);
+  return contents;
+}
+
+/* See dwarf-index-write.h.  */
+
+void
+write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
+			 const char *dir, const char *basename,
+			 dw_index_kind index_kind)
+{
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+
+  if (!check_can_write_index (dwarf2_per_objfile))
     return;
 
   struct stat st;
@@ -1622,9 +1753,12 @@ write_psymtabs_to_index (struct dwarf2_per_objfile *dwarf2_per_objfile,
     }
   else
     {
-      const size_t total_len
-	= write_gdbindex (dwarf2_per_objfile, out_file.get ());
-      assert_file_size (out_file.get (), filename_temp.data (), total_len);
+      gdb::byte_vector contents;
+
+      write_gdbindex (dwarf2_per_objfile, &contents);
+      file_write (out_file.get (), contents);
+      assert_file_size (out_file.get (), filename_temp.data (),
+			contents.size ());
     }
 
   /* We want to keep the file.  */
@@ -22,6 +22,7 @@
 
 #include "symfile.h"
 #include "dwarf2read.h"
+#include "common/byte-vector.h"
 
 /* Create an index file for OBJFILE in the directory DIR.  BASENAME is the
    desired filename, minus the extension, which gets added by this function
@@ -31,4 +32,11 @@ extern void write_psymtabs_to_index
   (struct dwarf2_per_objfile *dwarf2_per_objfile, const char *dir,
    const char *basename, dw_index_kind index_kind);
 
+/* Build the contents of a .gdb_index file for OBJFILE in memory.
+   Return an empty vector if OBJFILE has nothing to index.  Throws an
+   error if an index can't be made for it.  */
+
+extern gdb::byte_vector build_gdb_index
+  (struct dwarf2_per_objfile *dwarf2_per_objfile);
+
 #endif /* DWARF_INDEX_WRITE_H */
@@ -2491,6 +2491,20 @@ dwarf2_section_empty_p (const struct dwarf2_section_info *section)
   return section->s.section == NULL || section->size == 0;
 }
 
+/* Start decompressing SECTION on a worker thread if it is compressed,
+   so that it is ready sooner when dwarf2_read_section needs it.  */
+
+static void
+dwarf2_prefetch_section (struct dwarf2_section_info *section)
+{
+  if (section->readin
+      || section->is_virtual
+      || dwarf2_section_empty_p (section))
+    return;
+
+  gdb_bfd_prefetch_section (get_section_bfd_section (section));
+}
+
 /* See dwarf2read.h.  */
 
 void
@@ -2905,10 +2919,15 @@ dw2_do_instantiate_symtab (struct dwarf2_per_cu_data *per_cu, bool skip_partial)
      with the dwarf queue empty.  */
   dwarf2_queue_guard q_guard;
 
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+  auto start = std::chrono::steady_clock::now ();
+  bool expanded = false;
+
   if (dwarf2_per_objfile->using_index
       ? per_cu->v.quick->compunit_symtab == NULL
       : (per_cu->v.psymtab == NULL || !per_cu->v.psymtab->readin))
     {
+      expanded = true;
       queue_comp_unit (per_cu, language_minimal);
       load_cu (per_cu, skip_partial);
 
@@ -2930,6 +2949,11 @@ dw2_do_instantiate_symtab (struct dwarf2_per_cu_data *per_cu, bool skip_partial)
   /* Age the cache, releasing compilation units that have not
      been used recently.  */
   age_cached_comp_units (dwarf2_per_objfile);
+
+  /* Only charge the time to expansion if something was expanded.  */
+  if (expanded)
+    OBJSTAT (objfile, expansion_time
+		      += std::chrono::steady_clock::now () - start);
 }
 
 /* Ensure that the symbols for PER_CU have been read in.  OBJFILE is
@@ -5055,6 +5079,9 @@ dw2_expand_symtabs_matching_one
       bool symtab_was_null
 	= (per_cu->v.quick->compunit_symtab == NULL);
 
+      if (symtab_was_null && symtab_expansion_budget_exhausted ())
+	return;
+
       dw2_instantiate_symtab (per_cu, false);
 
       if (expansion_notify != NULL
@@ -8498,6 +8525,19 @@ dwarf2_build_psymtabs_hard (struct dwarf2_per_objfile *dwarf2_per_objfile)
 
   dwarf2_read_section (objfile, &dwarf2_per_objfile->info);
 
+  /* Decompress the other sections while .debug_info is scanned.  This
+     is only started now so that the pieces of .debug_info, which is
+     needed first, don't wait behind them for a worker thread.  */
+  dwarf2_prefetch_section (&dwarf2_per_objfile->abbrev);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->str);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->line);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->line_str);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->ranges);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->rnglists);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->addr);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->loc);
+  dwarf2_prefetch_section (&dwarf2_per_objfile->loclists);
+
   /* Any cached compilation units will be linked by the per-objfile
      read_in_chain.  Make sure to free them when we're done.  */
   free_cached_comp_units freer (dwarf2_per_objfile);
@@ -10365,6 +10405,8 @@ process_full_comp_unit (struct dwarf2_per_cu_data *per_cu,
 
   baseaddr = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
 
+  record_symtab_expansion (objfile, per_cu->length);
+
   /* Clear the list here in case something was left over.  */
   cu->method_list.clear ();
 
@@ -10469,6 +10511,8 @@ process_full_type_unit (struct dwarf2_per_cu_data *per_cu,
   gdb_assert (per_cu->is_debug_types);
   sig_type = (struct signatured_type *) per_cu;
 
+  record_symtab_expansion (objfile, per_cu->length);
+
   /* Clear the list here in case something was left over.  */
   cu->method_list.clear ();
 
@@ -48,6 +48,8 @@
 #include "location.h"
 #include "auxv.h"
 #include "mdebugread.h"
+#include "dwarf-index-cache.h"
+#include "common/version.h"
 
 /* Forward declarations.  */
 extern const struct sym_fns elf_sym_fns_gdb_index;
@@ -1025,6 +1027,34 @@ elf_gnu_ifunc_resolver_return_stop (struct breakpoint *b)
 			       {});
 }
 
+/* Return the key under which the index cache keeps the minimal symbols
+   of OBJFILE, or the empty string if they must always be read from
+   the file.  The key identifies everything elf_read_minimal_symbols
+   reads them from, beyond the build id.  */
+
+static std::string
+elf_minsym_cache_key (struct objfile *objfile, const struct elfinfo *ei)
+{
+  struct gdbarch *gdbarch = get_objfile_arch (objfile);
+  bfd *abfd = objfile->obfd;
+
+  /* The stabs and mdebug readers need more than the minimal symbols,
+     and special symbols are recorded elsewhere.  */
+  if (!global_index_cache.enabled ()
+      || ei->stabsect != NULL
+      || ei->mdebugsect != NULL
+      || gdbarch_record_special_symbol_p (gdbarch))
+    return std::string ();
+
+  return string_printf ("%s %s %s %s %s %ld %ld %d", version, host_name,
+			gdbarch_bfd_arch_info (gdbarch)->printable_name,
+			bfd_get_target (abfd),
+			pulongest (bfd_get_size (abfd)),
+			bfd_get_symtab_upper_bound (abfd),
+			bfd_get_dynamic_symtab_upper_bound (abfd),
+			objfile->separate_debug_objfile_backlink != NULL);
+}
+
 /* A helper function for elf_symfile_read that reads the minimal
    symbols.  */
 
@@ -1060,6 +1090,20 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
       return;
     }
 
+  /* A binary read before may have its installed minimal symbols in
+     the index cache, which saves reading, sorting and demangling
+     them.  */
+  std::string cache_key = elf_minsym_cache_key (objfile, ei);
+  if (!cache_key.empty ()
+      && objfile->per_bfd->minimal_symbol_count == 0
+      && global_index_cache.lookup_minsyms (objfile, cache_key))
+    {
+      if (symtab_create_debug)
+	fprintf_unfiltered (gdb_stdlog,
+			    "... minimal symbols read from the index cache\n");
+      return;
+    }
+
   minimal_symbol_reader reader (objfile);
 
   /* Allocate struct to keep track of the symfile.  */
@@ -1164,6 +1208,9 @@ elf_read_minimal_symbols (struct objfile *objfile, int symfile_flags,
 
   reader.install ();
 
+  if (!cache_key.empty ())
+    global_index_cache.store_minsyms (objfile, cache_key);
+
   if (symtab_create_debug)
     fprintf_unfiltered (gdb_stdlog, "Done reading minimal symbols.\n");
 }
@@ -50,18 +50,22 @@ put_bits (bfd_uint64_t data, gdb::byte_vector &buf, int bits, bfd_boolean big_p)
 }
 
 /* Subroutine of find_command to simplify it.
-   Parse the arguments of the "find" command.  */
+   Parse the arguments of the "find" command.  Return the search
+   patterns: a single one, unless the /m modifier asks for each
+   expression to be a pattern of its own, in which case *MULTIP is
+   set.  */
 
-static gdb::byte_vector
+static std::vector<gdb::byte_vector>
 parse_find_args (const char *args, ULONGEST *max_countp,
 		 CORE_ADDR *start_addrp, ULONGEST *search_space_lenp,
-		 bfd_boolean big_p)
+		 bool *multip, bfd_boolean big_p)
 {
   /* Default to using the specified type.  */
   char size = '\0';
   ULONGEST max_count = ~(ULONGEST) 0;
-  /* Buffer to hold the search pattern.  */
-  gdb::byte_vector pattern_buf;
+  bool multi = false;
+  /* Buffers to hold the search patterns.  */
+  std::vector<gdb::byte_vector> patterns;
   CORE_ADDR start_addr;
   ULONGEST search_space_len;
   const char *s = args;
@@ -95,6 +99,10 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 	    case 'g':
 	      size = *s++;
 	      break;
+	    case 'm':
+	      multi = true;
+	      ++s;
+	      break;
 	    default:
 	      error (_("Invalid size granularity."));
 	    }
@@ -122,7 +130,7 @@ parse_find_args (const char *args, ULONGEST *max_countp,
       if (len == 0)
 	{
 	  printf_filtered (_("Empty search range.\n"));
-	  return pattern_buf;
+	  return patterns;
 	}
       if (len < 0)
 	error (_("Invalid length."));
@@ -161,6 +169,10 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 
       s = skip_spaces (s);
 
+      if (patterns.empty () || multi)
+	patterns.emplace_back ();
+      gdb::byte_vector &pattern_buf = patterns.back ();
+
       v = parse_to_comma_and_eval (&s);
       t = value_type (v);
 
@@ -195,17 +207,19 @@ parse_find_args (const char *args, ULONGEST *max_countp,
       s = skip_spaces (s);
     }
 
-  if (pattern_buf.empty ())
+  if (patterns.empty ())
     error (_("Missing search pattern."));
 
-  if (search_space_len < pattern_buf.size ())
-    error (_("Search space too small to contain pattern."));
+  for (const gdb::byte_vector &pattern_buf : patterns)
+    if (search_space_len < pattern_buf.size ())
+      error (_("Search space too small to contain pattern."));
 
   *max_countp = max_count;
   *start_addrp = start_addr;
   *search_space_lenp = search_space_len;
+  *multip = multi;
 
-  return pattern_buf;
+  return patterns;
 }
 
 static void
@@ -218,21 +232,43 @@ find_command (const char *args, int from_tty)
   ULONGEST max_count = 0;
   CORE_ADDR start_addr = 0;
   ULONGEST search_space_len = 0;
+  bool multi = false;
   /* End of command line parameters.  */
   unsigned int found_count;
   CORE_ADDR last_found_addr;
 
-  gdb::byte_vector pattern_buf = parse_find_args (args, &max_count,
-						  &start_addr,
-						  &search_space_len,
-						  big_p);
+  std::vector<gdb::byte_vector> patterns
+    = parse_find_args (args, &max_count, &start_addr, &search_space_len,
+		       &multi, big_p);
 
   /* Perform the search.  */
 
   found_count = 0;
   last_found_addr = 0;
 
-  while (search_space_len >= pattern_buf.size ()
+  if (multi)
+    {
+      /* Look for all the patterns in a single pass over memory.  */
+      search_memory_multi (start_addr, search_space_len, patterns,
+			   [&] (CORE_ADDR found_addr, size_t pattern)
+	{
+	  if (found_count >= max_count)
+	    return false;
+
+	  print_address (gdbarch, found_addr, gdb_stdout);
+	  printf_filtered (_(": pattern %s\n"), pulongest (pattern + 1));
+	  ++found_count;
+	  last_found_addr = found_addr;
+	  return true;
+	});
+    }
+
+  gdb::byte_vector pattern_buf;
+  if (!patterns.empty ())
+    pattern_buf = std::move (patterns[0]);
+
+  while (!multi
+	 && search_space_len >= pattern_buf.size ()
 	 && found_count < max_count)
     {
       /* Offset from start of this iteration to the next iteration.  */
@@ -286,8 +322,8 @@ _initialize_mem_search (void)
   add_cmd ("find", class_vars, find_command, _("\
 Search memory for a sequence of bytes.\n\
 Usage:\nfind \
-[/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
-find [/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
+[/SIZE-CHAR] [/MAX-COUNT] [/m] START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
+find [/SIZE-CHAR] [/MAX-COUNT] [/m] START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
 SIZE-CHAR is one of b,h,w,g for 8,16,32,64 bit values respectively,\n\
 and if not specified the size is taken from the type of the expression\n\
 in the current language.\n\
@@ -297,6 +333,10 @@ which is typically four bytes, and a search for a string \"hello\" will\n\
 include the trailing '\\0'.  The null terminator can be removed from\n\
 searching by using casts, e.g.: {char[5]}\"hello\".\n\
 \n\
+With /m, each expression is a pattern of its own, and all the matches\n\
+of all the patterns are found in a single pass over memory.  Each match\n\
+is shown with the number of its pattern.\n\
+\n\
 The address of the last match is stored as the value of \"$_\".\n\
 Convenience variable \"$numfound\" is set to the number of matches."),
 	   &cmdlist);
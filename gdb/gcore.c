@@ -29,6 +29,7 @@
 #include "completer.h"
 #include "gcore.h"
 #include "cli/cli-decode.h"
+#include "gdbcmd.h"
 #include <fcntl.h>
 #include "regcache.h"
 #include "regset.h"
@@ -38,16 +39,38 @@
 #include "common/gdb_unlinker.h"
 #include "common/byte-vector.h"
 #include "common/scope-exit.h"
+#include "common/scoped_fd.h"
+#include "common/filestuff.h"
+#include "common/thread-pool.h"
+#include "compressed-core.h"
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+#ifndef O_LARGEFILE
+#define O_LARGEFILE 0
+#endif
+
+/* A memory region of the core file whose contents are written after
+   BFD has finished writing the file.  */
+
+struct gcore_region
+{
+  CORE_ADDR vma;
+  ULONGEST size;
+};
+
+/* Whether "gcore" writes compressed core files.  */
+static int gcore_compression = 0;
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
-static int gcore_memory_sections (bfd *);
+static int gcore_memory_sections (bfd *, std::vector<gcore_region> *);
+static void write_compressed_gcore_file (gdb_bfd_ref_ptr obfd,
+					 const char *filename);
 
 /* create_gcore_bfd -- helper for gcore_command (exported).
    Open a new bfd core file for output, and return the handle.  */
@@ -64,10 +87,12 @@ create_gcore_bfd (const char *filename)
   return obfd;
 }
 
-/* write_gcore_file_1 -- do the actual work of write_gcore_file.  */
+/* write_gcore_file_1 -- do the actual work of write_gcore_file.  If
+   DEFERRED is not NULL, the contents of the memory sections are not
+   written; the regions they cover are stored in DEFERRED instead.  */
 
 static void
-write_gcore_file_1 (bfd *obfd)
+write_gcore_file_1 (bfd *obfd, std::vector<gcore_region> *deferred)
 {
   gdb::unique_xmalloc_ptr<char> note_data;
   int note_size = 0;
@@ -100,7 +125,7 @@ write_gcore_file_1 (bfd *obfd)
   bfd_set_section_size (obfd, note_sec, note_size);
 
   /* Now create the memory/load sections.  */
-  if (gcore_memory_sections (obfd) == 0)
+  if (gcore_memory_sections (obfd, deferred) == 0)
     error (_("gcore: failed to get corefile memory sections from target."));
 
   /* Write out the contents of the note section.  */
@@ -117,7 +142,7 @@ write_gcore_file (bfd *obfd)
 {
   target_prepare_to_generate_core ();
   SCOPE_EXIT { target_done_generating_core (); };
-  write_gcore_file_1 (obfd);
+  write_gcore_file_1 (obfd, NULL);
 }
 
 /* gcore_command -- implements the 'gcore' command.
@@ -152,7 +177,10 @@ gcore_command (const char *args, int from_tty)
   gdb::unlinker unlink_file (corefilename.get ());
 
   /* Call worker function.  */
-  write_gcore_file (obfd.get ());
+  if (gcore_compression)
+    write_compressed_gcore_file (std::move (obfd), corefilename.get ());
+  else
+    write_gcore_file (obfd.get ());
 
   /* Succeeded.  */
   unlink_file.keep ();
@@ -527,52 +555,366 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* The granularity at which gcore looks for all-zero memory, which it
+   leaves as holes in the core file, and at which it retries reads
+   that failed.  */
+#define GCORE_PAGE_SIZE 4096
+
+/* Only report progress for cores at least this large.  */
+#define GCORE_PROGRESS_MIN_BYTES (256 * 1024 * 1024)
+
+/* State shared by the calls to gcore_copy_section.  */
+
+struct gcore_copy_state
+{
+  /* The core file being written.  */
+  bfd *obfd = NULL;
+
+  /* A second descriptor for the core file, used to write section
+     contents from a worker thread while the main thread reads the
+     next chunk of memory.  BFD is not thread-safe, so only the main
+     thread may use OBFD itself.  -1 if the writes go through BFD on
+     the main thread.  */
+  int fd = -1;
+
+  /* The two buffers memory is read into.  One is being filled by the
+     main thread while the other is being written out.  */
+  gdb::byte_vector buffers[2];
+
+  /* Completion of the write of the last chunk, if it is in
+     flight.  */
+  std::future<void> pending;
+
+  /* Set by the writer if writing a chunk failed.  */
+  std::string write_error;
+
+  /* Total size of the memory sections, and how much of it has been
+     copied so far.  */
+  ULONGEST total = 0;
+  ULONGEST copied = 0;
+
+  /* The next percentage at which to report progress, or -1 if
+     progress is not reported.  */
+  int next_report = -1;
+};
+
+/* Return true if the SIZE bytes at BUF are all zero.  */
+
+static bool
+gcore_all_zero_p (const gdb_byte *buf, size_t size)
+{
+  return buf[0] == 0 && memcmp (buf, buf + 1, size - 1) == 0;
+}
+
+/* Write the SIZE bytes at BUF to offset OFFSET of section OSEC of the
+   core file described by STATE.  Return false and set
+   STATE->write_error on failure.  */
+
+static bool
+gcore_write_run (gcore_copy_state *state, asection *osec,
+		 const gdb_byte *buf, file_ptr offset, bfd_size_type size)
+{
+  if (state->fd == -1)
+    {
+      if (!bfd_set_section_contents (state->obfd, osec, buf, offset, size))
+	{
+	  state->write_error = bfd_errmsg (bfd_get_error ());
+	  return false;
+	}
+      return true;
+    }
+
+  if (lseek (state->fd, osec->filepos + offset, SEEK_SET) == -1)
+    {
+      state->write_error = safe_strerror (errno);
+      return false;
+    }
+
+  while (size > 0)
+    {
+      ssize_t n = write (state->fd, buf, size);
+
+      if (n == -1 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	{
+	  state->write_error = safe_strerror (n == 0 ? ENOSPC : errno);
+	  return false;
+	}
+      buf += n;
+      size -= n;
+    }
+
+  return true;
+}
+
+/* Write a chunk of SIZE bytes at BUF to offset OFFSET of section OSEC.
+   All-zero pages are skipped, leaving holes in the file; if the chunk
+   ends the section, its last byte is always written so that the file
+   covers the whole section.  This may run on a worker thread.  */
+
 static void
-gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
+gcore_write_chunk (gcore_copy_state *state, asection *osec,
+		   const gdb_byte *buf, file_ptr offset, bfd_size_type size)
 {
-  bfd_size_type size, total_size = bfd_section_size (obfd, osec);
-  file_ptr offset = 0;
+  bool last = offset + size == bfd_get_section_size (osec);
+  bfd_size_type run_start = 0;
+  bfd_size_type pos;
+
+  for (pos = 0; pos < size; pos += GCORE_PAGE_SIZE)
+    {
+      bfd_size_type len = std::min (size - pos,
+				    (bfd_size_type) GCORE_PAGE_SIZE);
+
+      if (!gcore_all_zero_p (buf + pos, len))
+	continue;
+
+      if (pos > run_start
+	  && !gcore_write_run (state, osec, buf + run_start,
+			       offset + run_start, pos - run_start))
+	return;
+      run_start = pos + len;
+    }
+
+  if (run_start < size)
+    gcore_write_run (state, osec, buf + run_start, offset + run_start,
+		     size - run_start);
+  else if (last)
+    gcore_write_run (state, osec, buf + size - 1, offset + size - 1, 1);
+}
+
+/* Wait for the write in flight in STATE, if any, to complete.  Return
+   false if it failed.  */
+
+static bool
+gcore_wait_pending (gcore_copy_state *state)
+{
+  if (state->pending.valid ())
+    state->pending.get ();
+
+  return state->write_error.empty ();
+}
+
+/* Read SIZE bytes of target memory at ADDR into BUF.  If that fails,
+   retry page by page, and fill the pages that can't be read with
+   zeros.  Return the number of bytes that could not be read.  */
 
-  /* Read-only sections are marked; we don't have to copy their contents.  */
-  if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
+static ULONGEST
+gcore_read_chunk (CORE_ADDR addr, gdb_byte *buf, ULONGEST size)
+{
+  ULONGEST failed = 0;
+
+  if (target_read_memory (addr, buf, size) == 0)
+    return 0;
+
+  for (ULONGEST pos = 0; pos < size; )
+    {
+      ULONGEST len = std::min (size - pos,
+			       GCORE_PAGE_SIZE
+			       - (addr + pos) % GCORE_PAGE_SIZE);
+
+      if (target_read_memory (addr + pos, buf + pos, len) != 0)
+	{
+	  memset (buf + pos, 0, len);
+	  failed += len;
+	}
+      pos += len;
+    }
+
+  return failed;
+}
+
+/* Report the progress of STATE, if due.  */
+
+static void
+gcore_report_progress (gcore_copy_state *state)
+{
+  if (state->next_report < 0)
     return;
 
-  /* Only interested in "load" sections.  */
-  if (!startswith (bfd_section_name (obfd, osec), "load"))
+  int percent = state->copied * 100 / state->total;
+
+  if (percent < state->next_report)
     return;
 
+  printf_filtered (_("Saved %s of %s MiB of memory (%d%%).\n"),
+		   pulongest (state->copied >> 20),
+		   pulongest (state->total >> 20), percent);
+  gdb_flush (gdb_stdout);
+  state->next_report = (percent / 10 + 1) * 10;
+}
+
+/* Copy the contents of the memory section OSEC of the core file.  */
+
+static void
+gcore_copy_section (gcore_copy_state *state, asection *osec)
+{
+  bfd_size_type size, total_size = bfd_section_size (state->obfd, osec);
+  CORE_ADDR vma = bfd_section_vma (state->obfd, osec);
+  file_ptr offset = 0;
+  ULONGEST unreadable = 0;
+  int which = 0;
+
   size = std::min (total_size, (bfd_size_type) MAX_COPY_BYTES);
-  gdb::byte_vector memhunk (size);
 
   while (total_size > 0)
     {
+      QUIT;
+
       if (size > total_size)
 	size = total_size;
 
-      if (target_read_memory (bfd_section_vma (obfd, osec) + offset,
-			      memhunk.data (), size) != 0)
+      /* The buffer not being written out is free to be read into.  */
+      gdb::byte_vector &buf = state->buffers[which];
+      unreadable += gcore_read_chunk (vma + offset, buf.data (), size);
+
+      if (!gcore_wait_pending (state))
+	break;
+
+      if (state->fd != -1)
+	state->pending
+	  = gdb::thread_pool::g_thread_pool->post_task ([=, &buf] ()
+	    {
+	      gcore_write_chunk (state, osec, buf.data (), offset, size);
+	    });
+      else
+	gcore_write_chunk (state, osec, buf.data (), offset, size);
+      which = !which;
+
+      total_size -= size;
+      offset += size;
+      state->copied += size;
+      gcore_report_progress (state);
+    }
+
+  if (unreadable != 0)
+    warning (_("Memory read failed for corefile section, %s bytes "
+	       "at %s; saved them as zeros."),
+	     pulongest (unreadable), paddress (target_gdbarch (), vma));
+}
+
+/* Copy the contents of all the memory sections of OBFD.  */
+
+static void
+gcore_copy_memory (bfd *obfd)
+{
+  gcore_copy_state state;
+  asection *osec;
+
+  state.obfd = obfd;
+  for (osec = obfd->sections; osec != NULL; osec = osec->next)
+    if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) != 0
+	&& startswith (bfd_section_name (obfd, osec), "load"))
+      state.total += bfd_section_size (obfd, osec);
+
+  if (state.total == 0)
+    return;
+  if (state.total >= GCORE_PROGRESS_MIN_BYTES)
+    state.next_report = 10;
+
+  for (gdb::byte_vector &buf : state.buffers)
+    buf.resize (std::min (state.total, (ULONGEST) MAX_COPY_BYTES));
+
+  /* If there is a worker thread, write the section contents directly
+     from it.  Writing nothing makes BFD lay out the file, which is all
+     that is needed to know where they go.  */
+  scoped_fd fd;
+  if (gdb::thread_pool::g_thread_pool->thread_count () > 0
+      && bfd_set_section_contents (obfd, obfd->sections,
+				   state.buffers[0].data (), 0, 0))
+    {
+      fd = scoped_fd (gdb_open_cloexec (bfd_get_filename (obfd),
+					O_WRONLY | O_BINARY | O_LARGEFILE,
+					0));
+      state.fd = fd.get ();
+    }
+
+  /* The worker may still use STATE; wait for it even on error.  */
+  SCOPE_EXIT { gcore_wait_pending (&state); };
+
+  for (osec = obfd->sections; osec != NULL; osec = osec->next)
+    {
+      /* Read-only sections are marked; we don't have to copy their
+	 contents.  */
+      if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
+	continue;
+
+      /* Only interested in "load" sections.  */
+      if (!startswith (bfd_section_name (obfd, osec), "load"))
+	continue;
+
+      gcore_copy_section (&state, osec);
+      if (!gcore_wait_pending (&state))
 	{
-	  warning (_("Memory read failed for corefile "
-		     "section, %s bytes at %s."),
-		   plongest (size),
-		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
+	  warning (_("Failed to write corefile contents (%s)."),
+		   state.write_error.c_str ());
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk.data (),
-				     offset, size))
+    }
+}
+
+/* Like write_gcore_file, but let BFD write the core file OBFD, named
+   FILENAME, without the contents of its memory sections, then append
+   them compressed (see compressed-core.h).  Memory is read in chunks
+   by the main thread, and compressed by worker threads.  */
+
+static void
+write_compressed_gcore_file (gdb_bfd_ref_ptr obfd, const char *filename)
+{
+  std::vector<gcore_region> regions;
+  gcore_copy_state progress;
+
+  target_prepare_to_generate_core ();
+  SCOPE_EXIT { target_done_generating_core (); };
+
+  write_gcore_file_1 (obfd.get (), &regions);
+
+  /* Closing the BFD writes out the headers and completes the file.  */
+  obfd.reset (NULL);
+
+  for (const gcore_region &region : regions)
+    progress.total += region.size;
+  if (progress.total >= GCORE_PROGRESS_MIN_BYTES)
+    progress.next_report = 10;
+
+  compressed_core_writer writer (filename);
+
+  for (const gcore_region &region : regions)
+    {
+      ULONGEST unreadable = 0;
+
+      for (ULONGEST offset = 0; offset < region.size; )
 	{
-	  warning (_("Failed to write corefile contents (%s)."),
-		   bfd_errmsg (bfd_get_error ()));
-	  break;
+	  QUIT;
+
+	  ULONGEST size = std::min (region.size - offset,
+				    (ULONGEST) COMPRESSED_CORE_CHUNK_SIZE);
+	  gdb::byte_vector buf (size);
+
+	  unreadable += gcore_read_chunk (region.vma + offset, buf.data (),
+					  size);
+	  writer.add_chunk (region.vma + offset, std::move (buf));
+
+	  offset += size;
+	  progress.copied += size;
+	  gcore_report_progress (&progress);
 	}
 
-      total_size -= size;
-      offset += size;
+      if (unreadable != 0)
+	warning (_("Memory read failed for corefile section, %s bytes "
+		   "at %s; saved them as zeros."),
+		 pulongest (unreadable),
+		 paddress (target_gdbarch (), region.vma));
     }
+
+  writer.finish ();
 }
 
+/* Create the memory sections of OBFD and copy their contents, or
+   store the regions they cover in DEFERRED if it is not NULL.  */
+
 static int
-gcore_memory_sections (bfd *obfd)
+gcore_memory_sections (bfd *obfd, std::vector<gcore_region> *deferred)
 {
   /* Try gdbarch method first, then fall back to target method.  */
   if (!gdbarch_find_memory_regions_p (target_gdbarch ())
@@ -586,12 +928,43 @@ gcore_memory_sections (bfd *obfd)
   /* Record phdrs for section-to-segment mapping.  */
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
+  if (deferred != NULL)
+    {
+      asection *osec;
+
+      /* Leave the contents out of the file BFD writes; the sections'
+	 segments then get a zero file size.  */
+      for (osec = obfd->sections; osec != NULL; osec = osec->next)
+	{
+	  flagword flags = bfd_get_section_flags (obfd, osec);
+
+	  if ((flags & SEC_LOAD) == 0
+	      || !startswith (bfd_section_name (obfd, osec), "load"))
+	    continue;
+
+	  deferred->push_back ({bfd_section_vma (obfd, osec),
+				bfd_section_size (obfd, osec)});
+	  bfd_set_section_flags (obfd, osec,
+				 flags & ~(SEC_LOAD | SEC_HAS_CONTENTS));
+	}
+    }
+
   /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  gcore_copy_memory (obfd);
 
   return 1;
 }
 
+/* Implement "show gcore-compression".  */
+
+static void
+show_gcore_compression (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Compression of core files written by gcore "
+			    "is %s.\n"), value);
+}
+
 void
 _initialize_gcore (void)
 {
@@ -601,4 +974,14 @@ Usage: generate-core-file [FILENAME]\n\
 Argument is optional filename.  Default filename is 'core.PROCESS_ID'."));
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
+
+  add_setshow_boolean_cmd ("gcore-compression", class_files,
+			   &gcore_compression, _("\
+Set whether gcore writes compressed core files."), _("\
+Show whether gcore writes compressed core files."), _("\
+When on, the memory contents of the core files written by gcore are\n\
+compressed as they are saved.  GDB reads such core files directly;\n\
+other tools see core files whose memory was not dumped."),
+			   NULL, show_gcore_compression,
+			   &setlist, &showlist);
 }
@@ -24,6 +24,10 @@
 #include "hashtab.h"
 #include "common/filestuff.h"
 #include "common/vec.h"
+#include "common/byte-vector.h"
+#include "common/thread-pool.h"
+#include "common/scope-exit.h"
+#include "common/selftest.h"
 #ifndef __sparc__
 #ifdef HAVE_MMAP
 #include <sys/mman.h>
@@ -35,6 +39,24 @@
 #include "target.h"
 #include "gdb/fileio.h"
 #include "inferior.h"
+#include "dwarf-index-cache.h"
+#include <zlib.h>
+
+/* The decompressed contents of a compressed section being prefetched
+   by a worker thread, see gdb_bfd_prefetch_section.  */
+
+struct gdb_bfd_pending_section
+{
+  /* The compressed contents, read by the main thread.  */
+  gdb::byte_vector compressed;
+  /* The offset of the zlib stream in COMPRESSED.  */
+  size_t offset = 0;
+  /* The decompressed contents, allocated with malloc, or NULL if they
+     could not be decompressed.  */
+  gdb_byte *data = nullptr;
+  /* Completion of the worker thread task.  */
+  std::future<void> done;
+};
 
 /* An object of this type is stored in the section's user data when
    mapping a section.  */
@@ -49,6 +71,8 @@ struct gdb_bfd_section_data
   void *data;
   /* If the data was mmapped, this is the map address.  */
   void *map_addr;
+  /* If a worker thread is decompressing the section, its state.  */
+  struct gdb_bfd_pending_section *pending;
 };
 
 /* A hash table holding every BFD that gdb knows about.  This is not
@@ -484,6 +508,15 @@ free_one_bfd_section (bfd *abfd, asection *sectp, void *ignore)
   struct gdb_bfd_section_data *sect
     = (struct gdb_bfd_section_data *) bfd_get_section_userdata (abfd, sectp);
 
+  if (sect != NULL && sect->pending != NULL)
+    {
+      /* The worker thread still uses the compressed contents.  */
+      sect->pending->done.wait ();
+      xfree (sect->pending->data);
+      delete sect->pending;
+      sect->pending = NULL;
+    }
+
   if (sect != NULL && sect->data != NULL)
     {
 #ifndef __sparc__
@@ -643,6 +676,421 @@ get_section_descriptor (asection *section)
   return result;
 }
 
+/* Read the compressed contents of the compressed section SECTP into
+   CONTENTS, and set *OFFSET to the offset of the zlib stream in them.
+   Return false on error.  */
+
+static bool
+read_compressed_section (asection *sectp, gdb::byte_vector *contents,
+			 size_t *offset)
+{
+  bfd *abfd = sectp->owner;
+
+  /* Read the section as it is in the file.  */
+  contents->resize (sectp->compressed_size);
+  bool ok = (bfd_seek (abfd, sectp->filepos, SEEK_SET) == 0
+	     && (bfd_bread (contents->data (), sectp->compressed_size, abfd)
+		 == sectp->compressed_size));
+
+  /* SHF_COMPRESSED sections start with an ELF compression header,
+     .zdebug sections with "ZLIB" and the big-endian 8-byte size.  */
+  *offset = bfd_get_compression_header_size (abfd, sectp);
+  if (*offset == 0)
+    *offset = 12;
+
+  return ok && *offset < contents->size ();
+}
+
+/* Decompress the IN_LEN bytes of zlib streams at IN into the OUT_LEN
+   bytes at OUT.  Like BFD, accept several streams concatenated
+   together.  Return true if the streams decompress to exactly OUT_LEN
+   bytes.  This does not call into the rest of GDB, so it can run on a
+   worker thread.  */
+
+static bool
+inflate_section (const gdb_byte *in, size_t in_len, gdb_byte *out,
+		 size_t out_len)
+{
+  z_stream zs;
+  int status;
+
+  memset (&zs, 0, sizeof (zs));
+  zs.next_in = (Bytef *) in;
+  zs.avail_in = in_len;
+  zs.avail_out = out_len;
+
+  status = inflateInit (&zs);
+  while (status == Z_OK && zs.avail_in > 0 && zs.avail_out > 0)
+    {
+      zs.next_out = out + (out_len - zs.avail_out);
+      status = inflate (&zs, Z_FINISH);
+      if (status != Z_STREAM_END)
+	break;
+      status = inflateReset (&zs);
+    }
+  status |= inflateEnd (&zs);
+
+  return status == Z_OK && zs.avail_out == 0;
+}
+
+/* The least amount of compressed data worth decompressing on its own
+   worker thread.  */
+#define INFLATE_PIECE_MIN_SIZE (1024 * 1024)
+
+/* A piece of a zlib stream split at a full flush point, see
+   inflate_section_parallel.  */
+
+struct inflate_piece
+{
+  /* The compressed data of this piece.  */
+  const gdb_byte *in;
+  size_t in_len;
+
+  /* Whether this is the first or last piece of the stream.  The first
+     piece starts with the zlib header, the last one ends with the
+     final deflate block and the adler32 checksum.  */
+  bool first;
+  bool last;
+
+  /* The decompressed data, its adler32 checksum, and whether IN
+     decompressed cleanly.  */
+  gdb::byte_vector out;
+  uLong adler = 0;
+  bool ok = false;
+};
+
+/* Decompress PIECE, producing at most MAX_OUT bytes.  This runs on a
+   worker thread.  */
+
+static void
+inflate_one_piece (inflate_piece *piece, size_t max_out)
+{
+  z_stream zs;
+  size_t produced = 0;
+  int status = Z_OK;
+
+  memset (&zs, 0, sizeof (zs));
+  zs.next_in = (Bytef *) piece->in;
+  zs.avail_in = piece->in_len;
+
+  /* Only the first piece has a zlib header; the others are raw
+     deflate data.  */
+  if (inflateInit2 (&zs, piece->first ? 15 : -15) != Z_OK)
+    return;
+
+  piece->out.resize (std::min (max_out, 4 * piece->in_len));
+  for (;;)
+    {
+      if (produced == piece->out.size ())
+	{
+	  if (produced == max_out)
+	    break;
+	  piece->out.resize (std::min (max_out, 2 * produced));
+	}
+
+      zs.next_out = piece->out.data () + produced;
+      zs.avail_out = piece->out.size () - produced;
+      status = inflate (&zs, Z_NO_FLUSH);
+      produced = piece->out.size () - zs.avail_out;
+
+      if (status == Z_STREAM_END
+	  || (status != Z_OK && status != Z_BUF_ERROR)
+	  || (zs.avail_in == 0 && zs.avail_out != 0))
+	break;
+    }
+  inflateEnd (&zs);
+
+  piece->out.resize (produced);
+
+  /* A piece other than the last must end exactly at the flush point
+     it was split at.  The last one must leave the adler32 checksum of
+     the zlib trailer.  */
+  if (piece->last)
+    piece->ok = status == Z_STREAM_END && zs.avail_in == 4;
+  else
+    piece->ok = ((status == Z_OK || status == Z_BUF_ERROR)
+		 && zs.avail_in == 0);
+
+  if (piece->ok)
+    piece->adler = adler32 (adler32 (0, NULL, 0), piece->out.data (),
+			    produced);
+}
+
+/* Like inflate_section, but for a single zlib stream written with full
+   flush points, decompress the pieces between flush points on the
+   worker threads in parallel.  Return false if the stream can't be split
+   this way, or if it does not decompress to exactly OUT_LEN bytes;
+   the caller should then use inflate_section.  */
+
+static bool
+inflate_section_parallel (const gdb_byte *in, size_t in_len,
+			  gdb_byte *out, size_t out_len)
+{
+  size_t n_threads = gdb::thread_pool::g_thread_pool->thread_count ();
+
+  if (n_threads == 0 || in_len < 2 * INFLATE_PIECE_MIN_SIZE)
+    return false;
+
+  size_t piece_len = std::max ((size_t) INFLATE_PIECE_MIN_SIZE,
+			       in_len / n_threads);
+
+  /* A full flush ends with an empty stored block, whose byte-aligned
+     length fields are 00 00 ff ff, and resets the compression state,
+     so that the rest of the stream decompresses on its own.  The same
+     bytes may also occur in the middle of a block; the checks below
+     reject such a split.  The last 4 bytes are the adler32 checksum
+     of the whole stream.  */
+  static const gdb_byte flush_marker[] = { 0x00, 0x00, 0xff, 0xff };
+  size_t end = in_len - 4;
+  std::vector<size_t> starts { 0 };
+
+  for (size_t target = piece_len;
+       target < end;
+       target = starts.back () + piece_len)
+    {
+      const gdb_byte *marker
+	= (const gdb_byte *) memmem (in + target, end - target,
+				     flush_marker, sizeof (flush_marker));
+      if (marker == NULL || marker + sizeof (flush_marker) >= in + end)
+	break;
+      starts.push_back (marker + sizeof (flush_marker) - in);
+    }
+
+  if (starts.size () < 2)
+    return false;
+
+  std::vector<inflate_piece> pieces (starts.size ());
+  std::vector<std::future<void>> done;
+
+  for (size_t i = 0; i < starts.size (); ++i)
+    {
+      inflate_piece *piece = &pieces[i];
+
+      piece->in = in + starts[i];
+      piece->in_len = (i + 1 < starts.size () ? starts[i + 1] : in_len)
+		      - starts[i];
+      piece->first = i == 0;
+      piece->last = i + 1 == starts.size ();
+      done.push_back (gdb::thread_pool::g_thread_pool->post_task
+		      ([piece, out_len] ()
+		       {
+			 inflate_one_piece (piece, out_len);
+		       }));
+    }
+
+  for (std::future<void> &f : done)
+    f.wait ();
+
+  /* Check the pieces against the checksum of the whole stream before
+     putting them together.  */
+  size_t total = 0;
+  uLong adler = adler32 (0, NULL, 0);
+
+  for (const inflate_piece &piece : pieces)
+    {
+      if (!piece.ok)
+	return false;
+      adler = adler32_combine (adler, piece.adler, piece.out.size ());
+      total += piece.out.size ();
+    }
+
+  const gdb_byte *trailer = in + end;
+  uLong expected = (((uLong) trailer[0] << 24) | ((uLong) trailer[1] << 16)
+		    | ((uLong) trailer[2] << 8) | trailer[3]);
+  if (total != out_len || adler != expected)
+    return false;
+
+  for (const inflate_piece &piece : pieces)
+    {
+      memcpy (out, piece.out.data (), piece.out.size ());
+      out += piece.out.size ();
+    }
+
+  return true;
+}
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Compress the LEN bytes at DATA into a zlib stream, with a full flush
+   point every FLUSH_INTERVAL bytes of input if that is not zero.  */
+
+static gdb::byte_vector
+deflate_for_test (const gdb_byte *data, size_t len, size_t flush_interval)
+{
+  z_stream zs;
+
+  memset (&zs, 0, sizeof (zs));
+  SELF_CHECK (deflateInit (&zs, Z_DEFAULT_COMPRESSION) == Z_OK);
+
+  /* Each flush point adds an empty stored block.  */
+  gdb::byte_vector out (deflateBound (&zs, len) + 1024
+			+ (flush_interval == 0 ? 0 : 16 * (len / flush_interval)));
+  zs.next_out = out.data ();
+  zs.avail_out = out.size ();
+
+  size_t pos = 0;
+  int status;
+  do
+    {
+      size_t chunk = len - pos;
+      if (flush_interval != 0)
+	chunk = std::min (chunk, flush_interval);
+      zs.next_in = (Bytef *) data + pos;
+      zs.avail_in = chunk;
+      pos += chunk;
+      status = deflate (&zs, pos == len ? Z_FINISH : Z_FULL_FLUSH);
+      SELF_CHECK (zs.avail_in == 0);
+    }
+  while (pos < len);
+  SELF_CHECK (status == Z_STREAM_END);
+
+  out.resize (out.size () - zs.avail_out);
+  deflateEnd (&zs);
+  return out;
+}
+
+/* Test inflate_section_parallel on a stream with full flush points,
+   and check that it rejects streams it can't split or that do not
+   match their checksum.  */
+
+static void
+test_inflate_section_parallel ()
+{
+  size_t saved_count = gdb::thread_pool::g_thread_pool->thread_count ();
+  SCOPE_EXIT
+    {
+      gdb::thread_pool::g_thread_pool->set_thread_count (saved_count);
+    };
+
+  if (saved_count < 2)
+    gdb::thread_pool::g_thread_pool->set_thread_count (2);
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return;
+
+  /* Data that does not compress well, so that there are several
+     pieces of at least INFLATE_PIECE_MIN_SIZE.  */
+  const size_t len = 4 * INFLATE_PIECE_MIN_SIZE;
+  gdb::byte_vector data (len);
+  uint32_t seed = 1;
+  for (gdb_byte &b : data)
+    {
+      seed = seed * 1103515245 + 12345;
+      b = seed >> 24;
+    }
+
+  gdb::byte_vector out (len);
+  gdb::byte_vector flushed
+    = deflate_for_test (data.data (), len, INFLATE_PIECE_MIN_SIZE / 4);
+  SELF_CHECK (inflate_section_parallel (flushed.data (), flushed.size (),
+					out.data (), len));
+  SELF_CHECK (out == data);
+
+  /* The wrong size.  */
+  SELF_CHECK (!inflate_section_parallel (flushed.data (), flushed.size (),
+					 out.data (), len - 1));
+
+  /* A checksum that doesn't match.  */
+  flushed.back () ^= 1;
+  SELF_CHECK (!inflate_section_parallel (flushed.data (), flushed.size (),
+					 out.data (), len));
+
+  /* Without flush points, the stream can't be split.  */
+  gdb::byte_vector plain = deflate_for_test (data.data (), len, 0);
+  SELF_CHECK (!inflate_section_parallel (plain.data (), plain.size (),
+					 out.data (), len));
+  SELF_CHECK (inflate_section (plain.data (), plain.size (),
+			       out.data (), len));
+  SELF_CHECK (out == data);
+}
+
+} // namespace selftests
+
+#endif /* GDB_SELF_TEST */
+
+/* Decompress the compressed section SECTP.  Return the decompressed
+   contents, allocated with xmalloc, or NULL on error.  */
+
+static gdb_byte *
+decompress_section (asection *sectp)
+{
+  gdb::byte_vector compressed;
+  size_t offset;
+
+  if (!read_compressed_section (sectp, &compressed, &offset))
+    return NULL;
+
+  bfd_size_type size = bfd_get_section_size (sectp);
+  gdb::unique_xmalloc_ptr<gdb_byte> data ((gdb_byte *) xmalloc (size));
+  const gdb_byte *in = compressed.data () + offset;
+  size_t in_len = compressed.size () - offset;
+
+  if (!inflate_section_parallel (in, in_len, data.get (), size)
+      && !inflate_section (in, in_len, data.get (), size))
+    return NULL;
+
+  return data.release ();
+}
+
+/* See gdb_bfd.h.  */
+
+void
+gdb_bfd_prefetch_section (asection *sectp)
+{
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0
+      || (sectp->flags & SEC_RELOC) != 0
+      || sectp->compress_status != DECOMPRESS_SECTION_SIZED
+      /* Leave sections the index cache may hold to
+	 gdb_bfd_map_section.  */
+      || global_index_cache.enabled ())
+    return;
+
+  struct gdb_bfd_section_data *descriptor = get_section_descriptor (sectp);
+  if (descriptor->data != NULL || descriptor->pending != NULL)
+    return;
+
+  std::unique_ptr<gdb_bfd_pending_section> pending
+    (new gdb_bfd_pending_section);
+  if (!read_compressed_section (sectp, &pending->compressed,
+				&pending->offset))
+    return;
+
+  gdb_bfd_pending_section *p = pending.get ();
+  bfd_size_type size = bfd_get_section_size (sectp);
+
+  p->done = gdb::thread_pool::g_thread_pool->post_task ([p, size] ()
+    {
+      /* Not xmalloc, which can't be called from a worker thread.  */
+      gdb_byte *data = (gdb_byte *) malloc (size);
+
+      if (data != NULL
+	  && !inflate_section (p->compressed.data () + p->offset,
+			       p->compressed.size () - p->offset,
+			       data, size))
+	{
+	  free (data);
+	  data = NULL;
+	}
+      p->data = data;
+    });
+  descriptor->pending = pending.release ();
+}
+
+/* Wait for the prefetch of the section described by DESCRIPTOR to
+   complete, and return its decompressed contents, allocated with
+   malloc, or NULL if the prefetch failed.  */
+
+static gdb_byte *
+finish_prefetch (struct gdb_bfd_section_data *descriptor)
+{
+  std::unique_ptr<gdb_bfd_pending_section> pending (descriptor->pending);
+
+  descriptor->pending = NULL;
+  pending->done.wait ();
+  return pending->data;
+}
+
 /* See gdb_bfd.h.  */
 
 const gdb_byte *
@@ -651,6 +1099,7 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   bfd *abfd;
   struct gdb_bfd_section_data *descriptor;
   bfd_byte *data;
+  bool store_in_cache = false;
 
   gdb_assert ((sectp->flags & SEC_RELOC) == 0);
   gdb_assert (size != NULL);
@@ -663,16 +1112,28 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   if (descriptor->data != NULL)
     goto done;
 
+  /* If a worker thread is decompressing the section, use its
+     result.  */
+  if (descriptor->pending != NULL)
+    {
+      descriptor->data = finish_prefetch (descriptor);
+      if (descriptor->data != NULL)
+	{
+	  descriptor->size = bfd_get_section_size (sectp);
+	  goto done;
+	}
+    }
+
 #ifndef __sparc__
 #ifdef HAVE_MMAP
-  if (!bfd_is_section_compressed (abfd, sectp))
-    {
-      /* The page size, used when mmapping.  */
-      static int pagesize;
+  /* The page size, used when mmapping.  */
+  static int pagesize;
 
-      if (pagesize == 0)
-	pagesize = getpagesize ();
+  if (pagesize == 0)
+    pagesize = getpagesize ();
 
+  if (!bfd_is_section_compressed (abfd, sectp))
+    {
       /* Only try to mmap sections which are large enough: we don't want
 	 to waste space due to fragmentation.  */
 
@@ -697,6 +1158,22 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
 	  memset (descriptor, 0, sizeof (*descriptor));
 	}
     }
+  else if (bfd_get_section_size (sectp) > 4 * pagesize
+	   && global_index_cache.enabled ())
+    {
+      /* Map the decompressed contents from the index cache if another
+	 GDB put them there, which saves decompressing them and shares
+	 the memory with the other GDBs using them.  */
+      if (global_index_cache.lookup_section (sectp, &descriptor->map_addr,
+					     &descriptor->map_len))
+	{
+	  descriptor->size = bfd_get_section_size (sectp);
+	  descriptor->data = descriptor->map_addr;
+	  goto done;
+	}
+
+      store_in_cache = true;
+    }
 #endif /* HAVE_MMAP */
 #endif
 
@@ -706,8 +1183,12 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
   descriptor->size = bfd_get_section_size (sectp);
   descriptor->data = NULL;
 
+  /* Decompress compressed sections ourselves, which can use the worker
+     threads.  */
   data = NULL;
-  if (!bfd_get_full_section_contents (abfd, sectp, &data))
+  if (sectp->compress_status == DECOMPRESS_SECTION_SIZED)
+    data = decompress_section (sectp);
+  if (data == NULL && !bfd_get_full_section_contents (abfd, sectp, &data))
     {
       warning (_("Can't read data for section '%s' in file '%s'"),
 	       bfd_get_section_name (abfd, sectp),
@@ -719,6 +1200,9 @@ gdb_bfd_map_section (asection *sectp, bfd_size_type *size)
     }
   descriptor->data = data;
 
+  if (store_in_cache)
+    global_index_cache.store_section (sectp, data);
+
  done:
   gdb_assert (descriptor->data != NULL);
   *size = descriptor->size;
@@ -1000,4 +1484,9 @@ When non-zero, bfd cache specific debugging is enabled."),
 			     NULL,
 			     &show_bfd_cache_debug,
 			     &setdebuglist, &showdebuglist);
+
+#if GDB_SELF_TEST
+  selftests::register_test ("inflate_section_parallel",
+			    selftests::test_inflate_section_parallel);
+#endif
 }
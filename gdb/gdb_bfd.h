@@ -115,6 +115,13 @@ void gdb_bfd_record_inclusion (bfd *includer, bfd *includee);
 
 const gdb_byte *gdb_bfd_map_section (asection *section, bfd_size_type *size);
 
+/* Start decompressing the compressed section SECT on a worker thread,
+   so that a later gdb_bfd_map_section of it does not have to wait as
+   long.  This does nothing if SECT is not compressed, has already been
+   read, or if there are no worker threads.  */
+
+void gdb_bfd_prefetch_section (asection *sect);
+
 /* Compute the CRC for ABFD.  The CRC is used to find and verify
    separate debug files.  When successful, this fills in *CRC_OUT and
    returns 1.  Otherwise, this issues a warning and returns 0.  */
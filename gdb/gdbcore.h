@@ -145,6 +145,15 @@ extern void core_target_open (const char *arg, int from_tty);
 
 extern void core_file_command (const char *filename, int from_tty);
 
+/* Return the addresses of the memory of the current core file that
+   hold pointers into [ADDR, ADDR + LEN), sorted.  The pointer index of
+   the core file is read or built on first use (see
+   core-pointer-index.h).  Throws an error if there is no core
+   file.  */
+
+extern std::vector<CORE_ADDR> core_file_referrers (CORE_ADDR addr,
+						   ULONGEST len);
+
 extern void exec_file_attach (const char *filename, int from_tty);
 
 /* If the filename of the main executable is unknown, attempt to
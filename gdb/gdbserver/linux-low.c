@@ -438,6 +438,7 @@ linux_add_process (int pid, int attached)
 
   proc = add_process (pid, attached);
   proc->priv = XCNEW (struct process_info_private);
+  proc->priv->mem_fd = -1;
 
   if (the_low_target.new_process != NULL)
     proc->priv->arch_private = the_low_target.new_process ();
@@ -1672,6 +1673,8 @@ linux_mourn (struct process_info *process)
 
   /* Freeing all private data.  */
   priv = process->priv;
+  if (priv->mem_fd != -1)
+    close (priv->mem_fd);
   if (the_low_target.delete_process != NULL)
     the_low_target.delete_process (priv->arch_private);
   else
@@ -5721,6 +5724,28 @@ linux_store_registers (struct regcache *regcache, int regno)
 }
 
 
+/* Return the cached /proc/PID/mem descriptor of PROC, opening it
+   through the current thread if needed.  Returns -1 if the file
+   cannot be opened, or if its use was disabled for testing.  */
+
+static int
+linux_proc_mem_fd (struct process_info *proc)
+{
+  if (disable_proc_mem)
+    return -1;
+
+  if (proc->priv->mem_fd == -1)
+    {
+      char filename[64];
+
+      sprintf (filename, "/proc/%ld/mem", lwpid_of (current_thread));
+      proc->priv->mem_fd = gdb_open_cloexec (filename,
+					     O_RDONLY | O_LARGEFILE, 0);
+    }
+
+  return proc->priv->mem_fd;
+}
+
 /* Copy LEN bytes from inferior's memory starting at MEMADDR
    to debugger memory starting at MYADDR.  */
 
@@ -5731,23 +5756,17 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   PTRACE_XFER_TYPE *buffer;
   CORE_ADDR addr;
   int count;
-  char filename[64];
   int i;
   int ret;
   int fd;
 
-  /* Try using /proc.  Don't bother for one word.  */
-  if (len >= 3 * sizeof (long))
+  /* Try using /proc first.  The descriptor is cached, so this costs a
+     single syscall even for one word.  */
+  fd = linux_proc_mem_fd (current_process ());
+  if (fd != -1)
     {
       int bytes;
 
-      /* We could keep this file open and cache it - possibly one per
-	 thread.  That requires some juggling, but is even faster.  */
-      sprintf (filename, "/proc/%d/mem", pid);
-      fd = open (filename, O_RDONLY | O_LARGEFILE);
-      if (fd == -1)
-	goto no_proc;
-
       /* If pread64 is available, use it.  It's faster if the kernel
 	 supports it (only one syscall), and it's 64-bit safe even on
 	 32-bit platforms (for instance, SPARC debugging a SPARC64
@@ -5760,11 +5779,18 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 	bytes = read (fd, myaddr, len);
 #endif
 
-      close (fd);
       if (bytes == len)
 	return 0;
 
-      /* Some data was read, we'll try to get the rest with ptrace.  */
+      /* End of file means the thread the descriptor was opened
+	 through is gone.  Reopen it through another one next time.  */
+      if (bytes == 0)
+	{
+	  close (fd);
+	  current_process ()->priv->mem_fd = -1;
+	}
+
+      /* Some data was read, we'll try to get the rest another way.  */
       if (bytes > 0)
 	{
 	  memaddr += bytes;
@@ -5773,7 +5799,31 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
 	}
     }
 
- no_proc:
+#ifdef HAVE_PROCESS_VM_READV
+  /* Then try process_vm_readv, which does not need /proc.  */
+  {
+    struct iovec local, remote;
+    ssize_t bytes;
+
+    local.iov_base = myaddr;
+    local.iov_len = len;
+    remote.iov_base = (void *) (uintptr_t) memaddr;
+    remote.iov_len = len;
+    bytes = process_vm_readv (pid, &local, 1, &remote, 1, 0);
+    if (bytes == len)
+      return 0;
+
+    if (bytes > 0)
+      {
+	memaddr += bytes;
+	myaddr += bytes;
+	len -= bytes;
+      }
+  }
+#endif
+
+  /* As a last resort, read one word at a time with ptrace.  */
+
   /* Round starting address down to longword boundary.  */
   addr = memaddr & -(CORE_ADDR) sizeof (PTRACE_XFER_TYPE);
   /* Round ending address up; get number of longwords that makes.  */
@@ -5809,6 +5859,52 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return ret;
 }
 
+#ifdef HAVE_PROCESS_VM_READV
+
+/* Implementation of the target_ops method "read_memory_ranges".  Each
+   call to process_vm_readv reads up to IOV_MAX ranges.  */
+
+static int
+linux_read_memory_ranges (int count, const CORE_ADDR *addrs,
+			  const int *lens, unsigned char *myaddr)
+{
+  int pid = lwpid_of (current_thread);
+#ifdef IOV_MAX
+  const int iov_max = IOV_MAX;
+#else
+  const int iov_max = 1024;
+#endif
+  std::vector<struct iovec> local (std::min (count, iov_max));
+  std::vector<struct iovec> remote (local.size ());
+  int total = 0;
+
+  for (int first = 0; first < count; first += iov_max)
+    {
+      int n = std::min (count - first, iov_max);
+      ssize_t want = 0;
+
+      for (int i = 0; i < n; i++)
+	{
+	  local[i].iov_base = myaddr + total + want;
+	  local[i].iov_len = lens[first + i];
+	  remote[i].iov_base = (void *) (uintptr_t) addrs[first + i];
+	  remote[i].iov_len = lens[first + i];
+	  want += lens[first + i];
+	}
+
+      ssize_t bytes = process_vm_readv (pid, local.data (), n,
+					remote.data (), n, 0);
+      if (bytes > 0)
+	total += bytes;
+      if (bytes != want)
+	break;
+    }
+
+  return total;
+}
+
+#endif
+
 /* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
    memory at MEMADDR.  On failure (cannot write to the inferior)
    returns the value of errno.  Always succeeds if LEN is zero.  */
@@ -7568,6 +7664,11 @@ static struct target_ops linux_target_ops = {
 #else
   NULL,
 #endif
+#ifdef HAVE_PROCESS_VM_READV
+  linux_read_memory_ranges,
+#else
+  NULL,
+#endif
 };
 
 #ifdef HAVE_LINUX_REGSETS
@@ -125,6 +125,11 @@ struct process_info_private
 
   /* &_r_debug.  0 if not yet determined.  -1 if no PT_DYNAMIC in Phdrs.  */
   CORE_ADDR r_debug;
+
+  /* Descriptor for /proc/PID/mem, opened on first use, or -1.  It is
+     closed when the process is mourned, including when it execs, as
+     the descriptor is tied to the address space it was opened on.  */
+  int mem_fd;
 };
 
 struct lwp_info;
@@ -44,6 +44,10 @@
 
 #include "common/selftest.h"
 #include "common/scope-exit.h"
+#include "common/byte-vector.h"
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
 
 #define require_running_or_return(BUF)		\
   if (!target_running ())			\
@@ -134,6 +138,11 @@ int disable_packet_Tthread;
 int disable_packet_qC;
 int disable_packet_qfThreadInfo;
 
+/* Set by --no-proc-mem if you want the low target to read memory
+   without going through /proc/PID/mem, for the sake of testing its
+   fallbacks.  */
+int disable_proc_mem;
+
 static unsigned char *mem_buf;
 
 /* A sub-class of 'struct notif_event' for stop, holding information
@@ -2148,6 +2157,243 @@ supported_btrace_packets (char *buf)
   strcat (buf, ";qXfer:btrace-conf:read+");
 }
 
+/* Granularity used by memread_range to find the readable prefix of a
+   range that could not be read in one go.  */
+#define MEMREAD_PAGE_SIZE 4096
+
+/* Read as much as possible of the LEN bytes at MEMADDR into MYADDR,
+   for the qMemRead packet.  Unlike gdb_read_memory, failing to read
+   the whole range is not fatal: the range is retried a page at a time
+   to find out where its readable prefix ends.  Returns the number of
+   bytes read.  */
+
+static ULONGEST
+memread_range (CORE_ADDR memaddr, unsigned char *myaddr, ULONGEST len)
+{
+  ULONGEST done = 0;
+  bool paged = false;
+
+  while (done < len)
+    {
+      CORE_ADDR addr = memaddr + done;
+      ULONGEST todo = len - done;
+
+      if (paged)
+	todo = std::min (todo, (ULONGEST) (MEMREAD_PAGE_SIZE
+					   - (addr & (MEMREAD_PAGE_SIZE - 1))));
+
+      int res = gdb_read_memory (addr, myaddr + done, todo);
+      if (res < 0 && !paged)
+	{
+	  paged = true;
+	  continue;
+	}
+      if (res <= 0)
+	break;
+      done += res;
+    }
+
+  return done;
+}
+
+/* Read the COUNT ranges at ADDRS of LENS bytes, one after the other
+   into MYADDR, with a single call to the target if it supports that.
+   Returns the number of bytes read, which is zero if the target cannot
+   read several ranges at once.  */
+
+static int
+memread_ranges_direct (int count, const CORE_ADDR *addrs, const int *lens,
+		       unsigned char *myaddr)
+{
+  client_state &cs = get_client_state ();
+  int res = 0;
+
+  if (cs.current_traceframe >= 0 || !target_supports_read_memory_ranges ())
+    return 0;
+
+  if (prepare_to_access_memory () != 0)
+    return 0;
+  if (set_desired_thread ())
+    res = read_inferior_memory_ranges (count, addrs, lens, myaddr);
+  done_accessing_memory ();
+
+  return res;
+}
+
+/* Write the header of a qMemRead reply into BUF: the reply KIND
+   character, followed by the hex LENGTHS separated by ',' and
+   terminated by ';'.  Returns the number of characters written.  */
+
+static int
+memread_write_header (char *buf, char kind,
+		      const std::vector<ULONGEST> &lengths)
+{
+  char *p = buf;
+
+  *p++ = kind;
+  for (size_t i = 0; i < lengths.size (); i++)
+    {
+      if (i > 0)
+	*p++ = ',';
+      p += sprintf (p, "%s", phex_nz (lengths[i], sizeof (lengths[i])));
+    }
+  *p++ = ';';
+
+  return p - buf;
+}
+
+/* Handle the qMemRead packet, which reads several ranges of memory
+   in one round trip:
+
+     qMemRead:[Z;]ADDR,LENGTH[;ADDR,LENGTH]...
+
+   The reply starts with 'b' for plain data or 'z' for a zlib stream,
+   and follows with the number of bytes read from each range, in hex,
+   separated by ',' and terminated by ';'.  The remainder of the reply
+   is the contents of all those ranges, concatenated (and compressed
+   when the reply kind is 'z'), as escaped binary data.  A length of
+   zero means the range could not be read.  Ranges after the last
+   reported length were not read, because the reply would not have
+   fit in MEMREAD_PBUFSIZ.  */
+
+static void
+handle_qmemread (char *own_buf, int *new_packet_len_p)
+{
+  static gdb::byte_vector data;
+  std::vector<CORE_ADDR> addrs;
+  std::vector<int> lens;
+  std::vector<ULONGEST> lengths;
+  const char *p = own_buf + strlen ("qMemRead:");
+  bool compress = false;
+  size_t header_max = 2;
+  size_t total = 0;
+
+  if (startswith (p, "Z;"))
+    {
+#ifdef HAVE_LIBZ
+      compress = true;
+#endif
+      p += 2;
+    }
+
+  /* Compressed replies may carry more data than fits in the reply
+     buffer.  If the data turns out not to compress well enough, we
+     fall back to sending a plain prefix of it.  */
+  size_t max_raw = compress ? 4 * MEMREAD_PBUFSIZ : MEMREAD_PBUFSIZ;
+
+  while (*p != '\0')
+    {
+      ULONGEST addr, len;
+
+      p = unpack_varlen_hex (p, &addr);
+      if (*p != ',')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+      p = unpack_varlen_hex (p + 1, &len);
+      if (*p == ';')
+	p++;
+      else if (*p != '\0')
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      /* Keep parsing so that malformed packets are always rejected,
+	 but leave out the ranges that would not fit in the reply.  */
+      if (total >= max_raw)
+	continue;
+
+      len = std::min (len, (ULONGEST) (max_raw - total));
+      addrs.push_back (addr);
+      lens.push_back (len);
+      total += len;
+      header_max += strlen (phex_nz (len, sizeof (len))) + 1;
+    }
+
+  if (addrs.empty ())
+    {
+      write_enn (own_buf);
+      return;
+    }
+
+  /* Read as many ranges as possible at once.  The ranges from the
+     first one that could not be read entirely on are read one by one,
+     which also finds out how much of each is readable.  */
+  data.resize (total);
+  size_t done = memread_ranges_direct (addrs.size (), addrs.data (),
+				       lens.data (), data.data ());
+  size_t offset = 0;
+
+  for (size_t i = 0; i < addrs.size (); i++)
+    {
+      ULONGEST len = lens[i];
+
+      if (offset + len > done)
+	{
+	  len = memread_range (addrs[i], data.data () + offset, len);
+	  done = 0;
+	}
+      lengths.push_back (len);
+      offset += len;
+    }
+  data.resize (offset);
+
+#ifdef HAVE_LIBZ
+  if (compress)
+    {
+      static gdb::byte_vector zdata;
+      uLongf zlen = compressBound (data.size ());
+
+      zdata.resize (zlen);
+      if (compress2 (zdata.data (), &zlen, data.data (), data.size (),
+		     Z_BEST_SPEED) == Z_OK)
+	{
+	  int header_len = memread_write_header (own_buf, 'z', lengths);
+	  int consumed;
+	  int out_len
+	    = remote_escape_output (zdata.data (), zlen, 1,
+				    (gdb_byte *) own_buf + header_len,
+				    &consumed, MEMREAD_PBUFSIZ - header_len);
+
+	  if ((uLongf) consumed == zlen)
+	    {
+	      *new_packet_len_p = header_len + out_len;
+	      return;
+	    }
+	}
+    }
+#endif
+
+  /* Send the data uncompressed.  Escape it after the largest possible
+     header, then trim the lengths to what fit and move the data right
+     after the actual header.  */
+  int consumed;
+  int out_len = remote_escape_output (data.data (), data.size (), 1,
+				      (gdb_byte *) own_buf + header_max,
+				      &consumed, MEMREAD_PBUFSIZ - header_max);
+  ULONGEST left = consumed;
+
+  for (size_t i = 0; i < lengths.size (); i++)
+    {
+      if (lengths[i] > left)
+	{
+	  /* A range that got cut to nothing would read as an
+	     unreadable one.  Leave it out instead.  */
+	  if (left > 0)
+	    lengths[i++] = left;
+	  lengths.resize (i);
+	  break;
+	}
+      left -= lengths[i];
+    }
+
+  int header_len = memread_write_header (own_buf, 'b', lengths);
+  memmove (own_buf + header_len, own_buf + header_max, out_len);
+  *new_packet_len_p = header_len + out_len;
+}
+
 /* Handle all of the extended 'q' packets.  */
 
 static void
@@ -2484,6 +2730,11 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      sprintf (own_buf + strlen (own_buf), ";qMemRead=%x", MEMREAD_PBUFSIZ);
+#ifdef HAVE_LIBZ
+      strcat (own_buf, ";qMemRead:zlib+");
+#endif
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -2671,6 +2922,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (startswith (own_buf, "qMemRead:"))
+    {
+      require_running_or_return (own_buf);
+      handle_qmemread (own_buf, new_packet_len_p);
+      return;
+    }
+
   if (handle_qxfer (own_buf, packet_len, new_packet_len_p))
     return;
 
@@ -3467,6 +3725,7 @@ gdbserver_usage (FILE *stream)
 	   "                          Options:\n"
 	   "                            vCont, Tthread, qC, qfThreadInfo and \n"
 	   "                            threads (disable all threading packets).\n"
+	   "  --no-proc-mem         Read inferior memory without /proc/PID/mem.\n"
 	   "\n"
 	   "For more information, consult the GDB manual (available as on-line \n"
 	   "info or a printed manual).\n");
@@ -3651,6 +3910,8 @@ captured_main (int argc, char *argv[])
 	}
       else if (strcmp (*next_arg, "--remote-debug") == 0)
 	remote_debug = 1;
+      else if (strcmp (*next_arg, "--no-proc-mem") == 0)
+	disable_proc_mem = 1;
       else if (strcmp (*next_arg, "--disable-packet") == 0)
 	{
 	  gdbserver_show_disableable (stdout);
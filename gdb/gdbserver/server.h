@@ -74,6 +74,7 @@ extern int disable_packet_vCont;
 extern int disable_packet_Tthread;
 extern int disable_packet_qC;
 extern int disable_packet_qfThreadInfo;
+extern int disable_proc_mem;
 
 extern int run_once;
 extern int non_stop;
@@ -115,6 +116,12 @@ extern int in_queued_stop_replies (ptid_t ptid);
    as large as the largest register set supported by gdbserver.  */
 #define PBUFSIZ 18432
 
+/* Maximum size of a reply to the qMemRead packet.  This is larger
+   than PBUFSIZ so that bulk memory transfers need fewer round trips;
+   GDB learns the value from our qSupported reply.  The packet buffer
+   of each client is allocated with this size.  */
+#define MEMREAD_PBUFSIZ (256 * 1024)
+
 /* Definition for an unknown syscall, used basically in error-cases.  */
 #define UNKNOWN_SYSCALL (-1)
 
@@ -139,7 +146,7 @@ extern unsigned long signal_pid;
 struct client_state
 {
   client_state ():
-    own_buf ((char *) xmalloc (PBUFSIZ + 1)) 
+    own_buf ((char *) xmalloc (MEMREAD_PBUFSIZ + 1))
   {}
 
   /* The thread set with an `Hc' packet.  `Hc' is deprecated in favor of
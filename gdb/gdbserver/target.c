@@ -130,6 +130,25 @@ read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return res;
 }
 
+int
+read_inferior_memory_ranges (int count, const CORE_ADDR *addrs,
+			     const int *lens, unsigned char *myaddr)
+{
+  int res = (*the_target->read_memory_ranges) (count, addrs, lens, myaddr);
+  int left = res;
+
+  for (int i = 0; i < count && left > 0; i++)
+    {
+      int len = std::min (lens[i], left);
+
+      check_mem_read (addrs[i], myaddr, len);
+      myaddr += len;
+      left -= len;
+    }
+
+  return res;
+}
+
 /* See target/target.h.  */
 
 int
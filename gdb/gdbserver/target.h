@@ -478,6 +478,18 @@ struct target_ops
      false for failure.  Return pointer to thread handle via HANDLE
      and the handle's length via HANDLE_LEN.  */
   bool (*thread_handle) (ptid_t ptid, gdb_byte **handle, int *handle_len);
+
+  /* Read several ranges of memory from the inferior process in one
+     go.  This should generally be called through
+     read_inferior_memory_ranges, which handles breakpoint shadowing.
+
+     Read LENS[I] bytes at ADDRS[I], for I from 0 to COUNT - 1,
+     storing them one after the other at MYADDR.  Reading stops at
+     the first byte that cannot be read.  Returns the number of bytes
+     read.  NULL if the target has no better way than calling
+     read_memory for each range.  */
+  int (*read_memory_ranges) (int count, const CORE_ADDR *addrs,
+			     const int *lens, unsigned char *myaddr);
 };
 
 extern struct target_ops *the_target;
@@ -724,8 +736,14 @@ void done_accessing_memory (void);
                                   (ptid, handle, handle_len) \
    : false)
 
+#define target_supports_read_memory_ranges() \
+  (the_target->read_memory_ranges != NULL)
+
 int read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len);
 
+int read_inferior_memory_ranges (int count, const CORE_ADDR *addrs,
+				 const int *lens, unsigned char *myaddr);
+
 int write_inferior_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 			   int len);
 
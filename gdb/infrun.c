@@ -2443,7 +2443,10 @@ resume_1 (enum gdb_signal sig)
 	  /* Fallback to stepping over the breakpoint in-line.  */
 
 	  if (target_is_non_stop_p ())
-	    stop_all_threads ();
+	    {
+	      bpstat_note_stop_all_threads (tp->control.stop_bpstat);
+	      stop_all_threads ();
+	    }
 
 	  set_step_over_info (regcache->aspace (),
 			      regcache_read_pc (regcache), 0, tp->global_num);
@@ -7545,7 +7548,10 @@ keep_going_pass_signal (struct execution_control_state *ecs)
 	 we're about to step over, otherwise other threads could miss
 	 it.  */
       if (step_over_info_valid_p () && target_is_non_stop_p ())
-	stop_all_threads ();
+	{
+	  bpstat_note_stop_all_threads (ecs->event_thread->control.stop_bpstat);
+	  stop_all_threads ();
+	}
 
       /* Stop stepping if inserting breakpoints fails.  */
       try
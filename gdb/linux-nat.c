@@ -67,6 +67,9 @@
 #include "nat/linux-namespaces.h"
 #include "common/fileio.h"
 #include "common/scope-exit.h"
+#include "maint.h"
+#include <chrono>
+#include <unordered_set>
 
 #ifndef SPUFS_MAGIC
 #define SPUFS_MAGIC 0x23c9b64e
@@ -813,6 +816,8 @@ linux_nat_target::pass_signals
 
 /* Prototypes for local functions.  */
 static int stop_wait_callback (struct lwp_info *lp);
+static void stop_and_wait_lwps (ptid_t filter);
+static struct lwp_info *linux_nat_filter_event (int lwpid, int status);
 static int resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid);
 static int check_ptrace_stopped_lwp_gone (struct lwp_info *lp);
 
@@ -1513,10 +1518,7 @@ linux_nat_target::detach (inferior *inf, int from_tty)
 
   /* Stop all threads before detaching.  ptrace requires that the
      thread is stopped to sucessfully detach.  */
-  iterate_over_lwps (ptid_t (pid), stop_callback);
-  /* ... and wait until all of them have reported back that
-     they're no longer running.  */
-  iterate_over_lwps (ptid_t (pid), stop_wait_callback);
+  stop_and_wait_lwps (ptid_t (pid));
 
   iterate_over_lwps (ptid_t (pid), detach_callback);
 
@@ -2196,6 +2198,8 @@ wait_for_signal ()
     }
 }
 
+static int wait_lwp_status (struct lwp_info *lp, int status);
+
 /* Wait for LP to stop.  Returns the wait status, or 0 if the LWP has
    exited.  */
 
@@ -2266,45 +2270,58 @@ wait_lwp (struct lwp_info *lp)
 
   restore_child_signals_mask (&prev_mask);
 
-  if (!thread_dead)
+  if (thread_dead)
     {
-      gdb_assert (pid == lp->ptid.lwp ());
+      exit_lwp (lp);
+      return 0;
+    }
 
-      if (debug_linux_nat)
-	{
-	  fprintf_unfiltered (gdb_stdlog,
-			      "WL: waitpid %s received %s\n",
-			      target_pid_to_str (lp->ptid).c_str (),
-			      status_to_str (status));
-	}
+  gdb_assert (pid == lp->ptid.lwp ());
 
-      /* Check if the thread has exited.  */
-      if (WIFEXITED (status) || WIFSIGNALED (status))
-	{
-	  if (report_thread_events
-	      || lp->ptid.pid () == lp->ptid.lwp ())
-	    {
-	      if (debug_linux_nat)
-		fprintf_unfiltered (gdb_stdlog, "WL: LWP %d exited.\n",
-				    lp->ptid.pid ());
-
-	      /* If this is the leader exiting, it means the whole
-		 process is gone.  Store the status to report to the
-		 core.  Store it in lp->waitstatus, because lp->status
-		 would be ambiguous (W_EXITCODE(0,0) == 0).  */
-	      store_waitstatus (&lp->waitstatus, status);
-	      return 0;
-	    }
+  status = wait_lwp_status (lp, status);
+  if (status == -1)
+    return wait_lwp (lp);
 
-	  thread_dead = 1;
-	  if (debug_linux_nat)
-	    fprintf_unfiltered (gdb_stdlog, "WL: %s exited.\n",
-				target_pid_to_str (lp->ptid).c_str ());
-	}
+  return status;
+}
+
+/* Handle STATUS, which waitpid returned for LP, on behalf of wait_lwp
+   or stop_and_wait_lwps.  Return the stop status to handle, 0 if
+   there is none (LP may have been deleted then), or -1 if LP was
+   resumed and must be waited for again.  */
+
+static int
+wait_lwp_status (struct lwp_info *lp, int status)
+{
+  if (debug_linux_nat)
+    {
+      fprintf_unfiltered (gdb_stdlog,
+			  "WL: waitpid %s received %s\n",
+			  target_pid_to_str (lp->ptid).c_str (),
+			  status_to_str (status));
     }
 
-  if (thread_dead)
+  /* Check if the thread has exited.  */
+  if (WIFEXITED (status) || WIFSIGNALED (status))
     {
+      if (report_thread_events
+	  || lp->ptid.pid () == lp->ptid.lwp ())
+	{
+	  if (debug_linux_nat)
+	    fprintf_unfiltered (gdb_stdlog, "WL: LWP %d exited.\n",
+				lp->ptid.pid ());
+
+	  /* If this is the leader exiting, it means the whole
+	     process is gone.  Store the status to report to the
+	     core.  Store it in lp->waitstatus, because lp->status
+	     would be ambiguous (W_EXITCODE(0,0) == 0).  */
+	  store_waitstatus (&lp->waitstatus, status);
+	  return 0;
+	}
+
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog, "WL: %s exited.\n",
+			    target_pid_to_str (lp->ptid).c_str ());
       exit_lwp (lp);
       return 0;
     }
@@ -2330,7 +2347,7 @@ wait_lwp (struct lwp_info *lp)
 	 on.  */
       status = W_STOPCODE (SIGTRAP);
       if (linux_handle_syscall_trap (lp, 1))
-	return wait_lwp (lp);
+	return -1;
     }
   else
     {
@@ -2399,12 +2416,9 @@ linux_stop_lwp (struct lwp_info *lwp)
 void
 linux_stop_and_wait_all_lwps (void)
 {
-  /* Stop all LWP's ...  */
-  iterate_over_lwps (minus_one_ptid, stop_callback);
-
-  /* ... and wait until all of them have reported back that
-     they're no longer running.  */
-  iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+  /* Stop all LWP's, and wait until all of them have reported back
+     that they're no longer running.  */
+  stop_and_wait_lwps (minus_one_ptid);
 }
 
 /* See linux-nat.h  */
@@ -2536,6 +2550,69 @@ linux_nat_target::low_status_is_event (int status)
   return WIFSTOPPED (status) && WSTOPSIG (status) == SIGTRAP;
 }
 
+/* Record STATUS, the stop of LP that wait_lwp returned while waiting
+   for LP to stop after a SIGSTOP.  If the stop is a SIGINT to ignore,
+   resume LP instead, leaving it to be waited for again.  */
+
+static void
+stop_wait_status (struct lwp_info *lp, int status)
+{
+  if (lp->ignore_sigint && WIFSTOPPED (status)
+      && WSTOPSIG (status) == SIGINT)
+    {
+      lp->ignore_sigint = 0;
+
+      errno = 0;
+      ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
+      lp->stopped = 0;
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "PTRACE_CONT %s, 0, 0 (%s) "
+			    "(discarding SIGINT)\n",
+			    target_pid_to_str (lp->ptid).c_str (),
+			    errno ? safe_strerror (errno) : "OK");
+      return;
+    }
+
+  maybe_clear_ignore_sigint (lp);
+
+  if (WSTOPSIG (status) != SIGSTOP)
+    {
+      /* The thread was stopped with a signal other than SIGSTOP.  */
+
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "SWC: Pending event %s in %s\n",
+			    status_to_str ((int) status),
+			    target_pid_to_str (lp->ptid).c_str ());
+
+      /* Save the sigtrap event.  */
+      lp->status = status;
+      gdb_assert (lp->signalled);
+      save_stop_reason (lp);
+    }
+  else
+    {
+      /* We caught the SIGSTOP that we intended to catch.  */
+
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "SWC: Expected SIGSTOP caught for %s.\n",
+			    target_pid_to_str (lp->ptid).c_str ());
+
+      lp->signalled = 0;
+
+      /* If we are waiting for this stop so we can report the thread
+	 stopped then we need to record this status.  Otherwise, we can
+	 now discard this stop event.  */
+      if (lp->last_resume_kind == resume_stop)
+	{
+	  lp->status = status;
+	  save_stop_reason (lp);
+	}
+    }
+}
+
 /* Wait until LP is stopped.  */
 
 static int
@@ -2548,7 +2625,7 @@ stop_wait_callback (struct lwp_info *lp)
   if (inf->vfork_child != NULL)
     return 0;
 
-  if (!lp->stopped)
+  while (!lp->stopped)
     {
       int status;
 
@@ -2556,64 +2633,182 @@ stop_wait_callback (struct lwp_info *lp)
       if (status == 0)
 	return 0;
 
-      if (lp->ignore_sigint && WIFSTOPPED (status)
-	  && WSTOPSIG (status) == SIGINT)
-	{
-	  lp->ignore_sigint = 0;
+      stop_wait_status (lp, status);
+    }
 
-	  errno = 0;
-	  ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
-	  lp->stopped = 0;
-	  if (debug_linux_nat)
-	    fprintf_unfiltered (gdb_stdlog,
-				"PTRACE_CONT %s, 0, 0 (%s) "
-				"(discarding SIGINT)\n",
-				target_pid_to_str (lp->ptid).c_str (),
-				errno ? safe_strerror (errno) : "OK");
+  return 0;
+}
 
-	  return stop_wait_callback (lp);
-	}
+/* Handle STATUS, which waitpid returned for LP while
+   stop_and_wait_lwps waits for LP to stop.  Return true if LP no
+   longer needs waiting for; LP may have been deleted then.  */
 
-      maybe_clear_ignore_sigint (lp);
+static bool
+stop_wait_lwp_event (struct lwp_info *lp, int status)
+{
+  status = wait_lwp_status (lp, status);
+  if (status == -1)
+    return false;
+  if (status == 0)
+    return true;
 
-      if (WSTOPSIG (status) != SIGSTOP)
-	{
-	  /* The thread was stopped with a signal other than SIGSTOP.  */
+  stop_wait_status (lp, status);
+  return lp->stopped;
+}
 
-	  if (debug_linux_nat)
-	    fprintf_unfiltered (gdb_stdlog,
-				"SWC: Pending event %s in %s\n",
-				status_to_str ((int) status),
-				target_pid_to_str (lp->ptid).c_str ());
+/* Stop all the LWPs matching FILTER, and wait until they have
+   stopped.  A SIGSTOP is sent to every running LWP first, so that they
+   all stop concurrently; then, instead of waiting for each LWP in
+   turn as iterate_over_lwps (FILTER, stop_wait_callback) would, the
+   stops of all the LWPs are reaped with waitpid (-1) in the order they
+   arrive, which matters when there are thousands of LWPs.  Events of
+   LWPs that are not waited for are handled as linux_nat_wait_1
+   would.  */
 
-	  /* Save the sigtrap event.  */
-	  lp->status = status;
-	  gdb_assert (lp->signalled);
-	  save_stop_reason (lp);
-	}
-      else
+static void
+stop_and_wait_lwps (ptid_t filter)
+{
+  using namespace std::chrono;
+
+  steady_clock::time_point start = steady_clock::now ();
+  std::unordered_set<struct lwp_info *> pending;
+  bool batch = true;
+
+  /* Send all the stops before reaping any of them.  */
+  iterate_over_lwps (filter, stop_callback);
+
+  for (lwp_info *lp = lwp_list; lp != NULL; lp = lp->next)
+    {
+      if (!lp->ptid.matches (filter) || lp->stopped)
+	continue;
+
+      /* See stop_wait_callback.  */
+      if (find_inferior_ptid (lp->ptid)->vfork_child != NULL)
+	continue;
+
+      pending.insert (lp);
+    }
+
+  /* After a non-leader thread execs, the other threads are gone
+     without reporting an exit.  Only waiting for each LWP finds out
+     about those, so leave that case to stop_wait_callback.  */
+  for (lwp_info *lp = lwp_list; lp != NULL; lp = lp->next)
+    if (lp->waitstatus.kind == TARGET_WAITKIND_EXECD)
+      batch = false;
+
+  int num_stopped = pending.size ();
+
+  if (num_stopped < 2)
+    batch = false;
+
+  if (!batch)
+    iterate_over_lwps (filter, stop_wait_callback);
+  else
+    {
+      sigset_t prev_mask;
+      bool saw_exec = false;
+
+      block_child_signals (&prev_mask);
+
+      while (!pending.empty ())
 	{
-	  /* We caught the SIGSTOP that we intended to catch.  */
+	  int status;
+	  int lwpid = my_waitpid (-1, &status, __WALL | WNOHANG);
 
-	  if (debug_linux_nat)
-	    fprintf_unfiltered (gdb_stdlog,
-				"SWC: Expected SIGSTOP caught for %s.\n",
-				target_pid_to_str (lp->ptid).c_str ());
+	  if (lwpid > 0)
+	    {
+	      struct lwp_info *lp = find_lwp_pid (ptid_t (lwpid));
 
-	  lp->signalled = 0;
+	      if (WIFSTOPPED (status)
+		  && linux_ptrace_get_extended_event (status)
+		     == PTRACE_EVENT_EXEC)
+		saw_exec = true;
+
+	      if (lp != NULL && pending.erase (lp) != 0)
+		{
+		  if (!stop_wait_lwp_event (lp, status))
+		    pending.insert (lp);
+		}
+	      else
+		linux_nat_filter_event (lwpid, status);
+	      continue;
+	    }
+
+	  if (lwpid == -1 && errno == ECHILD)
+	    {
+	      /* None of the LWPs is left.  */
+	      for (lwp_info *lp : pending)
+		{
+		  if (debug_linux_nat)
+		    fprintf_unfiltered (gdb_stdlog, "SWL: %s vanished.\n",
+					target_pid_to_str (lp->ptid).c_str ());
+		  exit_lwp (lp);
+		}
+	      break;
+	    }
 
-	  /* If we are waiting for this stop so we can report the thread
-	     stopped then we need to record this status.  Otherwise, we can
-	     now discard this stop event.  */
-	  if (lp->last_resume_kind == resume_stop)
+	  /* Nothing to reap.  A thread group leader that is a zombie
+	     does not report until the other threads are gone (see
+	     wait_lwp), and after an exec the other threads vanish;
+	     check for those before waiting for the next SIGCHLD.  */
+	  bool progress = false;
+	  std::vector<lwp_info *> check (pending.begin (), pending.end ());
+	  for (lwp_info *lp : check)
 	    {
-	      lp->status = status;
-	      save_stop_reason (lp);
+	      bool dead = false;
+
+	      if (saw_exec)
+		{
+		  int lwp_status;
+		  int ret = my_waitpid (lp->ptid.lwp (), &lwp_status,
+					__WALL | WNOHANG);
+
+		  if (ret == -1 && errno == ECHILD)
+		    dead = true;
+		  else if (ret > 0)
+		    {
+		      pending.erase (lp);
+		      if (!stop_wait_lwp_event (lp, lwp_status))
+			pending.insert (lp);
+		      progress = true;
+		      continue;
+		    }
+		}
+
+	      if (lp->ptid.pid () == lp->ptid.lwp ()
+		  && linux_proc_pid_is_zombie (lp->ptid.lwp ()))
+		dead = true;
+
+	      if (dead)
+		{
+		  if (debug_linux_nat)
+		    fprintf_unfiltered (gdb_stdlog, "SWL: %s vanished.\n",
+					target_pid_to_str (lp->ptid).c_str ());
+		  pending.erase (lp);
+		  exit_lwp (lp);
+		  progress = true;
+		}
 	    }
+
+	  if (!progress)
+	    wait_for_signal ();
 	}
+
+      restore_child_signals_mask (&prev_mask);
     }
 
-  return 0;
+  if (num_stopped == 0)
+    return;
+
+  steady_clock::duration elapsed = steady_clock::now () - start;
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"SWL: waited for %d LWPs in %.6f seconds (%s)\n",
+			num_stopped, duration<double> (elapsed).count (),
+			batch ? "batched" : "one by one");
+
+  record_thread_stop_time (num_stopped, elapsed);
 }
 
 /* Return non-zero if LP has a wait status pending.  Discard the
@@ -3448,12 +3643,9 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 
   if (!target_is_non_stop_p ())
     {
-      /* Now stop all other LWP's ...  */
-      iterate_over_lwps (minus_one_ptid, stop_callback);
-
-      /* ... and wait until all of them have reported back that
-	 they're no longer running.  */
-      iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+      /* Now stop all other LWP's, and wait until all of them have
+	 reported back that they're no longer running.  */
+      stop_and_wait_lwps (minus_one_ptid);
     }
 
   /* If we're not waiting for a specific LWP, choose an event LWP from
@@ -3782,10 +3974,7 @@ linux_nat_target::kill ()
 
       /* Stop all threads before killing them, since ptrace requires
 	 that the thread is stopped to sucessfully PTRACE_KILL.  */
-      iterate_over_lwps (ptid, stop_callback);
-      /* ... and wait until all of them have reported back that
-	 they're no longer running.  */
-      iterate_over_lwps (ptid, stop_wait_callback);
+      stop_and_wait_lwps (ptid);
 
       /* Kill all LWP's ...  */
       iterate_over_lwps (ptid, kill_callback);
@@ -39,6 +39,7 @@
 #include "top.h"
 #include "maint.h"
 #include "common/selftest.h"
+#include "common/thread-pool.h"
 
 #include "cli/cli-decode.h"
 #include "cli/cli-utils.h"
@@ -747,6 +748,33 @@ set_per_command_time (int new_value)
   per_command_time = new_value;
 }
 
+/* See maint.h.  */
+
+bool
+per_command_time_p ()
+{
+  return per_command_time != 0;
+}
+
+/* The number of times threads were stopped during the current
+   command, the number of threads stopped and the time it took, see
+   record_thread_stop_time.  */
+
+static int thread_stop_count;
+static int thread_stop_threads;
+static std::chrono::steady_clock::duration thread_stop_time;
+
+/* See maint.h.  */
+
+void
+record_thread_stop_time (int num_threads,
+			 std::chrono::steady_clock::duration elapsed)
+{
+  thread_stop_count++;
+  thread_stop_threads += num_threads;
+  thread_stop_time += elapsed;
+}
+
 /* Set whether to display space statistics to NEW_VALUE
    (non-zero means true).  */
 
@@ -823,6 +851,12 @@ scoped_command_stats::~scoped_command_stats ()
 			 : _("Command execution time: %.6f (cpu), %.6f (wall)\n"),
 			 duration<double> (cmd_time).count (),
 			 duration<double> (wall_time).count ());
+
+      if (m_msg_type && thread_stop_count > 0)
+	printf_unfiltered (_("Stopping threads took %.6f seconds "
+			     "(%d times, %d threads)\n"),
+			   duration<double> (thread_stop_time).count (),
+			   thread_stop_count, thread_stop_threads);
     }
 
   if (m_space_enabled && per_command_space)
@@ -881,6 +915,10 @@ scoped_command_stats::scoped_command_stats (bool msg_type)
       m_start_cpu_time = run_time_clock::now ();
       m_start_wall_time = steady_clock::now ();
       m_time_enabled = 1;
+
+      thread_stop_count = 0;
+      thread_stop_threads = 0;
+      thread_stop_time = steady_clock::duration::zero ();
     }
   else
     m_time_enabled = 0;
@@ -960,6 +998,49 @@ Selftests have been disabled for this build.\n"));
 #endif
 }
 
+/* The number of worker threads to use; -1 means use the number of
+   threads the host supports.  */
+
+static int n_worker_threads = -1;
+
+/* Update the thread pool for the desired number of threads.  */
+
+static void
+update_thread_pool_size ()
+{
+#if CXX_STD_THREAD
+  int n_threads = n_worker_threads;
+
+  if (n_threads < 0)
+    n_threads = std::thread::hardware_concurrency ();
+
+  gdb::thread_pool::g_thread_pool->set_thread_count (n_threads);
+#endif
+}
+
+static void
+maintenance_set_worker_threads (const char *args, int from_tty,
+				struct cmd_list_element *c)
+{
+  update_thread_pool_size ();
+}
+
+static void
+maintenance_show_worker_threads (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+#if CXX_STD_THREAD
+  if (n_worker_threads == -1)
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is unlimited (currently %zu).\n"),
+		      gdb::thread_pool::g_thread_pool->thread_count ());
+  else
+#endif
+    fprintf_filtered (file, _("The number of worker threads GDB "
+			      "can use is %s.\n"), value);
+}
+
 
 void
 _initialize_maint_cmds (void)
@@ -1167,4 +1248,18 @@ When enabled GDB is profiled."),
 			   show_maintenance_profile_p,
 			   &maintenance_set_cmdlist,
 			   &maintenance_show_cmdlist);
+
+  add_setshow_zuinteger_unlimited_cmd ("worker-threads",
+				       class_maintenance,
+				       &n_worker_threads, _("\
+Set the number of worker threads GDB can use."), _("\
+Show the number of worker threads GDB can use."), _("\
+GDB may use multiple threads to speed up certain CPU-intensive and\n\
+I/O-bound operations, such as writing core files."),
+				       maintenance_set_worker_threads,
+				       maintenance_show_worker_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+
+  update_thread_pool_size ();
 }
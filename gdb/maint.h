@@ -24,8 +24,19 @@
 
 extern void set_per_command_time (int);
 
+/* Return true if "maint set per-command time" is on.  */
+
+extern bool per_command_time_p ();
+
 extern void set_per_command_space (int);
 
+/* Record that stopping NUM_THREADS threads took ELAPSED.  The total
+   for the current command is part of the "maint set per-command time"
+   report.  */
+
+extern void record_thread_stop_time
+  (int num_threads, std::chrono::steady_clock::duration elapsed);
+
 /* Records a run time and space usage to be used as a base for
    reporting elapsed time or change in space.  */
 
@@ -143,6 +143,7 @@ static struct mi_cmd mi_cmds[] =
   DEF_MI_CMD_MI ("stack-list-variables", mi_cmd_stack_list_variables),
   DEF_MI_CMD_MI_1 ("stack-select-frame", mi_cmd_stack_select_frame,
 		   &mi_suppress_notification.user_selected_context),
+  DEF_MI_CMD_MI ("symbol-info-pcs", mi_cmd_symbol_info_pcs),
   DEF_MI_CMD_MI ("symbol-list-lines", mi_cmd_symbol_list_lines),
   DEF_MI_CMD_CLI ("target-attach", "attach", 1),
   DEF_MI_CMD_MI ("target-detach", mi_cmd_target_detach),
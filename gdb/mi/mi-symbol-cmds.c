@@ -21,6 +21,8 @@
 #include "symtab.h"
 #include "objfiles.h"
 #include "ui-out.h"
+#include "source.h"
+#include "arch-utils.h"
 
 /* Print the list of all pc addresses and lines of code for the
    provided (full or base) source file name.  The entries are sorted
@@ -59,3 +61,51 @@ mi_cmd_symbol_list_lines (const char *command, char **argv, int argc)
       uiout->field_int ("line", SYMTAB_LINETABLE (s)->item[i].line);
     }
 }
+
+/* Print the function, file, line and inline chain of each of the
+   given addresses, in the order they are given.  */
+
+void
+mi_cmd_symbol_info_pcs (const char *command, char **argv, int argc)
+{
+  struct ui_out *uiout = current_uiout;
+  struct gdbarch *gdbarch = get_current_arch ();
+
+  if (argc < 1)
+    error (_("-symbol-info-pcs: Usage: ADDR..."));
+
+  std::vector<CORE_ADDR> pcs (argc);
+  for (int i = 0; i < argc; i++)
+    pcs[i] = string_to_core_addr (argv[i]);
+
+  std::vector<pc_symbolization> syms = symbolize_pcs (pcs);
+
+  ui_out_emit_list list_emitter (uiout, "pcs");
+  for (int i = 0; i < argc; i++)
+    {
+      const pc_symbolization &sym = syms[i];
+      ui_out_emit_tuple tuple_emitter (uiout, NULL);
+
+      uiout->field_core_addr ("addr", gdbarch, pcs[i]);
+      if (!sym.functions.empty ())
+	uiout->field_string ("func", SYMBOL_PRINT_NAME (sym.functions[0]));
+      else if (sym.msymbol.minsym != NULL)
+	uiout->field_string ("func",
+			     MSYMBOL_PRINT_NAME (sym.msymbol.minsym));
+      if (sym.sal.symtab != NULL)
+	{
+	  uiout->field_string ("file",
+			       symtab_to_filename_for_display (sym.sal.symtab));
+	  uiout->field_string ("fullname",
+			       symtab_to_fullname (sym.sal.symtab));
+	  uiout->field_int ("line", sym.sal.line);
+	}
+      if (!sym.functions.empty ())
+	{
+	  ui_out_emit_list chain_emitter (uiout, "inline-chain");
+
+	  for (struct symbol *function : sym.functions)
+	    uiout->field_string (NULL, SYMBOL_PRINT_NAME (function));
+	}
+    }
+}
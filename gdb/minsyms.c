@@ -52,6 +52,7 @@
 #include "cli/cli-utils.h"
 #include "common/symbol.h"
 #include <algorithm>
+#include <unordered_map>
 #include "safe-ctype.h"
 
 /* See minsyms.h.  */
@@ -1479,3 +1480,298 @@ minimal_symbol_upper_bound (struct bound_minimal_symbol minsym)
 
   return result;
 }
+
+/* The minimal symbol table of an objfile, as saved in the index
+   cache by serialize_minimal_symbols.  It is written in host byte
+   order, and is only meant to be read back by the same build of GDB:
+
+     the magic MINSYM_CACHE_MAGIC
+     the length of the key, and the key
+     a minsym_cache_header
+     the bucket heads of the name hash table, then of the demangled
+       name hash table, as indexes in the table
+     COUNT minsym_cache_entry
+     the strings, each terminated by a zero byte
+
+   Indexes and string offsets are 32-bit; -1 stands for NULL.  */
+
+#define MINSYM_CACHE_MAGIC "GDBMSYM1"
+
+struct minsym_cache_header
+{
+  uint32_t count;
+  uint32_t n_minsyms;
+  uint64_t demangled_hash_languages;
+  uint32_t strings_size;
+};
+
+struct minsym_cache_entry
+{
+  uint64_t address;
+  uint64_t size;
+
+  uint32_t name;
+  uint32_t demangled_name;
+  uint32_t filename;
+
+  uint32_t hash_next;
+  uint32_t demangled_hash_next;
+
+  int16_t section;
+  uint8_t language;
+  uint8_t type;
+
+  /* created_by_gdb, target_flag_1, target_flag_2 and has_size, from the
+     lowest bit up.  */
+  uint8_t flags;
+};
+
+gdb_static_assert (nr_languages <= 64);
+
+/* Append the bytes of VALUE to OUT.  */
+
+template<typename T>
+static void
+minsym_cache_append (gdb::byte_vector *out, const T &value)
+{
+  const gdb_byte *p = (const gdb_byte *) &value;
+
+  out->insert (out->end (), p, p + sizeof (value));
+}
+
+/* Read a T at *POS of DATA into VALUE, and advance *POS.  Return false
+   if DATA is too short.  */
+
+template<typename T>
+static bool
+minsym_cache_read (gdb::array_view<const gdb_byte> data, size_t *pos,
+		   T *value)
+{
+  if (data.size () - *pos < sizeof (T))
+    return false;
+  memcpy (value, data.data () + *pos, sizeof (T));
+  *pos += sizeof (T);
+  return true;
+}
+
+/* See minsyms.h.  */
+
+gdb::byte_vector
+serialize_minimal_symbols (struct objfile *objfile, const std::string &key)
+{
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  minimal_symbol *msymbols = per_bfd->msymbols.get ();
+  size_t count = per_bfd->minimal_symbol_count;
+  gdb::byte_vector out;
+
+  if (count == 0 || count >= (uint32_t) -1)
+    return out;
+
+  /* Offsets of the strings already in the string table.  Most names
+     are unique, but file names are shared.  */
+  std::unordered_map<const char *, uint32_t> offsets;
+  std::string strings;
+  bool overflow = false;
+
+  auto add_string = [&] (const char *str) -> uint32_t
+    {
+      if (str == NULL)
+	return (uint32_t) -1;
+
+      auto it = offsets.find (str);
+      if (it != offsets.end ())
+	return it->second;
+
+      size_t offset = strings.size ();
+      if (offset >= (uint32_t) -1)
+	{
+	  overflow = true;
+	  return 0;
+	}
+      strings.append (str, strlen (str) + 1);
+      offsets.emplace (str, offset);
+      return offset;
+    };
+
+  auto index_of = [&] (const minimal_symbol *msym) -> uint32_t
+    {
+      return msym == NULL ? (uint32_t) -1 : msym - msymbols;
+    };
+
+  std::vector<minsym_cache_entry> entries (count);
+
+  for (size_t i = 0; i < count; i++)
+    {
+      const minimal_symbol *msym = &msymbols[i];
+      minsym_cache_entry &entry = entries[i];
+
+      memset (&entry, 0, sizeof (entry));
+      entry.address = msym->value.address;
+      entry.size = msym->size;
+      entry.name = add_string (msym->name);
+      entry.demangled_name = add_string (symbol_get_demangled_name (msym));
+      entry.filename = add_string (msym->filename);
+      entry.hash_next = index_of (msym->hash_next);
+      entry.demangled_hash_next = index_of (msym->demangled_hash_next);
+      entry.section = msym->section;
+      entry.language = msym->language;
+      entry.type = msym->type;
+      entry.flags = (msym->created_by_gdb
+		     | (msym->target_flag_1 << 1)
+		     | (msym->target_flag_2 << 2)
+		     | (msym->has_size << 3));
+    }
+
+  if (overflow)
+    return out;
+
+  minsym_cache_header header;
+
+  memset (&header, 0, sizeof (header));
+  header.count = count;
+  header.n_minsyms = per_bfd->n_minsyms;
+  header.demangled_hash_languages
+    = per_bfd->demangled_hash_languages.to_ullong ();
+  header.strings_size = strings.size ();
+
+  out.insert (out.end (), MINSYM_CACHE_MAGIC,
+	      MINSYM_CACHE_MAGIC + strlen (MINSYM_CACHE_MAGIC));
+  minsym_cache_append (&out, (uint32_t) key.size ());
+  out.insert (out.end (), key.begin (), key.end ());
+  minsym_cache_append (&out, header);
+  for (int i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
+    minsym_cache_append (&out, index_of (per_bfd->msymbol_hash[i]));
+  for (int i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
+    minsym_cache_append (&out, index_of (per_bfd->msymbol_demangled_hash[i]));
+  for (const minsym_cache_entry &entry : entries)
+    minsym_cache_append (&out, entry);
+  out.insert (out.end (), strings.begin (), strings.end ());
+
+  return out;
+}
+
+/* See minsyms.h.  */
+
+bool
+install_cached_minimal_symbols (struct objfile *objfile,
+				gdb::array_view<const gdb_byte> data,
+				const std::string &key)
+{
+  objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+  const size_t magic_len = strlen (MINSYM_CACHE_MAGIC);
+  size_t pos = 0;
+  uint32_t key_len;
+  minsym_cache_header header;
+
+  gdb_assert (per_bfd->minimal_symbol_count == 0);
+
+  if (data.size () < magic_len
+      || memcmp (data.data (), MINSYM_CACHE_MAGIC, magic_len) != 0)
+    return false;
+  pos = magic_len;
+
+  if (!minsym_cache_read (data, &pos, &key_len)
+      || data.size () - pos < key_len
+      || key.compare (0, std::string::npos,
+		      (const char *) data.data () + pos, key_len) != 0)
+    return false;
+  pos += key_len;
+
+  if (!minsym_cache_read (data, &pos, &header) || header.count == 0)
+    return false;
+
+  /* Check the sizes before reading anything else.  */
+  size_t tables_size = (2 * MINIMAL_SYMBOL_HASH_SIZE * sizeof (uint32_t)
+			+ (size_t) header.count * sizeof (minsym_cache_entry));
+  if (data.size () - pos < tables_size
+      || data.size () - pos - tables_size != header.strings_size
+      || header.strings_size == 0
+      || data[data.size () - 1] != '\0')
+    return false;
+
+  std::vector<uint32_t> buckets (2 * MINIMAL_SYMBOL_HASH_SIZE);
+  for (uint32_t &bucket : buckets)
+    {
+      minsym_cache_read (data, &pos, &bucket);
+      if (bucket != (uint32_t) -1 && bucket >= header.count)
+	return false;
+    }
+
+  gdb::unique_xmalloc_ptr<minimal_symbol>
+    msym_holder (XCNEWVEC (minimal_symbol, header.count));
+  minimal_symbol *msymbols = msym_holder.get ();
+  const char *strings
+    = (const char *) data.data () + data.size () - header.strings_size;
+
+  auto symbol_at = [&] (uint32_t index) -> minimal_symbol *
+    {
+      return index == (uint32_t) -1 ? NULL : &msymbols[index];
+    };
+
+  std::vector<minsym_cache_entry> entries (header.count);
+  for (minsym_cache_entry &entry : entries)
+    {
+      minsym_cache_read (data, &pos, &entry);
+
+      if (entry.name >= header.strings_size
+	  || (entry.demangled_name != (uint32_t) -1
+	      && entry.demangled_name >= header.strings_size)
+	  || (entry.filename != (uint32_t) -1
+	      && entry.filename >= header.strings_size)
+	  || (entry.hash_next != (uint32_t) -1
+	      && entry.hash_next >= header.count)
+	  || (entry.demangled_hash_next != (uint32_t) -1
+	      && entry.demangled_hash_next >= header.count)
+	  || entry.language >= nr_languages
+	  || entry.type >= nr_minsym_types)
+	return false;
+    }
+
+  /* Now that the entries are known to be valid, copy the strings to
+     the per-BFD storage, where the names of minimal symbols read from
+     the file live too.  */
+  strings = (const char *) obstack_copy (&per_bfd->storage_obstack,
+					 strings, header.strings_size);
+
+  auto string_at = [&] (uint32_t offset) -> const char *
+    {
+      return offset == (uint32_t) -1 ? NULL : strings + offset;
+    };
+
+  for (size_t i = 0; i < header.count; i++)
+    {
+      const minsym_cache_entry &entry = entries[i];
+      minimal_symbol *msym = &msymbols[i];
+
+      msym->name = string_at (entry.name);
+      msym->value.address = entry.address;
+      msym->language = (enum language) entry.language;
+      symbol_set_demangled_name (msym, string_at (entry.demangled_name),
+				 &per_bfd->storage_obstack);
+      msym->section = entry.section;
+      msym->size = entry.size;
+      msym->filename = string_at (entry.filename);
+      msym->type = (enum minimal_symbol_type) entry.type;
+      msym->created_by_gdb = entry.flags & 1;
+      msym->target_flag_1 = (entry.flags >> 1) & 1;
+      msym->target_flag_2 = (entry.flags >> 2) & 1;
+      msym->has_size = (entry.flags >> 3) & 1;
+      msym->hash_next = symbol_at (entry.hash_next);
+      msym->demangled_hash_next = symbol_at (entry.demangled_hash_next);
+    }
+
+  for (int i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
+    {
+      per_bfd->msymbol_hash[i] = symbol_at (buckets[i]);
+      per_bfd->msymbol_demangled_hash[i]
+	= symbol_at (buckets[MINIMAL_SYMBOL_HASH_SIZE + i]);
+    }
+
+  per_bfd->demangled_hash_languages
+    = std::bitset<nr_languages> (header.demangled_hash_languages);
+  per_bfd->n_minsyms = header.n_minsyms;
+  per_bfd->minimal_symbol_count = header.count;
+  per_bfd->msymbols = std::move (msym_holder);
+
+  return true;
+}
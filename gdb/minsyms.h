@@ -20,6 +20,9 @@
 #ifndef MINSYMS_H
 #define MINSYMS_H
 
+#include "common/array-view.h"
+#include "common/byte-vector.h"
+
 struct type;
 
 /* Several lookup functions return both a minimal symbol and the
@@ -292,4 +295,21 @@ CORE_ADDR minimal_symbol_upper_bound (struct bound_minimal_symbol minsym);
 type *find_minsym_type_and_address (minimal_symbol *msymbol, objfile *objf,
 				    CORE_ADDR *address_p);
 
+/* Return the installed minimal symbols of OBJFILE, with their hash
+   tables, in the format of the index cache, or an empty vector if
+   there are none.  KEY identifies what they were read from;
+   install_cached_minimal_symbols only accepts the same key.  */
+
+gdb::byte_vector serialize_minimal_symbols (struct objfile *objfile,
+					    const std::string &key);
+
+/* Install the minimal symbols of OBJFILE from DATA, written by
+   serialize_minimal_symbols with KEY.  OBJFILE must have no minimal
+   symbols yet.  Return false, installing nothing, if DATA was written
+   with another key or is corrupt.  */
+
+bool install_cached_minimal_symbols (struct objfile *objfile,
+				     gdb::array_view<const gdb_byte> data,
+				     const std::string &key);
+
 #endif /* MINSYMS_H */
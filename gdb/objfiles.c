@@ -404,6 +404,7 @@ objfile::objfile (bfd *abfd, const char *name, objfile_flags flags_)
 	   last_one = last_one->next);
       last_one->next = this;
     }
+  pspace->add_objfile_name (this);
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (pspace)->new_objfiles_available = 1;
@@ -653,6 +654,10 @@ objfile::~objfile ()
      still may reference obfd.  */
   objfile_free_data (this);
 
+  /* The name index is keyed by objfile_name, which may point into
+     OBFD, so drop the entry before releasing the BFD.  */
+  pspace->remove_objfile_name (this);
+
   if (obfd)
     gdb_bfd_unref (obfd);
   else
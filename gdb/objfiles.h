@@ -30,6 +30,7 @@
 #include "psymtab.h"
 #include <bitset>
 #include <vector>
+#include <chrono>
 #include "common/next-iterator.h"
 #include "common/safe-iterator.h"
 #include "bcache.h"
@@ -173,6 +174,12 @@ struct objstats
 
   /* Size of stringtable, (if applicable).  */
   int sz_strtab = 0;
+
+  /* Number of compunit symtabs expanded, size of the debug information
+     they were expanded from, and time spent expanding them.  */
+  int n_expanded_units = 0;
+  ULONGEST sz_expanded = 0;
+  std::chrono::steady_clock::duration expansion_time {};
 };
 
 #define OBJSTAT(objfile, expr) (objfile -> stats.expr)
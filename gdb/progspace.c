@@ -153,6 +153,43 @@ program_space::~program_space ()
   program_space_free_data (this);
 }
 
+/* See progspace.h.  */
+
+void
+program_space::add_objfile_name (struct objfile *objf)
+{
+  objfiles_by_name.emplace (objfile_name (objf), objf);
+}
+
+/* See progspace.h.  */
+
+void
+program_space::remove_objfile_name (struct objfile *objf)
+{
+  auto range = objfiles_by_name.equal_range (objfile_name (objf));
+
+  for (auto iter = range.first; iter != range.second; ++iter)
+    if (iter->second == objf)
+      {
+	objfiles_by_name.erase (iter);
+	return;
+      }
+}
+
+/* See progspace.h.  */
+
+struct objfile *
+program_space::lookup_objfile_by_name (const char *name, CORE_ADDR addr_low)
+{
+  auto range = objfiles_by_name.equal_range (name);
+
+  for (auto iter = range.first; iter != range.second; ++iter)
+    if (iter->second->addr_low == addr_low)
+      return iter->second;
+
+  return NULL;
+}
+
 /* Copies program space SRC to DEST.  Copies the main executable file,
    and the main symbol file.  Returns DEST.  */
 
@@ -28,6 +28,9 @@
 #include "registry.h"
 #include "common/next-iterator.h"
 #include "common/safe-iterator.h"
+#include "filenames.h"
+#include <string>
+#include <unordered_map>
 
 struct target_ops;
 struct bfd;
@@ -166,6 +169,21 @@ struct program_space
     return objfiles_safe_range (objfiles_head);
   }
 
+  /* Record OBJF, which has just been linked into this program space,
+     in the objfile name index.  */
+  void add_objfile_name (struct objfile *objf);
+
+  /* Remove OBJF from the objfile name index.  This must be called
+     before OBJF's BFD is released, since the index is keyed by
+     objfile_name.  */
+  void remove_objfile_name (struct objfile *objf);
+
+  /* Return the objfile in this program space whose objfile_name is
+     NAME (compared with filename_cmp) and whose ADDR_LOW field is
+     ADDR_LOW, or NULL if there is none.  */
+  struct objfile *lookup_objfile_by_name (const char *name,
+					   CORE_ADDR addr_low);
+
   /* Pointer to next in linked list.  */
   struct program_space *next = NULL;
 
@@ -220,6 +238,32 @@ struct program_space
      the head of this list.  */
   struct objfile *objfiles_head = NULL;
 
+  /* Hash functions for the objfile name index, matching the
+     semantics of filename_cmp.  */
+  struct objfile_name_hash
+  {
+    size_t operator() (const std::string &name) const
+    {
+      return filename_hash (name.c_str ());
+    }
+  };
+
+  struct objfile_name_eq
+  {
+    bool operator() (const std::string &a, const std::string &b) const
+    {
+      return filename_eq (a.c_str (), b.c_str ());
+    }
+  };
+
+  /* Every objfile in OBJFILES_HEAD, indexed by objfile_name.  This
+     lets solib_read_symbols find an already-loaded library without
+     walking the whole objfile list.  Maintained by the objfile
+     constructor and destructor.  */
+  std::unordered_multimap<std::string, struct objfile *,
+			  objfile_name_hash, objfile_name_eq>
+    objfiles_by_name;
+
   /* The set of target sections matching the sections mapped into
      this program space.  Managed by both exec_ops and solib.c.  */
   struct target_section_table target_sections {};
@@ -1372,6 +1372,9 @@ psym_expand_symtabs_matching
       if (recursively_search_psymtabs (ps, objfile, domain,
 				       lookup_name, symbol_matcher))
 	{
+	  if (!ps->readin && symtab_expansion_budget_exhausted ())
+	    continue;
+
 	  struct compunit_symtab *symtab =
 	    psymtab_to_symtab (objfile, ps);
 
@@ -184,3 +184,9 @@ def find_pc_line(pc):
     """find_pc_line (pc) -> Symtab_and_line.
 Return the gdb.Symtab_and_line object corresponding to the pc value."""
     return current_progspace().find_pc_line(pc)
+
+def symbolize(pcs):
+    """symbolize (pcs) -> List.
+Return the (function, filename, line, inline_chain) tuple of each pc of
+the sequence pcs."""
+    return current_progspace().symbolize(pcs)
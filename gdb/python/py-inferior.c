@@ -857,6 +857,181 @@ infpy_search_memory (PyObject *self, PyObject *args, PyObject *kw)
     Py_RETURN_NONE;
 }
 
+/* Implementation of
+   gdb.search_memory_all (address, length, patterns [, max_count]).
+   ADDRESS and LENGTH are as for search_memory.  PATTERNS is a
+   sequence of patterns, each supporting the buffer protocol, which
+   are all searched for in a single pass over memory.  Returns a list
+   of (address, index) tuples, one for each match of PATTERNS[index],
+   by increasing address, with at most MAX_COUNT elements.  Returns
+   NULL on error, with a python exception set.  */
+static PyObject *
+infpy_search_memory_all (PyObject *self, PyObject *args, PyObject *kw)
+{
+  struct gdb_exception except = exception_none;
+  CORE_ADDR start_addr, length;
+  static const char *keywords[] = { "address", "length", "patterns",
+				    "max_count", NULL };
+  PyObject *start_addr_obj, *length_obj, *patterns_obj;
+  Py_ssize_t max_count = -1;
+  std::vector<gdb::byte_vector> patterns;
+  std::vector<std::pair<CORE_ADDR, size_t>> matches;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "OOO|n", keywords,
+					&start_addr_obj, &length_obj,
+					&patterns_obj, &max_count))
+    return NULL;
+
+  if (get_addr_from_python (start_addr_obj, &start_addr) < 0)
+    return nullptr;
+
+  if (get_addr_from_python (length_obj, &length) < 0)
+    return nullptr;
+
+  if (!length)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("Search range is empty."));
+      return nullptr;
+    }
+  /* Watch for overflows.  */
+  else if (length > CORE_ADDR_MAX
+	   || (start_addr + length - 1) < start_addr)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("The search range is too large."));
+      return nullptr;
+    }
+
+  gdbpy_ref<> iter (PyObject_GetIter (patterns_obj));
+  if (iter == nullptr)
+    return nullptr;
+  while (true)
+    {
+      gdbpy_ref<> item (PyIter_Next (iter.get ()));
+      if (item == nullptr)
+	{
+	  if (PyErr_Occurred ())
+	    return nullptr;
+	  break;
+	}
+
+      Py_buffer pybuf;
+      if (PyObject_GetBuffer (item.get (), &pybuf, PyBUF_SIMPLE) < 0)
+	return nullptr;
+      Py_buffer_up buffer_up (&pybuf);
+
+      if (pybuf.len == 0)
+	{
+	  PyErr_SetString (PyExc_ValueError, _("A pattern is empty."));
+	  return nullptr;
+	}
+      const gdb_byte *buffer = (const gdb_byte *) pybuf.buf;
+      patterns.emplace_back (buffer, buffer + pybuf.len);
+    }
+
+  if (patterns.empty ())
+    {
+      PyErr_SetString (PyExc_ValueError, _("There are no patterns."));
+      return nullptr;
+    }
+
+  try
+    {
+      search_memory_multi (start_addr, length, patterns,
+			   [&] (CORE_ADDR addr, size_t pattern)
+	{
+	  if (max_count >= 0 && matches.size () >= (size_t) max_count)
+	    return false;
+	  matches.emplace_back (addr, pattern);
+	  return true;
+	});
+    }
+  catch (const gdb_exception &ex)
+    {
+      except = ex;
+    }
+
+  GDB_PY_HANDLE_EXCEPTION (except);
+
+  gdbpy_ref<> result (PyList_New (matches.size ()));
+  if (result == nullptr)
+    return nullptr;
+
+  for (size_t i = 0; i < matches.size (); ++i)
+    {
+      gdbpy_ref<> addr (gdb_py_long_from_ulongest (matches[i].first));
+      if (addr == nullptr)
+	return nullptr;
+      gdbpy_ref<> index (PyInt_FromLong (matches[i].second));
+      if (index == nullptr)
+	return nullptr;
+      PyObject *match = PyTuple_Pack (2, addr.get (), index.get ());
+      if (match == nullptr)
+	return nullptr;
+      PyList_SET_ITEM (result.get (), i, match);
+    }
+
+  return result.release ();
+}
+
+/* Implementation of
+   gdb.Inferior.referrers (address [, length]) -> list.
+   Return the addresses of the core file memory holding pointers into
+   [ADDRESS, ADDRESS + LENGTH).  */
+
+static PyObject *
+infpy_referrers (PyObject *self, PyObject *args, PyObject *kw)
+{
+  struct gdb_exception except = exception_none;
+  CORE_ADDR addr, length = 1;
+  static const char *keywords[] = { "address", "length", NULL };
+  PyObject *addr_obj, *length_obj = nullptr;
+  std::vector<CORE_ADDR> referrers;
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "O|O", keywords,
+					&addr_obj, &length_obj))
+    return nullptr;
+
+  if (get_addr_from_python (addr_obj, &addr) < 0)
+    return nullptr;
+
+  if (length_obj != nullptr
+      && get_addr_from_python (length_obj, &length) < 0)
+    return nullptr;
+
+  if (!length)
+    {
+      PyErr_SetString (PyExc_ValueError, _("The range is empty."));
+      return nullptr;
+    }
+
+  try
+    {
+      referrers = core_file_referrers (addr, length);
+    }
+  catch (const gdb_exception &ex)
+    {
+      except = ex;
+    }
+
+  GDB_PY_HANDLE_EXCEPTION (except);
+
+  gdbpy_ref<> result (PyList_New (referrers.size ()));
+  if (result == nullptr)
+    return nullptr;
+
+  for (size_t i = 0; i < referrers.size (); ++i)
+    {
+      PyObject *referrer = gdb_py_long_from_ulongest (referrers[i]);
+      if (referrer == nullptr)
+	return nullptr;
+      PyList_SET_ITEM (result.get (), i, referrer);
+    }
+
+  return result.release ();
+}
+
 /* Implementation of gdb.Inferior.is_valid (self) -> Boolean.
    Returns True if this inferior object still exists in GDB.  */
 
@@ -1078,6 +1253,16 @@ Write the given buffer object to the inferior's memory." },
     METH_VARARGS | METH_KEYWORDS,
     "search_memory (address, length, pattern) -> long\n\
 Return a long with the address of a match, or None." },
+  { "search_memory_all", (PyCFunction) infpy_search_memory_all,
+    METH_VARARGS | METH_KEYWORDS,
+    "search_memory_all (address, length, patterns [, max_count]) -> list\n\
+Return a list of (address, index) tuples, one for each match of any\n\
+of the patterns." },
+  { "referrers", (PyCFunction) infpy_referrers,
+    METH_VARARGS | METH_KEYWORDS,
+    "referrers (address [, length]) -> list\n\
+Return a list of the addresses of the core file memory holding\n\
+pointers into the range." },
   /* thread_from_thread_handle is deprecated.  */
   { "thread_from_thread_handle", (PyCFunction) infpy_thread_from_thread_handle,
     METH_VARARGS | METH_KEYWORDS,
@@ -443,6 +443,43 @@ objfpy_has_symbols (PyObject *self, PyObject *args)
   Py_RETURN_FALSE;
 }
 
+/* Implementation of gdb.Objfile.expansion_stats (self) -> dict.
+   Returns the statistics of the symbol tables expanded from this
+   object file.  */
+
+static PyObject *
+objfpy_expansion_stats (PyObject *self, PyObject *args)
+{
+  objfile_object *obj = (objfile_object *) self;
+
+  OBJFPY_REQUIRE_VALID (obj);
+
+  struct objfile *objfile = obj->objfile;
+  std::chrono::duration<double> seconds = OBJSTAT (objfile, expansion_time);
+
+  gdbpy_ref<> result (PyDict_New ());
+  if (result == NULL)
+    return NULL;
+
+  gdbpy_ref<> units (PyInt_FromLong (OBJSTAT (objfile, n_expanded_units)));
+  if (units == NULL
+      || PyDict_SetItemString (result.get (), "units", units.get ()) < 0)
+    return NULL;
+
+  gdbpy_ref<> bytes
+    (gdb_py_long_from_ulongest (OBJSTAT (objfile, sz_expanded)));
+  if (bytes == NULL
+      || PyDict_SetItemString (result.get (), "bytes", bytes.get ()) < 0)
+    return NULL;
+
+  gdbpy_ref<> secs (PyFloat_FromDouble (seconds.count ()));
+  if (secs == NULL
+      || PyDict_SetItemString (result.get (), "seconds", secs.get ()) < 0)
+    return NULL;
+
+  return result.release ();
+}
+
 
 struct objfile *
 objfpy_object_to_objfile(PyObject *self)
@@ -697,6 +734,12 @@ Return true if this object file is valid, false if not." },
     "has_symbols () -> Boolean.\n\
 Return true if this object file has symbols associated with it." },
 
+  { "expansion_stats", objfpy_expansion_stats, METH_NOARGS,
+    "expansion_stats () -> Dictionary.\n\
+Return the number of symbol tables expanded from this object file, the\n\
+size of the debug information they were expanded from, and the time\n\
+spent expanding them." },
+
   { "add_separate_debug_file", (PyCFunction) objfpy_add_separate_debug_file,
     METH_VARARGS | METH_KEYWORDS,
     "add_separate_debug_file (file_name).\n\
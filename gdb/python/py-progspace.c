@@ -26,6 +26,7 @@
 #include "arch-utils.h"
 #include "solib.h"
 #include "block.h"
+#include "source.h"
 
 typedef struct
 {
@@ -444,6 +445,118 @@ pspy_find_pc_line (PyObject *o, PyObject *args)
   return result;
 }
 
+/* Return the name of NAME as a Python string, or None if NAME is
+   NULL.  */
+
+static gdbpy_ref<>
+pspy_name_or_none (const char *name)
+{
+  if (name == NULL)
+    {
+      Py_INCREF (Py_None);
+      return gdbpy_ref<> (Py_None);
+    }
+  return gdbpy_ref<> (PyString_FromString (name));
+}
+
+/* Return the tuple describing the symbolization SYM of a PC, for
+   pspy_symbolize.  */
+
+static gdbpy_ref<>
+pspy_symbolization_to_tuple (const pc_symbolization &sym)
+{
+  gdbpy_ref<> chain (PyTuple_New (sym.functions.size ()));
+  if (chain == NULL)
+    return NULL;
+  for (size_t i = 0; i < sym.functions.size (); i++)
+    {
+      gdbpy_ref<> name
+	= pspy_name_or_none (SYMBOL_PRINT_NAME (sym.functions[i]));
+      if (name == NULL)
+	return NULL;
+      PyTuple_SET_ITEM (chain.get (), i, name.release ());
+    }
+
+  const char *function = NULL;
+  if (!sym.functions.empty ())
+    function = SYMBOL_PRINT_NAME (sym.functions[0]);
+  else if (sym.msymbol.minsym != NULL)
+    function = MSYMBOL_PRINT_NAME (sym.msymbol.minsym);
+
+  gdbpy_ref<> function_obj = pspy_name_or_none (function);
+  if (function_obj == NULL)
+    return NULL;
+
+  gdbpy_ref<> filename
+    = pspy_name_or_none (sym.sal.symtab != NULL
+			 ? symtab_to_filename_for_display (sym.sal.symtab)
+			 : NULL);
+  if (filename == NULL)
+    return NULL;
+
+  gdbpy_ref<> line (PyInt_FromLong (sym.sal.line));
+  if (line == NULL)
+    return NULL;
+
+  return gdbpy_ref<> (PyTuple_Pack (4, function_obj.get (), filename.get (),
+				    line.get (), chain.get ()));
+}
+
+/* Implementation of symbolize (pcs) -> List.
+   Returns a list of (function, filename, line, inline_chain) tuples,
+   one for each PC in the sequence PCS.  */
+
+static PyObject *
+pspy_symbolize (PyObject *o, PyObject *args)
+{
+  pspace_object *self = (pspace_object *) o;
+  PyObject *pcs_obj;
+
+  PSPY_REQUIRE_VALID (self);
+
+  if (!PyArg_ParseTuple (args, "O", &pcs_obj))
+    return NULL;
+
+  gdbpy_ref<> seq (PySequence_Fast (pcs_obj,
+				    _("The PCs must be a sequence.")));
+  if (seq == NULL)
+    return NULL;
+
+  Py_ssize_t count = PySequence_Fast_GET_SIZE (seq.get ());
+  std::vector<CORE_ADDR> pcs (count);
+  for (Py_ssize_t i = 0; i < count; i++)
+    if (get_addr_from_python (PySequence_Fast_GET_ITEM (seq.get (), i),
+			      &pcs[i]) < 0)
+      return NULL;
+
+  std::vector<pc_symbolization> syms;
+  try
+    {
+      scoped_restore_current_program_space saver;
+
+      set_current_program_space (self->pspace);
+      syms = symbolize_pcs (pcs);
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  gdbpy_ref<> result (PyList_New (count));
+  if (result == NULL)
+    return NULL;
+
+  for (Py_ssize_t i = 0; i < count; i++)
+    {
+      gdbpy_ref<> item = pspy_symbolization_to_tuple (syms[i]);
+      if (item == NULL)
+	return NULL;
+      PyList_SET_ITEM (result.get (), i, item.release ());
+    }
+
+  return result.release ();
+}
+
 /* Implementation of is_valid (self) -> Boolean.
    Returns True if this program space still exists in GDB.  */
 
@@ -554,6 +667,10 @@ Return the name of the shared library holding a given address, or None." },
   { "find_pc_line", pspy_find_pc_line, METH_VARARGS,
     "find_pc_line (pc) -> Symtab_and_line.\n\
 Return the gdb.Symtab_and_line object corresponding to the pc value." },
+  { "symbolize", pspy_symbolize, METH_VARARGS,
+    "symbolize (pcs) -> List.\n\
+Return the (function, filename, line, inline_chain) tuple of each pc of\n\
+the sequence pcs." },
   { "is_valid", pspy_is_valid, METH_NOARGS,
     "is_valid () -> Boolean.\n\
 Return true if this program space is valid, false if not." },
@@ -64,6 +64,30 @@ static PyTypeObject btpy_list_type = {
   PyVarObject_HEAD_INIT (NULL, 0)
 };
 
+/* Python object for a column of btrace data, as returned by
+   BtraceList.to_arrays.  It exposes LENGTH elements of ITEMSIZE bytes
+   each through the buffer protocol.  */
+
+typedef struct {
+  PyObject_HEAD
+
+  /* The elements, allocated with xmalloc.  */
+  void *data;
+
+  /* The number of elements and the size of each element.  */
+  Py_ssize_t length;
+  Py_ssize_t itemsize;
+
+  /* The format of an element, in the syntax of the struct module.  */
+  const char *format;
+} btpy_array_object;
+
+/* Python type for btrace columns.  */
+
+static PyTypeObject btpy_array_type = {
+  PyVarObject_HEAD_INIT (NULL, 0)
+};
+
 /* Returns either a btrace_insn for the given Python gdb.RecordInstruction
    object or sets an appropriate Python exception and returns NULL.  */
 
@@ -507,6 +531,302 @@ btpy_list_slice (PyObject *self, PyObject *value)
 			obj->element_type);
 }
 
+/* Create a new column of LENGTH elements of type T, whose format is
+   FORMAT.  */
+
+template<typename T>
+static gdbpy_ref<btpy_array_object>
+btpy_array_new (Py_ssize_t length, const char *format)
+{
+  gdbpy_ref<btpy_array_object> obj (PyObject_New (btpy_array_object,
+						  &btpy_array_type));
+
+  if (obj == NULL)
+    return obj;
+
+  obj->data = XNEWVEC (T, length);
+  obj->length = length;
+  obj->itemsize = sizeof (T);
+  obj->format = format;
+
+  return obj;
+}
+
+/* Return the elements of the column OBJ, of type T.  */
+
+template<typename T>
+static T *
+btpy_array_data (const gdbpy_ref<btpy_array_object> &obj)
+{
+  gdb_assert (obj->itemsize == sizeof (T));
+
+  return (T *) obj->data;
+}
+
+/* Add the column OBJ as NAME to the dictionary DICT.  In Python 3 the
+   column is added as a memoryview of its elements, and in Python 2 as
+   a buffer of their bytes.  Returns -1 on error.  */
+
+static int
+btpy_array_add (PyObject *dict, const char *name,
+		const gdbpy_ref<btpy_array_object> &obj)
+{
+#ifdef IS_PY3K
+  gdbpy_ref<> view (PyMemoryView_FromObject ((PyObject *) obj.get ()));
+#else
+  gdbpy_ref<> view (PyBuffer_FromObject ((PyObject *) obj.get (), 0,
+					 Py_END_OF_BUFFER));
+#endif
+
+  if (view == NULL)
+    return -1;
+
+  return PyDict_SetItemString (dict, name, view.get ());
+}
+
+/* Destructor of BtraceArray objects.  */
+
+static void
+btpy_array_dealloc (PyObject *self)
+{
+  xfree (((btpy_array_object *) self)->data);
+  Py_TYPE (self)->tp_free (self);
+}
+
+#ifdef IS_PY3K
+
+/* Implementation of the buffer protocol for BtraceArray objects.  */
+
+static int
+btpy_array_get_buffer (PyObject *self, Py_buffer *buf, int flags)
+{
+  btpy_array_object *obj = (btpy_array_object *) self;
+
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+      PyErr_SetString (PyExc_BufferError, _("The array is read-only."));
+      buf->obj = NULL;
+      return -1;
+    }
+
+  buf->buf = obj->data;
+  buf->obj = self;
+  Py_INCREF (self);
+  buf->len = obj->length * obj->itemsize;
+  buf->readonly = 1;
+  buf->itemsize = obj->itemsize;
+
+  /* Despite the documentation saying this field is a "const char *",
+     in Python 3.4 at least, it's really a "char *".  */
+  buf->format = ((flags & PyBUF_FORMAT) == PyBUF_FORMAT
+		 ? (char *) obj->format : NULL);
+  buf->ndim = 1;
+  buf->shape = (flags & PyBUF_ND) == PyBUF_ND ? &obj->length : NULL;
+  buf->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES
+		  ? &obj->itemsize : NULL);
+  buf->suboffsets = NULL;
+  buf->internal = NULL;
+
+  return 0;
+}
+
+static PyBufferProcs btpy_array_buffer_procs =
+{
+  btpy_array_get_buffer
+};
+
+#else
+
+static Py_ssize_t
+btpy_array_get_read_buffer (PyObject *self, Py_ssize_t segment,
+			    void **ptrptr)
+{
+  btpy_array_object *obj = (btpy_array_object *) self;
+
+  if (segment)
+    {
+      PyErr_SetString (PyExc_SystemError,
+		       _("The array supports only one segment."));
+      return -1;
+    }
+
+  *ptrptr = obj->data;
+
+  return obj->length * obj->itemsize;
+}
+
+static Py_ssize_t
+btpy_array_get_seg_count (PyObject *self, Py_ssize_t *lenp)
+{
+  btpy_array_object *obj = (btpy_array_object *) self;
+
+  if (lenp)
+    *lenp = obj->length * obj->itemsize;
+
+  return 1;
+}
+
+static PyBufferProcs btpy_array_buffer_procs =
+{
+  btpy_array_get_read_buffer,
+  NULL,
+  btpy_array_get_seg_count,
+  NULL
+};
+
+#endif	/* IS_PY3K */
+
+/* Fill DICT with the columns of the instructions of the list OBJ, of
+   LENGTH elements.  Returns -1 on error.  */
+
+static int
+btpy_list_insn_arrays (const btpy_list_object *obj, Py_ssize_t length,
+		       PyObject *dict)
+{
+  const btrace_thread_info *btinfo = &obj->thread->btrace;
+  btrace_insn_iterator iter;
+
+  gdbpy_ref<btpy_array_object> number
+    = btpy_array_new<unsigned int> (length, "I");
+  gdbpy_ref<btpy_array_object> pc = btpy_array_new<uint64_t> (length, "Q");
+  gdbpy_ref<btpy_array_object> size = btpy_array_new<gdb_byte> (length, "B");
+  gdbpy_ref<btpy_array_object> function
+    = btpy_array_new<unsigned int> (length, "I");
+  gdbpy_ref<btpy_array_object> level = btpy_array_new<int> (length, "i");
+
+  if (number == NULL || pc == NULL || size == NULL || function == NULL
+      || level == NULL)
+    return -1;
+
+  if (length > 0
+      && btrace_find_insn_by_number (&iter, btinfo, obj->first) == 0)
+    {
+      PyErr_Format (gdbpy_gdb_error, _("No such instruction."));
+      return -1;
+    }
+
+  for (Py_ssize_t i = 0; i < length; i++)
+    {
+      const btrace_insn *insn = btrace_insn_get (&iter);
+      const btrace_function &func = btinfo->functions[iter.call_index];
+
+      btpy_array_data<unsigned int> (number)[i] = btrace_insn_number (&iter);
+      btpy_array_data<uint64_t> (pc)[i] = insn != NULL ? insn->pc : 0;
+      btpy_array_data<gdb_byte> (size)[i] = insn != NULL ? insn->size : 0;
+      btpy_array_data<unsigned int> (function)[i] = func.number;
+      btpy_array_data<int> (level)[i] = btinfo->level + func.level;
+
+      if (i + 1 == length)
+	break;
+
+      /* Walk the trace rather than looking up each instruction.  */
+      const unsigned int stride = std::abs (obj->step);
+      const unsigned int moved = (obj->step > 0
+				  ? btrace_insn_next (&iter, stride)
+				  : btrace_insn_prev (&iter, stride));
+      if (moved != stride)
+	{
+	  PyErr_Format (gdbpy_gdb_error, _("No such instruction."));
+	  return -1;
+	}
+    }
+
+  if (btpy_array_add (dict, "number", number) < 0
+      || btpy_array_add (dict, "pc", pc) < 0
+      || btpy_array_add (dict, "size", size) < 0
+      || btpy_array_add (dict, "function", function) < 0
+      || btpy_array_add (dict, "level", level) < 0)
+    return -1;
+
+  return 0;
+}
+
+/* Fill DICT with the columns of the function segments of the list OBJ,
+   of LENGTH elements.  Returns -1 on error.  */
+
+static int
+btpy_list_func_arrays (const btpy_list_object *obj, Py_ssize_t length,
+		       PyObject *dict)
+{
+  const btrace_thread_info *btinfo = &obj->thread->btrace;
+
+  gdbpy_ref<btpy_array_object> number
+    = btpy_array_new<unsigned int> (length, "I");
+  gdbpy_ref<btpy_array_object> level = btpy_array_new<int> (length, "i");
+  gdbpy_ref<btpy_array_object> up
+    = btpy_array_new<unsigned int> (length, "I");
+  gdbpy_ref<btpy_array_object> instruction
+    = btpy_array_new<unsigned int> (length, "I");
+  gdbpy_ref<btpy_array_object> count
+    = btpy_array_new<unsigned int> (length, "I");
+
+  if (number == NULL || level == NULL || up == NULL || instruction == NULL
+      || count == NULL)
+    return -1;
+
+  for (Py_ssize_t i = 0; i < length; i++)
+    {
+      const Py_ssize_t n = obj->first + obj->step * i;
+
+      if (n <= 0 || (size_t) n > btinfo->functions.size ())
+	{
+	  PyErr_Format (gdbpy_gdb_error, _("No such function segment."));
+	  return -1;
+	}
+
+      const btrace_function &func = btinfo->functions[n - 1];
+
+      btpy_array_data<unsigned int> (number)[i] = func.number;
+      btpy_array_data<int> (level)[i] = btinfo->level + func.level;
+      btpy_array_data<unsigned int> (up)[i] = func.up;
+      btpy_array_data<unsigned int> (instruction)[i] = func.insn_offset;
+      btpy_array_data<unsigned int> (count)[i] = func.insn.size ();
+    }
+
+  if (btpy_array_add (dict, "number", number) < 0
+      || btpy_array_add (dict, "level", level) < 0
+      || btpy_array_add (dict, "up", up) < 0
+      || btpy_array_add (dict, "instruction", instruction) < 0
+      || btpy_array_add (dict, "instructions", count) < 0)
+    return -1;
+
+  return 0;
+}
+
+/* Implementation of BtraceList.to_arrays (self) -> dict.
+   Returns the elements of the list as a dictionary of columns, one
+   per attribute, that support the buffer protocol.  No object is
+   created for the elements themselves.  */
+
+static PyObject *
+btpy_list_to_arrays (PyObject *self, PyObject *args)
+{
+  const btpy_list_object * const obj = (btpy_list_object *) self;
+  const Py_ssize_t length = btpy_list_length (self);
+  int ret = -1;
+
+  gdbpy_ref<> dict (PyDict_New ());
+  if (dict == NULL)
+    return NULL;
+
+  try
+    {
+      if (obj->element_type == &recpy_insn_type)
+	ret = btpy_list_insn_arrays (obj, length, dict.get ());
+      else
+	ret = btpy_list_func_arrays (obj, length, dict.get ());
+    }
+  catch (const gdb_exception &except)
+    {
+      GDB_PY_HANDLE_EXCEPTION (except);
+    }
+
+  if (ret < 0)
+    return NULL;
+
+  return dict.release ();
+}
+
 /* Helper function that returns the position of an element in a BtraceList
    or -1 if the element is not in the list.  */
 
@@ -809,6 +1129,10 @@ struct PyMethodDef btpy_list_methods[] =
 {
   { "count", btpy_list_count, METH_O, "count number of occurences"},
   { "index", btpy_list_index, METH_O, "index of entry"},
+  { "to_arrays", btpy_list_to_arrays, METH_NOARGS,
+    "to_arrays () -> dict.\n\
+Return the elements of the list as a dictionary of columns, which support\n\
+the buffer protocol." },
   {NULL}
 };
 
@@ -847,5 +1171,15 @@ gdbpy_initialize_btrace (void)
 
   btpy_list_mapping_methods.mp_subscript = btpy_list_slice;
 
-  return PyType_Ready (&btpy_list_type);
+  if (PyType_Ready (&btpy_list_type) < 0)
+    return -1;
+
+  btpy_array_type.tp_flags = Py_TPFLAGS_DEFAULT;
+  btpy_array_type.tp_basicsize = sizeof (btpy_array_object);
+  btpy_array_type.tp_name = "gdb.BtraceArray";
+  btpy_array_type.tp_doc = "GDB btrace column object";
+  btpy_array_type.tp_dealloc = btpy_array_dealloc;
+  btpy_array_type.tp_as_buffer = &btpy_array_buffer_procs;
+
+  return PyType_Ready (&btpy_array_type);
 }
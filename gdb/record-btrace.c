@@ -99,6 +99,10 @@ public:
 					ULONGEST offset, ULONGEST len,
 					ULONGEST *xfered_len) override;
 
+  bool read_memory_ranges (const std::vector<mem_range> &ranges,
+			   gdb_byte *myaddr,
+			   std::vector<ULONGEST> *xfered) override;
+
   int insert_breakpoint (struct gdbarch *,
 			 struct bp_target_info *) override;
   int remove_breakpoint (struct gdbarch *, struct bp_target_info *,
@@ -1463,6 +1467,22 @@ record_btrace_target::xfer_partial (enum target_object object,
 					 offset, len, xfered_len);
 }
 
+/* The read_memory_ranges method of target record-btrace.  */
+
+bool
+record_btrace_target::read_memory_ranges (const std::vector<mem_range> &ranges,
+					  gdb_byte *myaddr,
+					  std::vector<ULONGEST> *xfered)
+{
+  /* Leave it to xfer_partial to filter the requests during replay.  */
+  if (replay_memory_access == replay_memory_access_read_only
+      && !record_btrace_generating_corefile
+      && record_is_replaying (inferior_ptid))
+    return false;
+
+  return this->beneath ()->read_memory_ranges (ranges, myaddr, xfered);
+}
+
 /* The insert_breakpoint method of target record-btrace.  */
 
 int
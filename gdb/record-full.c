@@ -38,7 +38,9 @@
 #include "infrun.h"
 #include "common/gdb_unlinker.h"
 #include "common/byte-vector.h"
+#include "leb128.h"
 
+#include <algorithm>
 #include <signal.h>
 
 /* This module implements "target record-full", also known as "process
@@ -64,7 +66,8 @@
 #define DEFAULT_RECORD_FULL_INSN_MAX_NUM	200000
 
 #define RECORD_FULL_IS_REPLAY \
-  (record_full_list->next || ::execution_direction == EXEC_REVERSE)
+  (!record_full_is_last (record_full_list) \
+   || ::execution_direction == EXEC_REVERSE)
 
 #define RECORD_FULL_FILE_MAGIC	netorder32(0x20091016)
 
@@ -76,8 +79,8 @@
    that indicates that this is the last struct record_full_entry of this
    instruction.
 
-   Each struct record_full_entry is linked to "record_full_list" by "prev"
-   and "next" pointers.  */
+   Entries are stored encoded in the execution log (see below), and
+   decoded into a struct record_full_entry when they are used.  */
 
 struct record_full_mem_entry
 {
@@ -86,22 +89,12 @@ struct record_full_mem_entry
   /* Set this flag if target memory for this entry
      can no longer be accessed.  */
   int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_reg_entry
 {
   unsigned short num;
   unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_full_end_entry
@@ -117,34 +110,10 @@ enum record_full_type
   record_full_mem
 };
 
-/* This is the data structure that makes up the execution log.
-
-   The execution log consists of a single linked list of entries
-   of type "struct record_full_entry".  It is doubly linked so that it
-   can be traversed in either direction.
-
-   The start of the list is anchored by a struct called
-   "record_full_first".  The pointer "record_full_list" either points
-   to the last entry that was added to the list (in record mode), or to
-   the next entry in the list that will be executed (in replay mode).
-
-   Each list element (struct record_full_entry), in addition to next
-   and prev pointers, consists of a union of three entry types: mem,
-   reg, and end.  A field called "type" determines which entry type is
-   represented by a given list element.
-
-   Each instruction that is added to the execution log is represented
-   by a variable number of list elements ('entries').  The instruction
-   will have one "reg" entry for each register that is changed by 
-   executing the instruction (including the PC in every case).  It 
-   will also have one "mem" entry for each memory change.  Finally,
-   each instruction will have an "end" entry that separates it from
-   the changes associated with the next instruction.  */
+/* A decoded entry of the execution log.  */
 
 struct record_full_entry
 {
-  struct record_full_entry *prev;
-  struct record_full_entry *next;
   enum record_full_type type;
   union
   {
@@ -155,6 +124,99 @@ struct record_full_entry
     /* end */
     struct record_full_end_entry end;
   } u;
+
+  /* The value of a reg or mem entry.  It is stored in the execution
+     log, and is exchanged with the current value in place when the
+     entry is executed.  */
+  gdb_byte *val;
+};
+
+/* This is the data structure that makes up the execution log.
+
+   The execution log is a sequence of encoded entries, stored in a
+   doubly linked list of chunks ("struct record_full_chunk").  Chunks
+   are allocated as the log grows, and freed as a whole once all of
+   their entries are deleted.  Each entry is encoded as:
+
+     1 byte: the record_full_type of the entry, or'ed with
+	     RECORD_FULL_NOT_ACCESSIBLE for a mem entry whose memory can
+	     no longer be accessed.
+     record_full_reg: register number (ULEB128), length (ULEB128),
+		      value.
+     record_full_mem: address minus the base address of the chunk
+		      (SLEB128), length (ULEB128), value.
+     record_full_end: signal (1 byte), instruction number minus the
+		      base instruction number of the chunk (SLEB128).
+     trailer: the size of the entry before the trailer, as ULEB128
+	      with its bytes in reverse order, so that the log can be
+	      walked backwards.
+
+   An entry never spans chunks.  The bases of a chunk are chosen when
+   it is created, so that most addresses and instruction numbers take
+   one or two bytes.
+
+   A position in the log ("struct record_full_pos") is a chunk and the
+   offset of an entry in it.  The position "record_full_first", whose
+   chunk is NULL, is before the first entry; it is treated as an "end"
+   entry with instruction number zero.  The position
+   "record_full_list" either points to the last entry that was added to
+   the log (in record mode), or to the next entry in the log that will
+   be executed (in replay mode).
+
+   Each instruction that is added to the execution log is represented
+   by a variable number of entries.  The instruction will have one
+   "reg" entry for each register that is changed by executing the
+   instruction (including the PC in every case).  It will also have
+   one "mem" entry for each memory change.  Finally, each instruction
+   will have an "end" entry that separates it from the changes
+   associated with the next instruction.  */
+
+struct record_full_chunk
+{
+  struct record_full_chunk *prev;
+  struct record_full_chunk *next;
+
+  /* The addresses of mem entries and the instruction numbers of end
+     entries are encoded as signed differences from these: the address
+     of the first mem entry of the chunk, or of the last one before
+     it, and the instruction number when the chunk was started.  They
+     are not differences from the previous entry, so that each entry
+     can be decoded on its own while the log is walked in either
+     direction.  */
+  CORE_ADDR base_addr;
+  ULONGEST base_insn;
+
+  /* The number of bytes allocated for DATA, and used.  */
+  size_t size;
+  size_t used;
+
+  gdb_byte data[1];
+};
+
+/* The size of the chunks of the execution log.  Bigger entries get a
+   chunk of their own.  */
+
+#define RECORD_FULL_CHUNK_SIZE (64 * 1024)
+
+/* The flag of the first byte of a mem entry whose memory can no longer
+   be accessed.  */
+
+#define RECORD_FULL_NOT_ACCESSIBLE 0x80
+
+struct record_full_pos
+{
+  struct record_full_chunk *chunk;
+  size_t offset;
+
+  bool operator== (const record_full_pos &other) const
+  {
+    return chunk == other.chunk && offset == other.offset;
+  }
+
+  bool operator!= (const record_full_pos &other) const
+  {
+    return !(*this == other);
+  }
 };
 
 /* If true, query if PREC cannot record memory
@@ -174,27 +236,35 @@ static struct target_section *record_full_core_start;
 static struct target_section *record_full_core_end;
 static struct record_full_core_buf_entry *record_full_core_buf_list = NULL;
 
-/* The following variables are used for managing the linked list that
-   represents the execution log.
+/* The following variables are used for managing the execution log.
 
-   record_full_first is the anchor that holds down the beginning of
-   the list.
+   record_full_first_chunk and record_full_last_chunk are the ends of
+   the list of chunks, and record_full_first_offset is the offset of
+   the first entry in the first chunk, which moves forward as the
+   oldest instructions are deleted.
 
    record_full_list serves two functions:
-     1) In record mode, it anchors the end of the list.
-     2) In replay mode, it traverses the list and points to
+     1) In record mode, it anchors the end of the log.
+     2) In replay mode, it traverses the log and points to
         the next instruction that must be emulated.
 
-   record_full_arch_list_head and record_full_arch_list_tail are used
-   to manage a separate list, which is used to build up the change
-   elements of the currently executing instruction during record mode.
-   When this instruction has been completely annotated in the "arch
-   list", it will be appended to the main execution log.  */
+   record_full_arch_list is used to build up the change elements of
+   the currently executing instruction during record mode, with the
+   values of the entries in record_full_arch_list_vals.  When this
+   instruction has been completely annotated in the "arch list", it
+   will be appended to the main execution log.  */
+
+static struct record_full_chunk *record_full_first_chunk = NULL;
+static struct record_full_chunk *record_full_last_chunk = NULL;
+static size_t record_full_first_offset = 0;
+static const struct record_full_pos record_full_first = { NULL, 0 };
+static struct record_full_pos record_full_list = record_full_first;
+static std::vector<struct record_full_entry> record_full_arch_list;
+static gdb::byte_vector record_full_arch_list_vals;
 
-static struct record_full_entry record_full_first;
-static struct record_full_entry *record_full_list = &record_full_first;
-static struct record_full_entry *record_full_arch_list_head = NULL;
-static struct record_full_entry *record_full_arch_list_tail = NULL;
+/* The address of the last mem entry added to the log, which is the
+   base address of new chunks.  */
+static CORE_ADDR record_full_last_addr = 0;
 
 /* 1 ask user. 0 auto delete the last struct record_full_entry.  */
 static int record_full_stop_at_limit = 1;
@@ -375,184 +445,420 @@ static struct cmd_list_element *show_record_full_cmdlist;
 /* Command list for "record full".  */
 static struct cmd_list_element *record_full_cmdlist;
 
-static void record_full_goto_insn (struct record_full_entry *entry,
+static void record_full_goto_insn (const struct record_full_pos &entry,
 				   enum exec_direction_kind dir);
 
-/* Alloc and free functions for record_full_reg, record_full_mem, and
-   record_full_end entries.  */
+/* Functions to encode and decode the entries of the execution log,
+   and to walk it.  */
 
-/* Alloc a record_full_reg record entry.  */
+/* Return the number of bytes of VALUE encoded as ULEB128.  */
 
-static inline struct record_full_entry *
-record_full_reg_alloc (struct regcache *regcache, int regnum)
+static size_t
+record_full_uleb128_size (ULONGEST value)
 {
-  struct record_full_entry *rec;
-  struct gdbarch *gdbarch = regcache->arch ();
+  size_t size = 1;
+
+  while (value >= 0x80)
+    {
+      value >>= 7;
+      size++;
+    }
+  return size;
+}
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
-  rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+/* Store VALUE as ULEB128 at P, and return the end of the encoding.  */
 
-  return rec;
+static gdb_byte *
+record_full_put_uleb128 (gdb_byte *p, ULONGEST value)
+{
+  do
+    {
+      gdb_byte byte = value & 0x7f;
+
+      value >>= 7;
+      if (value != 0)
+	byte |= 0x80;
+      *p++ = byte;
+    }
+  while (value != 0);
+  return p;
 }
 
-/* Free a record_full_reg record entry.  */
+/* Store VALUE as SLEB128 at P, and return the end of the encoding.  */
 
-static inline void
-record_full_reg_release (struct record_full_entry *rec)
+static gdb_byte *
+record_full_put_sleb128 (gdb_byte *p, LONGEST value)
 {
-  gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  bool more;
+
+  do
+    {
+      gdb_byte byte = value & 0x7f;
+
+      value >>= 7;
+      more = !((value == 0 && (byte & 0x40) == 0)
+	       || (value == -1 && (byte & 0x40) != 0));
+      if (more)
+	byte |= 0x80;
+      *p++ = byte;
+    }
+  while (more);
+  return p;
 }
 
-/* Alloc a record_full_mem record entry.  */
+/* Append ENTRY, whose value is VAL, to the execution log, and return
+   its position.  */
 
-static inline struct record_full_entry *
-record_full_mem_alloc (CORE_ADDR addr, int len)
+static struct record_full_pos
+record_full_append (const struct record_full_entry &entry,
+		    const gdb_byte *val)
 {
-  struct record_full_entry *rec;
+  size_t len = 0;
+
+  if (entry.type == record_full_reg)
+    len = entry.u.reg.len;
+  else if (entry.type == record_full_mem)
+    len = entry.u.mem.len;
+
+  /* The most an entry takes besides its value: the type, two LEB128
+     numbers or a signal and a LEB128 number, and the trailer.  */
+  size_t max_size = len + 32;
+  struct record_full_chunk *chunk = record_full_last_chunk;
+
+  if (chunk == NULL || chunk->size - chunk->used < max_size)
+    {
+      size_t size = std::max<size_t> (RECORD_FULL_CHUNK_SIZE, max_size);
+
+      chunk = ((struct record_full_chunk *)
+	       xmalloc (offsetof (struct record_full_chunk, data) + size));
+      chunk->prev = record_full_last_chunk;
+      chunk->next = NULL;
+      chunk->base_addr = (entry.type == record_full_mem
+			  ? entry.u.mem.addr : record_full_last_addr);
+      chunk->base_insn = (entry.type == record_full_end
+			  ? entry.u.end.insn_num : record_full_insn_count);
+      chunk->size = size;
+      chunk->used = 0;
+
+      if (record_full_last_chunk != NULL)
+	record_full_last_chunk->next = chunk;
+      else
+	{
+	  record_full_first_chunk = chunk;
+	  record_full_first_offset = 0;
+	}
+      record_full_last_chunk = chunk;
+    }
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
-  rec->u.mem.addr = addr;
-  rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+  struct record_full_pos pos = { chunk, chunk->used };
+  gdb_byte *start = chunk->data + chunk->used;
+  gdb_byte *p = start;
 
-  return rec;
+  *p++ = entry.type;
+  switch (entry.type)
+    {
+    case record_full_reg:
+      p = record_full_put_uleb128 (p, entry.u.reg.num);
+      p = record_full_put_uleb128 (p, len);
+      memcpy (p, val, len);
+      p += len;
+      break;
+
+    case record_full_mem:
+      if (entry.u.mem.mem_entry_not_accessible)
+	*start |= RECORD_FULL_NOT_ACCESSIBLE;
+      p = record_full_put_sleb128 (p, (LONGEST) (entry.u.mem.addr
+						 - chunk->base_addr));
+      p = record_full_put_uleb128 (p, len);
+      memcpy (p, val, len);
+      p += len;
+      record_full_last_addr = entry.u.mem.addr;
+      break;
+
+    case record_full_end:
+      *p++ = entry.u.end.sigval;
+      p = record_full_put_sleb128 (p, (LONGEST) (entry.u.end.insn_num
+						 - chunk->base_insn));
+      break;
+    }
+
+  gdb_byte *trailer = p;
+  p = record_full_put_uleb128 (p, trailer - start);
+  std::reverse (trailer, p);
+
+  chunk->used = p - chunk->data;
+  return pos;
 }
 
-/* Free a record_full_mem record entry.  */
+/* Decode the entry at POS into ENTRY, and return the size of its
+   encoding.  */
 
-static inline void
-record_full_mem_release (struct record_full_entry *rec)
+static size_t
+record_full_decode (const struct record_full_pos &pos,
+		    struct record_full_entry *entry)
 {
-  gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  if (pos.chunk == NULL)
+    {
+      /* This is record_full_first.  */
+      entry->type = record_full_end;
+      entry->u.end.sigval = GDB_SIGNAL_0;
+      entry->u.end.insn_num = 0;
+      entry->val = NULL;
+      return 0;
+    }
+
+  const gdb_byte *end = pos.chunk->data + pos.chunk->used;
+  gdb_byte *start = pos.chunk->data + pos.offset;
+  gdb_byte *p = start;
+  uint64_t uvalue = 0;
+  int64_t svalue = 0;
+
+  entry->type = (enum record_full_type) (*p++ & ~RECORD_FULL_NOT_ACCESSIBLE);
+  entry->val = NULL;
+  switch (entry->type)
+    {
+    case record_full_reg:
+      p += read_uleb128_to_uint64 (p, end, &uvalue);
+      entry->u.reg.num = uvalue;
+      p += read_uleb128_to_uint64 (p, end, &uvalue);
+      entry->u.reg.len = uvalue;
+      entry->val = p;
+      p += entry->u.reg.len;
+      break;
+
+    case record_full_mem:
+      entry->u.mem.mem_entry_not_accessible
+	= (*start & RECORD_FULL_NOT_ACCESSIBLE) != 0;
+      p += read_sleb128_to_int64 (p, end, &svalue);
+      entry->u.mem.addr = pos.chunk->base_addr + svalue;
+      p += read_uleb128_to_uint64 (p, end, &uvalue);
+      entry->u.mem.len = uvalue;
+      entry->val = p;
+      p += entry->u.mem.len;
+      break;
+
+    case record_full_end:
+      entry->u.end.sigval = (enum gdb_signal) *p++;
+      p += read_sleb128_to_int64 (p, end, &svalue);
+      entry->u.end.insn_num = pos.chunk->base_insn + svalue;
+      break;
+
+    default:
+      gdb_assert_not_reached ("unexpected record_full_entry type");
+    }
+
+  return (p - start) + record_full_uleb128_size (p - start);
 }
 
-/* Alloc a record_full_end record entry.  */
+/* Return true if POS is the last entry of the execution log, or
+   record_full_first if the log is empty.  */
 
-static inline struct record_full_entry *
-record_full_end_alloc (void)
+static bool
+record_full_is_last (const struct record_full_pos &pos)
 {
-  struct record_full_entry *rec;
+  struct record_full_entry entry;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
+  if (pos.chunk == NULL)
+    return record_full_first_chunk == NULL;
 
-  return rec;
+  return (pos.chunk->next == NULL
+	  && pos.offset + record_full_decode (pos, &entry) == pos.chunk->used);
 }
 
-/* Free a record_full_end record entry.  */
+/* Move POS to the next entry of the execution log.  Return false,
+   leaving POS unchanged, if it is the last entry.  */
 
-static inline void
-record_full_end_release (struct record_full_entry *rec)
+static bool
+record_full_next (struct record_full_pos *pos)
 {
-  xfree (rec);
+  struct record_full_entry entry;
+
+  if (pos->chunk == NULL)
+    {
+      if (record_full_first_chunk == NULL)
+	return false;
+
+      pos->chunk = record_full_first_chunk;
+      pos->offset = record_full_first_offset;
+      return true;
+    }
+
+  size_t next = pos->offset + record_full_decode (*pos, &entry);
+  if (next < pos->chunk->used)
+    pos->offset = next;
+  else if (pos->chunk->next != NULL)
+    {
+      pos->chunk = pos->chunk->next;
+      pos->offset = 0;
+    }
+  else
+    return false;
+
+  return true;
 }
 
-/* Free one record entry, any type.
-   Return entry->type, in case caller wants to know.  */
+/* Move POS to the previous entry of the execution log, or to
+   record_full_first.  Return false, leaving POS unchanged, if it is
+   record_full_first.  */
 
-static inline enum record_full_type
-record_full_entry_release (struct record_full_entry *rec)
+static bool
+record_full_prev (struct record_full_pos *pos)
 {
-  enum record_full_type type = rec->type;
+  if (pos->chunk == NULL)
+    return false;
 
-  switch (type) {
-  case record_full_reg:
-    record_full_reg_release (rec);
-    break;
-  case record_full_mem:
-    record_full_mem_release (rec);
-    break;
-  case record_full_end:
-    record_full_end_release (rec);
-    break;
-  }
-  return type;
+  if (pos->chunk == record_full_first_chunk
+      && pos->offset == record_full_first_offset)
+    {
+      *pos = record_full_first;
+      return true;
+    }
+
+  if (pos->offset == 0)
+    {
+      pos->chunk = pos->chunk->prev;
+      pos->offset = pos->chunk->used;
+    }
+
+  /* Read the trailer of the previous entry, backwards.  */
+  const gdb_byte *p = pos->chunk->data + pos->offset;
+  ULONGEST size = 0;
+  int shift = 0;
+  gdb_byte byte;
+
+  do
+    {
+      byte = *--p;
+      size |= (ULONGEST) (byte & 0x7f) << shift;
+      shift += 7;
+    }
+  while ((byte & 0x80) != 0);
+
+  pos->offset = (p - pos->chunk->data) - size;
+  return true;
 }
 
-/* Free all record entries in list pointed to by REC.  */
+/* Mark the mem entry at POS as no longer accessible.  */
 
 static void
-record_full_list_release (struct record_full_entry *rec)
+record_full_set_not_accessible (const struct record_full_pos &pos)
 {
-  if (!rec)
-    return;
+  pos.chunk->data[pos.offset] |= RECORD_FULL_NOT_ACCESSIBLE;
+}
 
-  while (rec->next)
-    rec = rec->next;
+/* Set the signal of the end entry at POS to SIGVAL.  */
 
-  while (rec->prev)
-    {
-      rec = rec->prev;
-      record_full_entry_release (rec->next);
-    }
+static void
+record_full_set_sigval (const struct record_full_pos &pos,
+			enum gdb_signal sigval)
+{
+  gdb_static_assert (GDB_SIGNAL_LAST <= 0xff);
+
+  pos.chunk->data[pos.offset + 1] = sigval;
+}
+
+/* Free the whole execution log.  */
 
-  if (rec == &record_full_first)
+static void
+record_full_list_release (void)
+{
+  while (record_full_first_chunk != NULL)
     {
-      record_full_insn_num = 0;
-      record_full_first.next = NULL;
+      struct record_full_chunk *chunk = record_full_first_chunk;
+
+      record_full_first_chunk = chunk->next;
+      xfree (chunk);
     }
-  else
-    record_full_entry_release (rec);
+
+  record_full_last_chunk = NULL;
+  record_full_first_offset = 0;
+  record_full_list = record_full_first;
+  record_full_insn_num = 0;
 }
 
-/* Free all record entries forward of the given list position.  */
+/* Free all record entries forward of the given log position.  */
 
 static void
-record_full_list_release_following (struct record_full_entry *rec)
+record_full_list_release_following (const struct record_full_pos &rec)
 {
-  struct record_full_entry *tmp = rec->next;
+  struct record_full_pos tmp = rec;
+  struct record_full_entry entry;
 
-  rec->next = NULL;
-  while (tmp)
+  while (record_full_next (&tmp))
     {
-      rec = tmp->next;
-      if (record_full_entry_release (tmp) == record_full_end)
+      record_full_decode (tmp, &entry);
+      if (entry.type == record_full_end)
 	{
 	  record_full_insn_num--;
 	  record_full_insn_count--;
 	}
-      tmp = rec;
+    }
+
+  /* Cut the log after REC, and free the chunks left empty.  */
+  struct record_full_chunk *chunk;
+
+  if (rec.chunk == NULL)
+    {
+      chunk = record_full_first_chunk;
+      record_full_first_chunk = NULL;
+      record_full_last_chunk = NULL;
+      record_full_first_offset = 0;
+    }
+  else
+    {
+      rec.chunk->used = rec.offset + record_full_decode (rec, &entry);
+      chunk = rec.chunk->next;
+      rec.chunk->next = NULL;
+      record_full_last_chunk = rec.chunk;
+    }
+
+  while (chunk != NULL)
+    {
+      struct record_full_chunk *next = chunk->next;
+
+      xfree (chunk);
+      chunk = next;
     }
 }
 
 /* Delete the first instruction from the beginning of the log, to make
-   room for adding a new instruction at the end of the log.
+   room for adding a new instruction at the end of the log.  Chunks
+   are freed once all of their entries are deleted.
 
    Note -- this function does not modify record_full_insn_num.  */
 
 static void
 record_full_list_release_first (void)
 {
-  struct record_full_entry *tmp;
+  struct record_full_entry entry;
 
-  if (!record_full_first.next)
+  if (record_full_first_chunk == NULL)
     return;
 
   /* Loop until a record_full_end.  */
   while (1)
     {
-      /* Cut record_full_first.next out of the linked list.  */
-      tmp = record_full_first.next;
-      record_full_first.next = tmp->next;
-      tmp->next->prev = &record_full_first;
+      struct record_full_pos first
+	= { record_full_first_chunk, record_full_first_offset };
 
-      /* tmp is now isolated, and can be deleted.  */
-      if (record_full_entry_release (tmp) == record_full_end)
+      record_full_first_offset += record_full_decode (first, &entry);
+      if (record_full_first_offset == record_full_first_chunk->used)
+	{
+	  struct record_full_chunk *chunk = record_full_first_chunk;
+
+	  record_full_first_chunk = chunk->next;
+	  record_full_first_offset = 0;
+	  if (record_full_first_chunk != NULL)
+	    record_full_first_chunk->prev = NULL;
+	  else
+	    record_full_last_chunk = NULL;
+	  xfree (chunk);
+	}
+
+      if (entry.type == record_full_end)
 	break;	/* End loop at first record_full_end.  */
 
-      if (!record_full_first.next)
+      if (record_full_first_chunk == NULL)
 	{
 	  gdb_assert (record_full_insn_num == 1);
 	  break;	/* End loop when list is empty.  */
@@ -560,49 +866,55 @@ record_full_list_release_first (void)
     }
 }
 
-/* Add a struct record_full_entry to record_full_arch_list.  */
+/* Add a struct record_full_entry whose value is LEN bytes long to
+   record_full_arch_list.  Return where its value is to be stored,
+   which is valid until the next entry is added.  */
 
-static void
-record_full_arch_list_add (struct record_full_entry *rec)
+static gdb_byte *
+record_full_arch_list_add (const struct record_full_entry &rec, int len)
 {
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
-			"Process record: record_full_arch_list_add %s.\n",
-			host_address_to_string (rec));
+			"Process record: record_full_arch_list_add "
+			"type = %d.\n", rec.type);
+
+  size_t offset = record_full_arch_list_vals.size ();
+
+  record_full_arch_list.push_back (rec);
+  record_full_arch_list_vals.resize (offset + len);
+  return record_full_arch_list_vals.data () + offset;
+}
+
+/* Free the entries of record_full_arch_list.  */
+
+static void
+record_full_arch_list_release (void)
+{
+  record_full_arch_list.clear ();
+  record_full_arch_list_vals.clear ();
+}
+
+/* Append the entries of record_full_arch_list to the execution log,
+   after record_full_list, which must be its last entry, and point
+   record_full_list to the last of them.  */
+
+static void
+record_full_arch_list_commit (void)
+{
+  const gdb_byte *val = record_full_arch_list_vals.data ();
 
-  if (record_full_arch_list_tail)
+  gdb_assert (record_full_is_last (record_full_list));
+
+  for (const struct record_full_entry &rec : record_full_arch_list)
     {
-      record_full_arch_list_tail->next = rec;
-      rec->prev = record_full_arch_list_tail;
-      record_full_arch_list_tail = rec;
+      record_full_list = record_full_append (rec, val);
+      if (rec.type == record_full_reg)
+	val += rec.u.reg.len;
+      else if (rec.type == record_full_mem)
+	val += rec.u.mem.len;
     }
-  else
-    {
-      record_full_arch_list_head = rec;
-      record_full_arch_list_tail = rec;
-    }
-}
-
-/* Return the value storage location of a record entry.  */
-static inline gdb_byte *
-record_full_get_loc (struct record_full_entry *rec)
-{
-  switch (rec->type) {
-  case record_full_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
-  case record_full_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
-  case record_full_end:
-  default:
-    gdb_assert_not_reached ("unexpected record_full_entry type");
-    return NULL;
-  }
+
+  record_full_arch_list_release ();
 }
 
 /* Record the value of a register NUM to record_full_arch_list.  */
@@ -610,7 +922,7 @@ record_full_get_loc (struct record_full_entry *rec)
 int
 record_full_arch_list_add_reg (struct regcache *regcache, int regnum)
 {
-  struct record_full_entry *rec;
+  struct record_full_entry rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
@@ -618,11 +930,12 @@ record_full_arch_list_add_reg (struct regcache *regcache, int regnum)
 			"record list.\n",
 			regnum);
 
-  rec = record_full_reg_alloc (regcache, regnum);
-
-  regcache->raw_read (regnum, record_full_get_loc (rec));
+  rec.type = record_full_reg;
+  rec.u.reg.num = regnum;
+  rec.u.reg.len = register_size (regcache->arch (), regnum);
+  rec.val = NULL;
 
-  record_full_arch_list_add (rec);
+  regcache->raw_read (regnum, record_full_arch_list_add (rec, rec.u.reg.len));
 
   return 0;
 }
@@ -633,7 +946,7 @@ record_full_arch_list_add_reg (struct regcache *regcache, int regnum)
 int
 record_full_arch_list_add_mem (CORE_ADDR addr, int len)
 {
-  struct record_full_entry *rec;
+  struct record_full_entry rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
@@ -644,17 +957,21 @@ record_full_arch_list_add_mem (CORE_ADDR addr, int len)
   if (!addr)	/* FIXME: Why?  Some arch must permit it...  */
     return 0;
 
-  rec = record_full_mem_alloc (addr, len);
+  rec.type = record_full_mem;
+  rec.u.mem.addr = addr;
+  rec.u.mem.len = len;
+  rec.u.mem.mem_entry_not_accessible = 0;
+  rec.val = NULL;
 
+  size_t offset = record_full_arch_list_vals.size ();
   if (record_read_memory (target_gdbarch (), addr,
-			  record_full_get_loc (rec), len))
+			  record_full_arch_list_add (rec, len), len))
     {
-      record_full_mem_release (rec);
+      record_full_arch_list.pop_back ();
+      record_full_arch_list_vals.resize (offset);
       return -1;
     }
 
-  record_full_arch_list_add (rec);
-
   return 0;
 }
 
@@ -664,17 +981,18 @@ record_full_arch_list_add_mem (CORE_ADDR addr, int len)
 int
 record_full_arch_list_add_end (void)
 {
-  struct record_full_entry *rec;
+  struct record_full_entry rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
 			"Process record: add end to arch list.\n");
 
-  rec = record_full_end_alloc ();
-  rec->u.end.sigval = GDB_SIGNAL_0;
-  rec->u.end.insn_num = ++record_full_insn_count;
+  rec.type = record_full_end;
+  rec.u.end.sigval = GDB_SIGNAL_0;
+  rec.u.end.insn_num = ++record_full_insn_count;
+  rec.val = NULL;
 
-  record_full_arch_list_add (rec);
+  record_full_arch_list_add (rec, 0);
 
   return 0;
 }
@@ -710,8 +1028,7 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
 
   try
     {
-      record_full_arch_list_head = NULL;
-      record_full_arch_list_tail = NULL;
+      record_full_arch_list_release ();
 
       /* Check record_full_insn_num.  */
       record_full_check_insn_num ();
@@ -739,11 +1056,14 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
 	 if we delivered it during the recording.  Therefore we should
 	 record the signal during record_full_wait, not
 	 record_full_resume.  */
-      if (record_full_list != &record_full_first)  /* FIXME better way
-						      to check */
+      if (record_full_list != record_full_first)  /* FIXME better way
+						     to check */
 	{
-	  gdb_assert (record_full_list->type == record_full_end);
-	  record_full_list->u.end.sigval = signal;
+	  struct record_full_entry entry;
+
+	  record_full_decode (record_full_list, &entry);
+	  gdb_assert (entry.type == record_full_end);
+	  record_full_set_sigval (record_full_list, signal);
 	}
 
       if (signal == GDB_SIGNAL_0
@@ -763,13 +1083,11 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
     }
   catch (const gdb_exception &ex)
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_release ();
       throw;
     }
 
-  record_full_list->next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = record_full_list;
-  record_full_list = record_full_arch_list_tail;
+  record_full_arch_list_commit ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -816,63 +1134,66 @@ static enum target_stop_reason record_full_stop_reason
 static inline void
 record_full_exec_insn (struct regcache *regcache,
 		       struct gdbarch *gdbarch,
-		       struct record_full_entry *entry)
+		       const struct record_full_pos &pos)
 {
-  switch (entry->type)
+  struct record_full_entry entry;
+
+  record_full_decode (pos, &entry);
+  switch (entry.type)
     {
     case record_full_reg: /* reg */
       {
-	gdb::byte_vector reg (entry->u.reg.len);
+	gdb::byte_vector reg (entry.u.reg.len);
 
         if (record_debug > 1)
           fprintf_unfiltered (gdb_stdlog,
                               "Process record: record_full_reg %s to "
                               "inferior num = %d.\n",
-                              host_address_to_string (entry),
-                              entry->u.reg.num);
+                              host_address_to_string (entry.val),
+                              entry.u.reg.num);
 
-        regcache->cooked_read (entry->u.reg.num, reg.data ());
-        regcache->cooked_write (entry->u.reg.num, record_full_get_loc (entry));
-        memcpy (record_full_get_loc (entry), reg.data (), entry->u.reg.len);
+        regcache->cooked_read (entry.u.reg.num, reg.data ());
+        regcache->cooked_write (entry.u.reg.num, entry.val);
+        memcpy (entry.val, reg.data (), entry.u.reg.len);
       }
       break;
 
     case record_full_mem: /* mem */
       {
 	/* Nothing to do if the entry is flagged not_accessible.  */
-        if (!entry->u.mem.mem_entry_not_accessible)
+        if (!entry.u.mem.mem_entry_not_accessible)
           {
-	    gdb::byte_vector mem (entry->u.mem.len);
+	    gdb::byte_vector mem (entry.u.mem.len);
 
             if (record_debug > 1)
               fprintf_unfiltered (gdb_stdlog,
                                   "Process record: record_full_mem %s to "
                                   "inferior addr = %s len = %d.\n",
-                                  host_address_to_string (entry),
-                                  paddress (gdbarch, entry->u.mem.addr),
-                                  entry->u.mem.len);
+                                  host_address_to_string (entry.val),
+                                  paddress (gdbarch, entry.u.mem.addr),
+                                  entry.u.mem.len);
 
             if (record_read_memory (gdbarch,
-				    entry->u.mem.addr, mem.data (),
-				    entry->u.mem.len))
-	      entry->u.mem.mem_entry_not_accessible = 1;
+				    entry.u.mem.addr, mem.data (),
+				    entry.u.mem.len))
+	      record_full_set_not_accessible (pos);
             else
               {
-                if (target_write_memory (entry->u.mem.addr, 
-					 record_full_get_loc (entry),
-					 entry->u.mem.len))
+                if (target_write_memory (entry.u.mem.addr, 
+					 entry.val,
+					 entry.u.mem.len))
                   {
-                    entry->u.mem.mem_entry_not_accessible = 1;
+                    record_full_set_not_accessible (pos);
                     if (record_debug)
                       warning (_("Process record: error writing memory at "
 				 "addr = %s len = %d."),
-                               paddress (gdbarch, entry->u.mem.addr),
-                               entry->u.mem.len);
+                               paddress (gdbarch, entry.u.mem.addr),
+                               entry.u.mem.len);
                   }
                 else
 		  {
-		    memcpy (record_full_get_loc (entry), mem.data (),
-			    entry->u.mem.len);
+		    memcpy (entry.val, mem.data (),
+			    entry.u.mem.len);
 
 		    /* We've changed memory --- check if a hardware
 		       watchpoint should trap.  Note that this
@@ -884,7 +1205,7 @@ record_full_exec_insn (struct regcache *regcache,
 		       traps.  */
 		    if (hardware_watchpoint_inserted_in_range
 			(regcache->aspace (),
-			 entry->u.mem.addr, entry->u.mem.len))
+			 entry.u.mem.addr, entry.u.mem.len))
 		      record_full_stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
 		  }
               }
@@ -972,10 +1293,8 @@ record_full_open (const char *name, int from_tty)
   record_preopen ();
 
   /* Reset */
-  record_full_insn_num = 0;
+  record_full_list_release ();
   record_full_insn_count = 0;
-  record_full_list = &record_full_first;
-  record_full_list->next = NULL;
 
   if (core_bfd)
     record_full_core_open_1 (name, from_tty);
@@ -1002,7 +1321,7 @@ record_full_base_target::close ()
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog, "Process record: record_full_close\n");
 
-  record_full_list_release (record_full_list);
+  record_full_list_release ();
 
   /* Release record_full_core_regbuf.  */
   if (record_full_core_regbuf)
@@ -1322,23 +1641,25 @@ record_full_wait_1 (struct target_ops *ops,
 
 	  /* In EXEC_FORWARD mode, record_full_list points to the tail of prev
 	     instruction.  */
-	  if (execution_direction == EXEC_FORWARD && record_full_list->next)
-	    record_full_list = record_full_list->next;
+	  if (execution_direction == EXEC_FORWARD)
+	    record_full_next (&record_full_list);
 
 	  /* Loop over the record_full_list, looking for the next place to
 	     stop.  */
 	  do
 	    {
+	      struct record_full_entry entry;
+
 	      /* Check for beginning and end of log.  */
 	      if (execution_direction == EXEC_REVERSE
-		  && record_full_list == &record_full_first)
+		  && record_full_list == record_full_first)
 		{
 		  /* Hit beginning of record log in reverse.  */
 		  status->kind = TARGET_WAITKIND_NO_HISTORY;
 		  break;
 		}
 	      if (execution_direction != EXEC_REVERSE
-		  && !record_full_list->next)
+		  && record_full_is_last (record_full_list))
 		{
 		  /* Hit end of record log going forward.  */
 		  status->kind = TARGET_WAITKIND_NO_HISTORY;
@@ -1347,14 +1668,15 @@ record_full_wait_1 (struct target_ops *ops,
 
 	      record_full_exec_insn (regcache, gdbarch, record_full_list);
 
-	      if (record_full_list->type == record_full_end)
+	      record_full_decode (record_full_list, &entry);
+	      if (entry.type == record_full_end)
 		{
 		  if (record_debug > 1)
 		    fprintf_unfiltered
 		      (gdb_stdlog,
 		       "Process record: record_full_end %s to "
 		       "inferior.\n",
-		       host_address_to_string (record_full_list));
+		       pulongest (entry.u.end.insn_num));
 
 		  if (first_record_full_end
 		      && execution_direction == EXEC_REVERSE)
@@ -1403,7 +1725,7 @@ record_full_wait_1 (struct target_ops *ops,
 			  continue_flag = 0;
 			}
 		      /* Check target signal */
-		      if (record_full_list->u.end.sigval != GDB_SIGNAL_0)
+		      if (entry.u.end.sigval != GDB_SIGNAL_0)
 			/* FIXME: better way to check */
 			continue_flag = 0;
 		    }
@@ -1412,37 +1734,32 @@ record_full_wait_1 (struct target_ops *ops,
 	      if (continue_flag)
 		{
 		  if (execution_direction == EXEC_REVERSE)
-		    {
-		      if (record_full_list->prev)
-			record_full_list = record_full_list->prev;
-		    }
+		    record_full_prev (&record_full_list);
 		  else
-		    {
-		      if (record_full_list->next)
-			record_full_list = record_full_list->next;
-		    }
+		    record_full_next (&record_full_list);
 		}
 	    }
 	  while (continue_flag);
 
 	replay_out:
+	  struct record_full_entry entry;
+
+	  record_full_decode (record_full_list, &entry);
 	  if (record_full_get_sig)
 	    status->value.sig = GDB_SIGNAL_INT;
-	  else if (record_full_list->u.end.sigval != GDB_SIGNAL_0)
+	  else if (entry.type == record_full_end
+		   && entry.u.end.sigval != GDB_SIGNAL_0)
 	    /* FIXME: better way to check */
-	    status->value.sig = record_full_list->u.end.sigval;
+	    status->value.sig = entry.u.end.sigval;
 	  else
 	    status->value.sig = GDB_SIGNAL_TRAP;
 	}
       catch (const gdb_exception &ex)
 	{
 	  if (execution_direction == EXEC_REVERSE)
-	    {
-	      if (record_full_list->next)
-		record_full_list = record_full_list->next;
-	    }
+	    record_full_next (&record_full_list);
 	  else
-	    record_full_list = record_full_list->prev;
+	    record_full_prev (&record_full_list);
 
 	  throw;
 	}
@@ -1530,8 +1847,7 @@ record_full_registers_change (struct regcache *regcache, int regnum)
   /* Check record_full_insn_num.  */
   record_full_check_insn_num ();
 
-  record_full_arch_list_head = NULL;
-  record_full_arch_list_tail = NULL;
+  record_full_arch_list_release ();
 
   if (regnum < 0)
     {
@@ -1541,7 +1857,7 @@ record_full_registers_change (struct regcache *regcache, int regnum)
 	{
 	  if (record_full_arch_list_add_reg (regcache, i))
 	    {
-	      record_full_list_release (record_full_arch_list_tail);
+	      record_full_arch_list_release ();
 	      error (_("Process record: failed to record execution log."));
 	    }
 	}
@@ -1550,18 +1866,16 @@ record_full_registers_change (struct regcache *regcache, int regnum)
     {
       if (record_full_arch_list_add_reg (regcache, regnum))
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_release ();
 	  error (_("Process record: failed to record execution log."));
 	}
     }
   if (record_full_arch_list_add_end ())
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_release ();
       error (_("Process record: failed to record execution log."));
     }
-  record_full_list->next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = record_full_list;
-  record_full_list = record_full_arch_list_tail;
+  record_full_arch_list_commit ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -1655,11 +1969,10 @@ record_full_target::xfer_partial (enum target_object object,
       record_full_check_insn_num ();
 
       /* Record registers change to list as an instruction.  */
-      record_full_arch_list_head = NULL;
-      record_full_arch_list_tail = NULL;
+      record_full_arch_list_release ();
       if (record_full_arch_list_add_mem (offset, len))
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_release ();
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog,
 				"Process record: failed to record "
@@ -1668,16 +1981,14 @@ record_full_target::xfer_partial (enum target_object object,
 	}
       if (record_full_arch_list_add_end ())
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_release ();
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog,
 				"Process record: failed to record "
 				"execution log.");
 	  return TARGET_XFER_E_IO;
 	}
-      record_full_list->next = record_full_arch_list_head;
-      record_full_arch_list_head->prev = record_full_list;
-      record_full_list = record_full_arch_list_tail;
+      record_full_arch_list_commit ();
 
       if (record_full_insn_num == record_full_insn_max_num)
 	record_full_list_release_first ();
@@ -1843,10 +2154,12 @@ gdb_byte *
 record_full_base_target::get_bookmark (const char *args, int from_tty)
 {
   char *ret = NULL;
+  struct record_full_entry entry;
 
   /* Return stringified form of instruction count.  */
-  if (record_full_list && record_full_list->type == record_full_end)
-    ret = xstrdup (pulongest (record_full_list->u.end.insn_num));
+  record_full_decode (record_full_list, &entry);
+  if (entry.type == record_full_end)
+    ret = xstrdup (pulongest (entry.u.end.insn_num));
 
   if (record_debug)
     {
@@ -1902,7 +2215,9 @@ record_full_base_target::record_method (ptid_t ptid)
 void
 record_full_base_target::info_record ()
 {
-  struct record_full_entry *p;
+  struct record_full_pos p = record_full_first;
+  struct record_full_entry entry;
+  bool found = false;
 
   if (RECORD_FULL_IS_REPLAY)
     printf_filtered (_("Replay mode:\n"));
@@ -1910,22 +2225,26 @@ record_full_base_target::info_record ()
     printf_filtered (_("Record mode:\n"));
 
   /* Find entry for first actual instruction in the log.  */
-  for (p = record_full_first.next;
-       p != NULL && p->type != record_full_end;
-       p = p->next)
-    ;
+  while (!found && record_full_next (&p))
+    {
+      record_full_decode (p, &entry);
+      found = entry.type == record_full_end;
+    }
 
   /* Do we have a log at all?  */
-  if (p != NULL && p->type == record_full_end)
+  if (found)
     {
       /* Display instruction number for first instruction in the log.  */
       printf_filtered (_("Lowest recorded instruction number is %s.\n"),
-		       pulongest (p->u.end.insn_num));
+		       pulongest (entry.u.end.insn_num));
 
       /* If in replay mode, display where we are in the log.  */
       if (RECORD_FULL_IS_REPLAY)
-	printf_filtered (_("Current instruction number is %s.\n"),
-			 pulongest (record_full_list->u.end.insn_num));
+	{
+	  record_full_decode (record_full_list, &entry);
+	  printf_filtered (_("Current instruction number is %s.\n"),
+			   pulongest (entry.u.end.insn_num));
+	}
 
       /* Display instruction number for last instruction in the log.  */
       printf_filtered (_("Highest recorded instruction number is %s.\n"),
@@ -1980,23 +2299,28 @@ record_full_base_target::record_will_replay (ptid_t ptid, int dir)
 /* Go to a specific entry.  */
 
 static void
-record_full_goto_entry (struct record_full_entry *p)
+record_full_goto_entry (const struct record_full_pos *p)
 {
+  struct record_full_entry entry, current;
+
   if (p == NULL)
     error (_("Target insn not found."));
-  else if (p == record_full_list)
+  else if (*p == record_full_list)
     error (_("Already at target insn."));
-  else if (p->u.end.insn_num > record_full_list->u.end.insn_num)
+
+  record_full_decode (*p, &entry);
+  record_full_decode (record_full_list, &current);
+  if (entry.u.end.insn_num > current.u.end.insn_num)
     {
       printf_filtered (_("Go forward to insn number %s\n"),
-		       pulongest (p->u.end.insn_num));
-      record_full_goto_insn (p, EXEC_FORWARD);
+		       pulongest (entry.u.end.insn_num));
+      record_full_goto_insn (*p, EXEC_FORWARD);
     }
   else
     {
       printf_filtered (_("Go backward to insn number %s\n"),
-		       pulongest (p->u.end.insn_num));
-      record_full_goto_insn (p, EXEC_REVERSE);
+		       pulongest (entry.u.end.insn_num));
+      record_full_goto_insn (*p, EXEC_REVERSE);
     }
 
   registers_changed ();
@@ -2011,13 +2335,18 @@ record_full_goto_entry (struct record_full_entry *p)
 void
 record_full_base_target::goto_record_begin ()
 {
-  struct record_full_entry *p = NULL;
+  struct record_full_pos p = record_full_first;
+  struct record_full_entry entry;
 
-  for (p = &record_full_first; p != NULL; p = p->next)
-    if (p->type == record_full_end)
-      break;
+  do
+    {
+      record_full_decode (p, &entry);
+      if (entry.type == record_full_end)
+	break;
+    }
+  while (record_full_next (&p));
 
-  record_full_goto_entry (p);
+  record_full_goto_entry (entry.type == record_full_end ? &p : NULL);
 }
 
 /* The "goto_record_end" target method.  */
@@ -2025,15 +2354,20 @@ record_full_base_target::goto_record_begin ()
 void
 record_full_base_target::goto_record_end ()
 {
-  struct record_full_entry *p = NULL;
+  struct record_full_pos p = record_full_list;
+  struct record_full_entry entry;
 
-  for (p = record_full_list; p->next != NULL; p = p->next)
+  while (record_full_next (&p))
     ;
-  for (; p!= NULL; p = p->prev)
-    if (p->type == record_full_end)
-      break;
+  do
+    {
+      record_full_decode (p, &entry);
+      if (entry.type == record_full_end)
+	break;
+    }
+  while (record_full_prev (&p));
 
-  record_full_goto_entry (p);
+  record_full_goto_entry (entry.type == record_full_end ? &p : NULL);
 }
 
 /* The "goto_record" target method.  */
@@ -2041,13 +2375,19 @@ record_full_base_target::goto_record_end ()
 void
 record_full_base_target::goto_record (ULONGEST target_insn)
 {
-  struct record_full_entry *p = NULL;
+  struct record_full_pos p = record_full_first;
+  struct record_full_entry entry;
+  bool found = false;
 
-  for (p = &record_full_first; p != NULL; p = p->next)
-    if (p->type == record_full_end && p->u.end.insn_num == target_insn)
-      break;
+  do
+    {
+      record_full_decode (p, &entry);
+      found = (entry.type == record_full_end
+	       && entry.u.end.insn_num == target_insn);
+    }
+  while (!found && record_full_next (&p));
 
-  record_full_goto_entry (p);
+  record_full_goto_entry (found ? &p : NULL);
 }
 
 /* The "record_stop_replaying" target method.  */
@@ -2326,7 +2666,8 @@ static void
 record_full_restore (void)
 {
   uint32_t magic;
-  struct record_full_entry *rec;
+  struct record_full_entry rec {};
+  gdb_byte *val;
   asection *osec;
   uint32_t osec_size;
   int bfd_offset = 0;
@@ -2338,7 +2679,7 @@ record_full_restore (void)
     return;
 
   /* "record_full_restore" can only be called when record list is empty.  */
-  gdb_assert (record_full_first.next == NULL);
+  gdb_assert (record_full_first_chunk == NULL);
  
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog, "Restoring recording from core file.\n");
@@ -2365,10 +2706,9 @@ record_full_restore (void)
 			"RECORD_FULL_FILE_MAGIC (0x%s)\n",
 			phex_nz (netorder32 (magic), 4));
 
-  /* Restore the entries in recfd into record_full_arch_list_head and
-     record_full_arch_list_tail.  */
-  record_full_arch_list_head = NULL;
-  record_full_arch_list_tail = NULL;
+  /* Restore the entries in recfd into record_full_arch_list, and
+     append each instruction to the log.  */
+  record_full_arch_list_release ();
   record_full_insn_num = 0;
 
   try
@@ -2394,19 +2734,21 @@ record_full_restore (void)
 			    sizeof (regnum), &bfd_offset);
 	      regnum = netorder32 (regnum);
 
-	      rec = record_full_reg_alloc (regcache, regnum);
+	      rec.type = record_full_reg;
+	      rec.u.reg.num = regnum;
+	      rec.u.reg.len = register_size (regcache->arch (), regnum);
+	      val = record_full_arch_list_add (rec, rec.u.reg.len);
 
 	      /* Get val.  */
-	      bfdcore_read (core_bfd, osec, record_full_get_loc (rec),
-			    rec->u.reg.len, &bfd_offset);
+	      bfdcore_read (core_bfd, osec, val, rec.u.reg.len, &bfd_offset);
 
 	      if (record_debug)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Reading register %d (1 "
 				    "plus %lu plus %d bytes)\n",
-				    rec->u.reg.num,
+				    rec.u.reg.num,
 				    (unsigned long) sizeof (regnum),
-				    rec->u.reg.len);
+				    rec.u.reg.len);
 	      break;
 
 	    case record_full_mem: /* mem */
@@ -2420,39 +2762,43 @@ record_full_restore (void)
 			    sizeof (addr), &bfd_offset);
 	      addr = netorder64 (addr);
 
-	      rec = record_full_mem_alloc (addr, len);
+	      rec.type = record_full_mem;
+	      rec.u.mem.addr = addr;
+	      rec.u.mem.len = len;
+	      rec.u.mem.mem_entry_not_accessible = 0;
+	      val = record_full_arch_list_add (rec, len);
 
 	      /* Get val.  */
-	      bfdcore_read (core_bfd, osec, record_full_get_loc (rec),
-			    rec->u.mem.len, &bfd_offset);
+	      bfdcore_read (core_bfd, osec, val, rec.u.mem.len, &bfd_offset);
 
 	      if (record_debug)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Reading memory %s (1 plus "
 				    "%lu plus %lu plus %d bytes)\n",
 				    paddress (get_current_arch (),
-					      rec->u.mem.addr),
+					      rec.u.mem.addr),
 				    (unsigned long) sizeof (addr),
 				    (unsigned long) sizeof (len),
-				    rec->u.mem.len);
+				    rec.u.mem.len);
 	      break;
 
 	    case record_full_end: /* end */
-	      rec = record_full_end_alloc ();
+	      rec.type = record_full_end;
 	      record_full_insn_num ++;
 
 	      /* Get signal value.  */
 	      bfdcore_read (core_bfd, osec, &signal,
 			    sizeof (signal), &bfd_offset);
 	      signal = netorder32 (signal);
-	      rec->u.end.sigval = (enum gdb_signal) signal;
+	      rec.u.end.sigval = (enum gdb_signal) signal;
 
 	      /* Get insn count.  */
 	      bfdcore_read (core_bfd, osec, &count,
 			    sizeof (count), &bfd_offset);
 	      count = netorder32 (count);
-	      rec->u.end.insn_num = count;
+	      rec.u.end.insn_num = count;
 	      record_full_insn_count = count + 1;
+	      record_full_arch_list_add (rec, 0);
 	      if (record_debug)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Reading record_full_end (1 + "
@@ -2469,21 +2815,21 @@ record_full_restore (void)
 	      break;
 	    }
 
-	  /* Add rec to record arch list.  */
-	  record_full_arch_list_add (rec);
+	  /* Add the instruction to the end of record list.  */
+	  if (rectype == record_full_end)
+	    record_full_arch_list_commit ();
 	}
+
+      record_full_arch_list_commit ();
     }
   catch (const gdb_exception &ex)
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_release ();
+      record_full_list_release ();
       throw;
     }
 
-  /* Add record_full_arch_list_head to the end of record list.  */
-  record_full_first.next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = &record_full_first;
-  record_full_arch_list_tail->next = NULL;
-  record_full_list = &record_full_first;
+  record_full_list = record_full_first;
 
   /* Update record_full_insn_max_num.  */
   if (record_full_insn_num > record_full_insn_max_num)
@@ -2531,7 +2877,9 @@ cmd_record_full_restore (const char *args, int from_tty)
 void
 record_full_base_target::save_record (const char *recfilename)
 {
-  struct record_full_entry *cur_record_full_list;
+  struct record_full_pos cur_record_full_list;
+  struct record_full_pos p;
+  struct record_full_entry entry;
   uint32_t magic;
   struct regcache *regcache;
   struct gdbarch *gdbarch;
@@ -2565,31 +2913,32 @@ record_full_base_target::save_record (const char *recfilename)
   while (1)
     {
       /* Check for beginning and end of log.  */
-      if (record_full_list == &record_full_first)
+      if (record_full_list == record_full_first)
         break;
 
       record_full_exec_insn (regcache, gdbarch, record_full_list);
 
-      if (record_full_list->prev)
-        record_full_list = record_full_list->prev;
+      record_full_prev (&record_full_list);
     }
 
   /* Compute the size needed for the extra bfd section.  */
   save_size = 4;	/* magic cookie */
-  for (record_full_list = record_full_first.next; record_full_list;
-       record_full_list = record_full_list->next)
-    switch (record_full_list->type)
-      {
-      case record_full_end:
-	save_size += 1 + 4 + 4;
-	break;
-      case record_full_reg:
-	save_size += 1 + 4 + record_full_list->u.reg.len;
-	break;
-      case record_full_mem:
-	save_size += 1 + 4 + 8 + record_full_list->u.mem.len;
-	break;
-      }
+  for (p = record_full_first; record_full_next (&p); )
+    {
+      record_full_decode (p, &entry);
+      switch (entry.type)
+	{
+	case record_full_end:
+	  save_size += 1 + 4 + 4;
+	  break;
+	case record_full_reg:
+	  save_size += 1 + 4 + entry.u.reg.len;
+	  break;
+	case record_full_mem:
+	  save_size += 1 + 4 + 8 + entry.u.mem.len;
+	  break;
+	}
+    }
 
   /* Make the new bfd section.  */
   osec = bfd_make_section_anyway_with_flags (obfd.get (), "precord",
@@ -2619,39 +2968,40 @@ record_full_base_target::save_record (const char *recfilename)
 
   /* Save the entries to recfd and forward execute to the end of
      record list.  */
-  record_full_list = &record_full_first;
+  record_full_list = record_full_first;
   while (1)
     {
       /* Save entry.  */
-      if (record_full_list != &record_full_first)
+      if (record_full_list != record_full_first)
         {
 	  uint8_t type;
 	  uint32_t regnum, len, signal, count;
           uint64_t addr;
 
-	  type = record_full_list->type;
+	  record_full_decode (record_full_list, &entry);
+	  type = entry.type;
           bfdcore_write (obfd.get (), osec, &type, sizeof (type), &bfd_offset);
 
-          switch (record_full_list->type)
+          switch (entry.type)
             {
             case record_full_reg: /* reg */
 	      if (record_debug)
 		fprintf_unfiltered (gdb_stdlog,
 				    "  Writing register %d (1 "
 				    "plus %lu plus %d bytes)\n",
-				    record_full_list->u.reg.num,
+				    entry.u.reg.num,
 				    (unsigned long) sizeof (regnum),
-				    record_full_list->u.reg.len);
+				    entry.u.reg.len);
 
               /* Write regnum.  */
-              regnum = netorder32 (record_full_list->u.reg.num);
+              regnum = netorder32 (entry.u.reg.num);
               bfdcore_write (obfd.get (), osec, &regnum,
 			     sizeof (regnum), &bfd_offset);
 
               /* Write regval.  */
               bfdcore_write (obfd.get (), osec,
-			     record_full_get_loc (record_full_list),
-			     record_full_list->u.reg.len, &bfd_offset);
+			     entry.val,
+			     entry.u.reg.len, &bfd_offset);
               break;
 
             case record_full_mem: /* mem */
@@ -2660,25 +3010,25 @@ record_full_base_target::save_record (const char *recfilename)
 				    "  Writing memory %s (1 plus "
 				    "%lu plus %lu plus %d bytes)\n",
 				    paddress (gdbarch,
-					      record_full_list->u.mem.addr),
+					      entry.u.mem.addr),
 				    (unsigned long) sizeof (addr),
 				    (unsigned long) sizeof (len),
-				    record_full_list->u.mem.len);
+				    entry.u.mem.len);
 
 	      /* Write memlen.  */
-	      len = netorder32 (record_full_list->u.mem.len);
+	      len = netorder32 (entry.u.mem.len);
 	      bfdcore_write (obfd.get (), osec, &len, sizeof (len),
 			     &bfd_offset);
 
 	      /* Write memaddr.  */
-	      addr = netorder64 (record_full_list->u.mem.addr);
+	      addr = netorder64 (entry.u.mem.addr);
 	      bfdcore_write (obfd.get (), osec, &addr, 
 			     sizeof (addr), &bfd_offset);
 
 	      /* Write memval.  */
 	      bfdcore_write (obfd.get (), osec,
-			     record_full_get_loc (record_full_list),
-			     record_full_list->u.mem.len, &bfd_offset);
+			     entry.val,
+			     entry.u.mem.len, &bfd_offset);
               break;
 
               case record_full_end:
@@ -2689,12 +3039,12 @@ record_full_base_target::save_record (const char *recfilename)
 				      (unsigned long) sizeof (signal),
 				      (unsigned long) sizeof (count));
 		/* Write signal value.  */
-		signal = netorder32 (record_full_list->u.end.sigval);
+		signal = netorder32 (entry.u.end.sigval);
 		bfdcore_write (obfd.get (), osec, &signal,
 			       sizeof (signal), &bfd_offset);
 
 		/* Write insn count.  */
-		count = netorder32 (record_full_list->u.end.insn_num);
+		count = netorder32 (entry.u.end.insn_num);
 		bfdcore_write (obfd.get (), osec, &count,
 			       sizeof (count), &bfd_offset);
                 break;
@@ -2704,9 +3054,7 @@ record_full_base_target::save_record (const char *recfilename)
       /* Execute entry.  */
       record_full_exec_insn (regcache, gdbarch, record_full_list);
 
-      if (record_full_list->next)
-        record_full_list = record_full_list->next;
-      else
+      if (!record_full_next (&record_full_list))
         break;
     }
 
@@ -2719,8 +3067,7 @@ record_full_base_target::save_record (const char *recfilename)
 
       record_full_exec_insn (regcache, gdbarch, record_full_list);
 
-      if (record_full_list->prev)
-        record_full_list = record_full_list->prev;
+      record_full_prev (&record_full_list);
     }
 
   unlink_file.keep ();
@@ -2735,7 +3082,7 @@ record_full_base_target::save_record (const char *recfilename)
    correspondingly.  */
 
 static void
-record_full_goto_insn (struct record_full_entry *entry,
+record_full_goto_insn (const struct record_full_pos &entry,
 		       enum exec_direction_kind dir)
 {
   scoped_restore restore_operation_disable
@@ -2747,15 +3094,15 @@ record_full_goto_insn (struct record_full_entry *entry,
      and we will not hit the end of the recording.  */
 
   if (dir == EXEC_FORWARD)
-    record_full_list = record_full_list->next;
+    record_full_next (&record_full_list);
 
   do
     {
       record_full_exec_insn (regcache, gdbarch, record_full_list);
       if (dir == EXEC_REVERSE)
-	record_full_list = record_full_list->prev;
+	record_full_prev (&record_full_list);
       else
-	record_full_list = record_full_list->next;
+	record_full_next (&record_full_list);
     } while (record_full_list != entry);
 }
 
@@ -2801,16 +3148,59 @@ show_record_full_command (const char *args, int from_tty)
   cmd_show_list (show_record_full_cmdlist, from_tty, "");
 }
 
+/* The "maintenance info record-full" command.  */
+
+static void
+maint_info_record_full_cmd (const char *args, int from_tty)
+{
+  struct record_full_pos p = record_full_first;
+  struct record_full_entry entry;
+  ULONGEST counts[3] = { 0, 0, 0 };
+  ULONGEST used = 0, allocated = 0, chunks = 0;
+
+  if (args != NULL && *args != 0)
+    error (_("Invalid argument."));
+
+  if (!record_full_is_used ())
+    error (_("No full record target is currently active."));
+
+  for (struct record_full_chunk *chunk = record_full_first_chunk;
+       chunk != NULL;
+       chunk = chunk->next)
+    {
+      chunks++;
+      used += chunk->used;
+      allocated += chunk->size;
+    }
+  if (record_full_first_chunk != NULL)
+    used -= record_full_first_offset;
+
+  while (record_full_next (&p))
+    {
+      record_full_decode (p, &entry);
+      counts[entry.type]++;
+    }
+
+  printf_unfiltered (_("Number of instructions: %s.\n"),
+		     pulongest (counts[record_full_end]));
+  printf_unfiltered (_("Number of register entries: %s.\n"),
+		     pulongest (counts[record_full_reg]));
+  printf_unfiltered (_("Number of memory entries: %s.\n"),
+		     pulongest (counts[record_full_mem]));
+  printf_unfiltered (_("Log size: %s bytes in %s chunks "
+		       "(%s bytes allocated).\n"),
+		     pulongest (used), pulongest (chunks),
+		     pulongest (allocated));
+  if (counts[record_full_end] != 0)
+    printf_unfiltered (_("Bytes per instruction: %.1f.\n"),
+		       (double) used / counts[record_full_end]);
+}
+
 void
 _initialize_record_full (void)
 {
   struct cmd_list_element *c;
 
-  /* Init record_full_first.  */
-  record_full_first.prev = NULL;
-  record_full_first.next = NULL;
-  record_full_first.type = record_full_end;
-
   add_target (record_full_target_info, record_full_open);
   add_deprecated_target_alias (record_full_target_info, "record");
   add_target (record_full_core_target_info, record_full_open);
@@ -2819,6 +3209,10 @@ _initialize_record_full (void)
 		  _("Start full execution recording."), &record_full_cmdlist,
 		  "record full ", 0, &record_cmdlist);
 
+  add_cmd ("record-full", class_maintenance, maint_info_record_full_cmd,
+	   _("Info about the execution log of the full record target."),
+	   &maintenanceinfolist);
+
   c = add_cmd ("restore", class_obscure, cmd_record_full_restore,
 	       _("Restore the execution log from a file.\n\
 Argument is filename.  File must be created with 'record save'."),
@@ -76,6 +76,7 @@
 #include "common/environ.h"
 #include "common/byte-vector.h"
 #include <unordered_map>
+#include <zlib.h>
 
 /* The remote target.  */
 
@@ -250,6 +251,10 @@ public: /* data */
      Otherwise zero, meaning to use the guessed size.  */
   long explicit_packet_size = 0;
 
+  /* The maximum size of a reply to the qMemRead packet, as reported
+     by the stub in its qSupported reply.  Zero if not reported.  */
+  long memread_packet_size = 0;
+
   /* remote_wait is normally called when the target is running and
      waits for a stop reply packet.  But sometimes we need to call it
      when the target is already stopped.  We can send a "?" packet
@@ -503,6 +508,10 @@ public:
 
   ULONGEST get_memory_xfer_limit () override;
 
+  bool read_memory_ranges (const std::vector<mem_range> &ranges,
+			   gdb_byte *myaddr,
+			   std::vector<ULONGEST> *xfered) override;
+
   void rcmd (const char *command, struct ui_file *output) override;
 
   char *pid_to_exec_file (int pid) override;
@@ -530,6 +539,8 @@ public:
 		     const gdb_byte *pattern, ULONGEST pattern_len,
 		     CORE_ADDR *found_addrp) override;
 
+  bool supports_native_search_memory () override;
+
   bool can_async_p () override;
 
   bool is_async_p () override;
@@ -815,6 +826,10 @@ public: /* Remote specific methods.  */
   void remote_packet_size (const protocol_feature *feature,
 			   packet_support support, const char *value);
 
+  void remote_memread_packet_size (const protocol_feature *feature,
+				   packet_support support,
+				   const char *value);
+
   void remote_serial_quit_handler ();
 
   void remote_detach_pid (int pid);
@@ -859,6 +874,10 @@ public: /* Remote specific methods.  */
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  packet_result remote_read_ranges (const std::vector<mem_range> &ranges,
+				    gdb_byte *myaddr,
+				    std::vector<ULONGEST> *xfered);
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -2099,6 +2118,12 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for reading several memory ranges with one packet.  */
+  PACKET_qMemRead,
+
+  /* Support for zlib-compressed qMemRead replies.  */
+  PACKET_qMemRead_zlib,
+
   PACKET_MAX
 };
 
@@ -5079,6 +5104,49 @@ remote_packet_size (remote_target *remote, const protocol_feature *feature,
   remote->remote_packet_size (feature, support, value);
 }
 
+void
+remote_target::remote_memread_packet_size (const protocol_feature *feature,
+					   enum packet_support support,
+					   const char *value)
+{
+  struct remote_state *rs = get_remote_state ();
+  long packet_size;
+  char *value_end;
+
+  remote_protocol_packets[feature->packet].support = PACKET_DISABLE;
+  rs->memread_packet_size = 0;
+
+  if (support != PACKET_ENABLE)
+    return;
+
+  if (value == NULL || *value == '\0')
+    {
+      warning (_("Remote target reported \"%s\" without a size."),
+	       feature->name);
+      return;
+    }
+
+  errno = 0;
+  packet_size = strtol (value, &value_end, 16);
+  if (errno != 0 || *value_end != '\0' || packet_size <= 0)
+    {
+      warning (_("Remote target reported \"%s\" with a bad size: \"%s\"."),
+	       feature->name, value);
+      return;
+    }
+
+  remote_protocol_packets[feature->packet].support = PACKET_ENABLE;
+  rs->memread_packet_size = packet_size;
+}
+
+static void
+remote_memread_packet_size (remote_target *remote,
+			    const protocol_feature *feature,
+			    enum packet_support support, const char *value)
+{
+  remote->remote_memread_packet_size (feature, support, value);
+}
+
 static const struct protocol_feature remote_protocol_features[] = {
   { "PacketSize", PACKET_DISABLE, remote_packet_size, -1 },
   { "qXfer:auxv:read", PACKET_DISABLE, remote_supported_packet,
@@ -5186,6 +5254,9 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "qMemRead", PACKET_DISABLE, remote_memread_packet_size, PACKET_qMemRead },
+  { "qMemRead:zlib", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qMemRead_zlib },
 };
 
 static char *remote_support_xml;
@@ -8712,6 +8783,34 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   int todo_units;
   int decoded_bytes;
 
+  /* Prefer qMemRead, whose replies can be larger than the "m" ones
+     and may be compressed.  It only deals in bytes.  */
+  if (unit_size == 1 && packet_support (PACKET_qMemRead) == PACKET_ENABLE)
+    {
+      ULONGEST max_len = rs->memread_packet_size;
+      std::vector<ULONGEST> xfered;
+
+      /* Compressed replies can carry more than their size in data.
+	 The stub trims the request to what it can send anyway.  */
+      if (packet_support (PACKET_qMemRead_zlib) == PACKET_ENABLE)
+	max_len *= 4;
+
+      std::vector<mem_range> ranges
+	{ mem_range (memaddr, std::min (len_units, max_len)) };
+      packet_result result = remote_read_ranges (ranges, myaddr, &xfered);
+
+      if (result == PACKET_OK)
+	{
+	  *xfered_len_units = xfered.empty () ? 0 : xfered[0];
+	  return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_E_IO;
+	}
+      else if (result == PACKET_ERROR)
+	return TARGET_XFER_E_IO;
+
+      /* The stub does not understand qMemRead after all.  Fall back
+	 to the "m" packet.  */
+    }
+
   buf_size_bytes = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
@@ -8743,6 +8842,133 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Read the memory RANGES from the remote target with a single
+   qMemRead packet, storing their contents one after the other in
+   MYADDR, which must be large enough to hold all of them.  Set
+   XFERED to the number of bytes read from each range.  A zero length
+   means the range could not be read.  Ranges that would not fit in
+   the request or the reply are left out of XFERED, and should be
+   asked for again.
+
+   Return PACKET_OK on success, PACKET_ERROR if the stub reported an
+   error and PACKET_UNKNOWN if it does not support qMemRead.  */
+
+packet_result
+remote_target::remote_read_ranges (const std::vector<mem_range> &ranges,
+				   gdb_byte *myaddr,
+				   std::vector<ULONGEST> *xfered)
+{
+  struct remote_state *rs = get_remote_state ();
+  int max_size = get_remote_packet_size ();
+  bool compress = packet_support (PACKET_qMemRead_zlib) == PACKET_ENABLE;
+  size_t nranges = 0;
+  char *p;
+
+  gdb_assert (!ranges.empty ());
+
+  /* Construct "qMemRead:"["Z;"]<addr>","<len>[";"<addr>","<len>]...  */
+  p = rs->buf.data ();
+  p += xsnprintf (p, max_size, "qMemRead:%s", compress ? "Z;" : "");
+  for (const mem_range &r : ranges)
+    {
+      /* Room for two 64-bit numbers, the separators, and the
+	 terminating NUL.  */
+      if (nranges > 0 && (p - rs->buf.data ()) + 35 > max_size)
+	break;
+
+      if (nranges > 0)
+	*p++ = ';';
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (r.start));
+      *p++ = ',';
+      p += hexnumstr (p, (ULONGEST) r.length);
+      nranges++;
+    }
+  *p = '\0';
+
+  putpkt (rs->buf);
+  int packet_len = getpkt_sane (&rs->buf, 0);
+  if (packet_len < 0)
+    return PACKET_ERROR;
+
+  packet_result result
+    = packet_ok (rs->buf, &remote_protocol_packets[PACKET_qMemRead]);
+  if (result != PACKET_OK)
+    return result;
+
+  /* The reply is "b" or "z", the lengths read, ";", and the data.  */
+  char kind = rs->buf[0];
+  if (kind != 'b' && kind != 'z')
+    error (_("Unknown remote qMemRead reply: %s"), rs->buf.data ());
+
+  const char *q = rs->buf.data () + 1;
+  ULONGEST total = 0;
+
+  xfered->clear ();
+  while (*q != ';')
+    {
+      ULONGEST len;
+      const char *end = unpack_varlen_hex (q, &len);
+
+      if (end == q || xfered->size () >= nranges
+	  || len > (ULONGEST) ranges[xfered->size ()].length)
+	error (_("Malformed remote qMemRead reply."));
+
+      xfered->push_back (len);
+      total += len;
+      q = end;
+      if (*q == ',')
+	q++;
+      else if (*q != ';')
+	error (_("Malformed remote qMemRead reply."));
+    }
+  q++;
+
+  const gdb_byte *data = (const gdb_byte *) q;
+  int data_len = packet_len - (q - rs->buf.data ());
+
+  if (kind == 'b')
+    {
+      if ((ULONGEST) remote_unescape_input (data, data_len, myaddr, total)
+	  != total)
+	error (_("Remote qMemRead reply is too short."));
+    }
+  else
+    {
+      gdb::byte_vector zdata (data_len);
+      int zlen = remote_unescape_input (data, data_len, zdata.data (),
+					data_len);
+      uLongf out_len = total;
+
+      if (uncompress (myaddr, &out_len, zdata.data (), zlen) != Z_OK
+	  || out_len != total)
+	error (_("Could not decompress remote qMemRead reply."));
+    }
+
+  return PACKET_OK;
+}
+
+/* Implementation of the read_memory_ranges method, using the qMemRead
+   packet.  */
+
+bool
+remote_target::read_memory_ranges (const std::vector<mem_range> &ranges,
+				   gdb_byte *myaddr,
+				   std::vector<ULONGEST> *xfered)
+{
+  /* Like remote_read_bytes_1, only use qMemRead for byte-addressed
+     memory, and leave traceframes to remote_read_bytes.  */
+  if (packet_support (PACKET_qMemRead) != PACKET_ENABLE
+      || gdbarch_addressable_memory_unit_size (target_gdbarch ()) != 1
+      || !target_has_execution
+      || get_traceframe_number () != -1)
+    return false;
+
+  set_remote_traceframe ();
+  set_general_thread (inferior_ptid);
+
+  return remote_read_ranges (ranges, myaddr, xfered) == PACKET_OK;
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -11137,6 +11363,19 @@ remote_target::search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
   return found;
 }
 
+/* Implementation of the supports_native_search_memory method.  Until
+   qSearch:memory was tried, assume the stub supports it;
+   search_memory falls back to reading memory if it does not.  */
+
+bool
+remote_target::supports_native_search_memory ()
+{
+  struct packet_config *packet
+    = &remote_protocol_packets[PACKET_qSearch_memory];
+
+  return packet_config_support (packet) != PACKET_DISABLE;
+}
+
 void
 remote_target::rcmd (const char *command, struct ui_file *outbuf)
 {
@@ -14671,6 +14910,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qMemRead],
+			 "qMemRead", "memory-read-ranges", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qMemRead_zlib],
+			 "qMemRead:zlib", "memory-read-compression", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -46,7 +46,10 @@
 #include "filesystem.h"
 #include "gdb_bfd.h"
 #include "common/filestuff.h"
+#include "common/scoped_fd.h"
 #include "source.h"
+#include "build-id.h"
+#include "maint.h"
 
 /* Architecture-specific operations.  */
 
@@ -677,16 +680,9 @@ solib_read_symbols (struct so_list *so, symfile_add_flags flags)
       try
 	{
 	  /* Have we already loaded this shared object?  */
-	  so->objfile = nullptr;
-	  for (objfile *objfile : current_program_space->objfiles ())
-	    {
-	      if (filename_cmp (objfile_name (objfile), so->so_name) == 0
-		  && objfile->addr_low == so->addr_low)
-		{
-		  so->objfile = objfile;
-		  break;
-		}
-	    }
+	  so->objfile
+	    = current_program_space->lookup_objfile_by_name (so->so_name,
+							     so->addr_low);
 	  if (so->objfile == NULL)
 	    {
 	      section_addr_info sap
@@ -713,6 +709,68 @@ solib_read_symbols (struct so_list *so, symfile_add_flags flags)
   return 0;
 }
 
+/* Ask the system to read into the page cache, in the background, the
+   parts of the file of ABFD that reading its symbols touches: the
+   sections that are not loaded in memory, which hold the debug info
+   and its indexes, and the unwind tables.  */
+
+static void
+solib_prefetch_bfd (bfd *abfd)
+{
+#ifdef HAVE_POSIX_FADVISE
+  scoped_fd fd (gdb_open_cloexec (bfd_get_filename (abfd),
+				  O_RDONLY | O_BINARY, 0));
+
+  if (fd.get () < 0)
+    return;
+
+  for (asection *sect = abfd->sections; sect != NULL; sect = sect->next)
+    {
+      flagword flags = bfd_get_section_flags (abfd, sect);
+
+      if ((flags & SEC_HAS_CONTENTS) == 0)
+	continue;
+      if ((flags & SEC_ALLOC) != 0
+	  && strcmp (bfd_get_section_name (abfd, sect), ".eh_frame") != 0)
+	continue;
+
+      posix_fadvise (fd.get (), sect->filepos,
+		     bfd_get_section_size (sect), POSIX_FADV_WILLNEED);
+    }
+#endif
+}
+
+/* Start reading the files of SOS ahead of solib_read_symbols, so that
+   reading their symbols finds them in the page cache instead of
+   waiting for each one in turn.  This covers the shared objects
+   themselves and the separate debug files their build-ids point to.
+   The system reads the files in the background; nothing waits for it.
+   Only the sections that symbol reading uses are read ahead, not the
+   code and data of the libraries.  */
+
+static void
+solib_prefetch (const std::vector<so_list *> &sos)
+{
+  for (so_list *so : sos)
+    {
+      if (so->abfd == NULL)
+	continue;
+
+      solib_prefetch_bfd (so->abfd);
+
+      const bfd_build_id *build_id = build_id_bfd_shdr_get (so->abfd);
+      if (build_id != NULL)
+	{
+	  gdb_bfd_ref_ptr debug_bfd
+	    = build_id_to_debug_bfd (build_id->size, build_id->data,
+				     NULL, 1);
+
+	  if (debug_bfd != NULL)
+	    solib_prefetch_bfd (debug_bfd.get ());
+	}
+    }
+}
+
 /* Return 1 if KNOWN->objfile is used by any other so_list object in the
    SO_LIST_HEAD list.  Return 0 otherwise.  */
 
@@ -866,6 +924,9 @@ update_solib_list (int from_tty)
 	  i->pspace = current_program_space;
 	  current_program_space->added_solibs.push_back (i);
 
+	  std::chrono::steady_clock::time_point start
+	    = std::chrono::steady_clock::now ();
+
 	  try
 	    {
 	      /* Fill in the rest of the `struct so_list' node.  */
@@ -884,6 +945,8 @@ update_solib_list (int from_tty)
 				   "library sections:\n"));
 	    }
 
+	  i->map_time = std::chrono::steady_clock::now () - start;
+
 	  /* Notify any observer that the shared object has been
 	     loaded now that we've added it to GDB's tables.  */
 	  gdb::observers::solib_loaded.notify (i);
@@ -979,6 +1042,16 @@ solib_add (const char *pattern, int from_tty, int readsyms)
     if (from_tty)
         add_flags |= SYMFILE_VERBOSE;
 
+    /* Start reading the files of the libraries whose symbols will be
+       read below.  */
+    std::vector<so_list *> to_read;
+    for (gdb = so_list_head; gdb; gdb = gdb->next)
+      if ((! pattern || re_exec (gdb->so_name))
+	  && (readsyms || libpthread_solib_p (gdb))
+	  && !gdb->symbols_loaded)
+	to_read.push_back (gdb);
+    solib_prefetch (to_read);
+
     for (gdb = so_list_head; gdb; gdb = gdb->next)
       if (! pattern || re_exec (gdb->so_name))
 	{
@@ -1001,11 +1074,30 @@ solib_add (const char *pattern, int from_tty, int readsyms)
 		    printf_unfiltered (_("Symbols already loaded for %s\n"),
 				       gdb->so_name);
 		}
-	      else if (solib_read_symbols (gdb, add_flags))
-		loaded_any_symbols = 1;
+	      else
+		{
+		  std::chrono::steady_clock::time_point start
+		    = std::chrono::steady_clock::now ();
+
+		  if (solib_read_symbols (gdb, add_flags))
+		    loaded_any_symbols = 1;
+		  gdb->symbols_time = std::chrono::steady_clock::now () - start;
+		}
 	    }
 	}
 
+    if (per_command_time_p ())
+      for (so_list *so : to_read)
+	{
+	  using namespace std::chrono;
+
+	  printf_unfiltered (_("Shared library %s: %.6f (map), "
+			       "%.6f (symbols)\n"),
+			     so->so_name,
+			     duration<double> (so->map_time).count (),
+			     duration<double> (so->symbols_time).count ());
+	}
+
     if (loaded_any_symbols)
       breakpoint_re_set ();
 
@@ -23,6 +23,7 @@
 /* For domain_enum domain.  */
 #include "symtab.h"
 #include "gdb_bfd.h"
+#include <chrono>
 
 #define ALL_SO_LIBS(so) \
     for (so = so_list_head; \
@@ -86,6 +87,12 @@ struct so_list
      that supports outputting multiple segments once the related code
      supports them.  */
   CORE_ADDR addr_low, addr_high;
+
+  /* The time spent opening the shared object and mapping its
+     sections, and reading its symbols.  Shown by solib_add when "maint
+     set per-command time" is on.  */
+  std::chrono::steady_clock::duration map_time;
+  std::chrono::steady_clock::duration symbols_time;
 };
 
 struct target_so_ops
@@ -3792,6 +3792,71 @@ symfile_free_objfile (struct objfile *objfile)
     remove_target_sections ((void *) objfile);
 }
 
+/* The maximum size, in megabytes, of the debug information a single
+   expand_symtabs_matching call may expand, or -1 if unlimited.  Used
+   for "set max-symtab-expansion-size".  */
+static int max_symtab_expansion_size = -1;
+
+/* The maximum time, in seconds, a single expand_symtabs_matching call
+   may spend expanding symtabs, or -1 if unlimited.  Used for "set
+   max-symtab-expansion-time".  */
+static int max_symtab_expansion_time = -1;
+
+/* The expansion budget of an expand_symtabs_matching call.  */
+
+struct symtab_expansion_budget
+{
+  /* When the call started.  */
+  std::chrono::steady_clock::time_point start;
+
+  /* The size of the debug information expanded so far.  */
+  ULONGEST bytes = 0;
+
+  /* Whether the budget has been used up.  */
+  bool exhausted = false;
+};
+
+/* The budget of the outermost expand_symtabs_matching call in
+   progress, or NULL.  */
+static symtab_expansion_budget *current_expansion_budget;
+
+/* See symfile.h.  */
+
+void
+record_symtab_expansion (struct objfile *objfile, ULONGEST bytes)
+{
+  OBJSTAT (objfile, n_expanded_units++);
+  OBJSTAT (objfile, sz_expanded += bytes);
+
+  if (current_expansion_budget != NULL)
+    current_expansion_budget->bytes += bytes;
+}
+
+/* See symfile.h.  */
+
+bool
+symtab_expansion_budget_exhausted ()
+{
+  symtab_expansion_budget *budget = current_expansion_budget;
+
+  if (budget == NULL)
+    return false;
+
+  if (!budget->exhausted)
+    {
+      if (max_symtab_expansion_size >= 0
+	  && (budget->bytes
+	      >= (ULONGEST) max_symtab_expansion_size * 1024 * 1024))
+	budget->exhausted = true;
+      else if (max_symtab_expansion_time >= 0
+	       && (std::chrono::steady_clock::now () - budget->start
+		   >= std::chrono::seconds (max_symtab_expansion_time)))
+	budget->exhausted = true;
+    }
+
+  return budget->exhausted;
+}
+
 /* Wrapper around the quick_symbol_functions expand_symtabs_matching "method".
    Expand all symtabs that match the specified criteria.
    See quick_symbol_functions.expand_symtabs_matching for details.  */
@@ -3804,6 +3869,15 @@ expand_symtabs_matching
    gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
    enum search_domain kind)
 {
+  /* A nested call is charged to the budget of the outermost one.  */
+  symtab_expansion_budget budget;
+  bool outermost = current_expansion_budget == NULL;
+
+  budget.start = std::chrono::steady_clock::now ();
+  scoped_restore restore_budget
+    = make_scoped_restore (&current_expansion_budget,
+			   outermost ? &budget : current_expansion_budget);
+
   for (objfile *objfile : current_program_space->objfiles ())
     {
       if (objfile->sf)
@@ -3812,6 +3886,18 @@ expand_symtabs_matching
 						  symbol_matcher,
 						  expansion_notify, kind);
     }
+
+  if (outermost && budget.exhausted)
+    {
+      std::chrono::duration<double> elapsed
+	= std::chrono::steady_clock::now () - budget.start;
+
+      warning (_("Stopped expanding symbol tables after %s bytes of debug "
+		 "information and %.1f seconds; the results may be "
+		 "incomplete.  Use \"set max-symtab-expansion-size\" and "
+		 "\"set max-symtab-expansion-time\" to change the limits."),
+	       pulongest (budget.bytes), elapsed.count ());
+    }
 }
 
 /* Wrapper around the quick_symbol_functions map_symbol_filenames "method".
@@ -3889,6 +3975,34 @@ test_set_ext_lang_command ()
 
 #endif /* GDB_SELF_TEST */
 
+/* Implement "show max-symtab-expansion-size".  */
+
+static void
+show_max_symtab_expansion_size (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  if (max_symtab_expansion_size == -1)
+    fprintf_filtered (file, _("The debug information a symbol search may "
+			      "expand is unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The debug information a symbol search may "
+			      "expand is %s megabytes.\n"), value);
+}
+
+/* Implement "show max-symtab-expansion-time".  */
+
+static void
+show_max_symtab_expansion_time (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  if (max_symtab_expansion_time == -1)
+    fprintf_filtered (file, _("The time a symbol search may spend expanding "
+			      "symbol tables is unlimited.\n"));
+  else
+    fprintf_filtered (file, _("The time a symbol search may spend expanding "
+			      "symbol tables is %s seconds.\n"), value);
+}
+
 void
 _initialize_symfile (void)
 {
@@ -3993,6 +4107,34 @@ each global debug-file-directory component prepended."),
 				     show_debug_file_directory,
 				     &setlist, &showlist);
 
+  add_setshow_zuinteger_unlimited_cmd ("max-symtab-expansion-size",
+				       class_support,
+				       &max_symtab_expansion_size, _("\
+Set the debug information a symbol search may expand, in megabytes."), _("\
+Show the debug information a symbol search may expand, in megabytes."), _("\
+Searches for symbols by pattern, such as \"info functions REGEXP\" or\n\
+completion, expand the symbol tables of every matching compilation unit.\n\
+Once the expanded units hold this much debug information, the search\n\
+stops expanding them and returns the symbols found so far, with a\n\
+warning.  \"unlimited\" means no limit."),
+				       NULL,
+				       show_max_symtab_expansion_size,
+				       &setlist, &showlist);
+
+  add_setshow_zuinteger_unlimited_cmd ("max-symtab-expansion-time",
+				       class_support,
+				       &max_symtab_expansion_time, _("\
+Set the time a symbol search may spend expanding symbol tables, in seconds."), _("\
+Show the time a symbol search may spend expanding symbol tables, in seconds."), _("\
+Searches for symbols by pattern, such as \"info functions REGEXP\" or\n\
+completion, expand the symbol tables of every matching compilation unit.\n\
+Once the search has run for this long, it stops expanding them and\n\
+returns the symbols found so far, with a warning.  \"unlimited\" means\n\
+no limit."),
+				       NULL,
+				       show_max_symtab_expansion_time,
+				       &setlist, &showlist);
+
   add_setshow_enum_cmd ("symbol-loading", no_class,
 			print_symbol_loading_enums, &print_symbol_loading,
 			_("\
@@ -528,6 +528,22 @@ void expand_symtabs_matching
    gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
    enum search_domain kind);
 
+/* Record that a compunit symtab of OBJFILE was expanded from BYTES
+   bytes of debug information.  This updates the statistics of OBJFILE
+   and charges the expansion budget of the expand_symtabs_matching
+   call in progress, if any.  */
+
+extern void record_symtab_expansion (struct objfile *objfile,
+				     ULONGEST bytes);
+
+/* Return true if the expand_symtabs_matching call in progress has used
+   up its budget, see "set max-symtab-expansion-size" and "set
+   max-symtab-expansion-time".  The expand_symtabs_matching methods of
+   the quick symbol functions stop expanding symtabs when this returns
+   true, so that the lookup returns partial results.  */
+
+extern bool symtab_expansion_budget_exhausted ();
+
 void map_symbol_filenames (symbol_filename_ftype *fun, void *data,
 			   int need_fullname);
 
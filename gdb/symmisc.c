@@ -103,6 +103,9 @@ print_objfile_statistics (void)
       if (OBJSTAT (objfile, n_types) > 0)
 	printf_filtered (_("  Number of \"types\" defined: %d\n"),
 			 OBJSTAT (objfile, n_types));
+      if (OBJSTAT (objfile, n_expanded_units) > 0)
+	printf_filtered (_("  Number of compunit symtabs expanded: %d\n"),
+			 OBJSTAT (objfile, n_expanded_units));
       if (objfile->sf)
 	objfile->sf->qf->print_stats (objfile);
       i = linetables = 0;
@@ -1038,6 +1041,46 @@ maintenance_info_line_tables (const char *regexp, int from_tty)
       }
 }
 
+/* Implement the 'maint info symtab-expansion' command.  */
+
+static void
+maintenance_info_symtab_expansion (const char *regexp, int from_tty)
+{
+  struct program_space *pspace;
+  bool found = false;
+
+  dont_repeat ();
+
+  if (regexp != NULL)
+    re_comp (regexp);
+
+  ALL_PSPACES (pspace)
+    for (objfile *objfile : pspace->objfiles ())
+      {
+	QUIT;
+
+	if (OBJSTAT (objfile, n_expanded_units) == 0
+	    || (regexp != NULL && !re_exec (objfile_name (objfile))))
+	  continue;
+
+	if (!found)
+	  printf_filtered (_("%-9s %-13s %-11s %s\n"),
+			   "Units", "Bytes", "Seconds", "Objfile");
+	found = true;
+
+	std::chrono::duration<double> seconds
+	  = OBJSTAT (objfile, expansion_time);
+	std::string seconds_str = string_printf ("%.6f", seconds.count ());
+	printf_filtered ("%-9d %-13s %-11s %s\n",
+			 OBJSTAT (objfile, n_expanded_units),
+			 pulongest (OBJSTAT (objfile, sz_expanded)),
+			 seconds_str.c_str (), objfile_name (objfile));
+      }
+
+  if (!found)
+    printf_filtered (_("No symbol tables have been expanded.\n"));
+}
+
 
 
 /* Do early runtime initializations.  */
@@ -1086,6 +1129,15 @@ With an argument REGEXP, list just the line tables for the symbol\n\
 tables with matching names."),
 	   &maintenanceinfolist);
 
+  add_cmd ("symtab-expansion", class_maintenance,
+	   maintenance_info_symtab_expansion, _("\
+List the symbol tables expanded from each object file.\n\
+For each object file that expanded compunit symtabs, print how many\n\
+were expanded, the size of the debug information they were expanded\n\
+from, and the time spent expanding them.\n\
+With an argument REGEXP, list just the object files with matching names."),
+	   &maintenanceinfolist);
+
   add_cmd ("check-symtabs", class_maintenance, maintenance_check_symtabs,
 	   _("\
 Check consistency of currently expanded symtabs."),
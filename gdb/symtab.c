@@ -68,6 +68,8 @@
 #include "filename-seen-cache.h"
 #include "arch-utils.h"
 #include <algorithm>
+#include <numeric>
+#include <set>
 #include "common/pathstuff.h"
 
 /* Forward declarations for local functions.  */
@@ -3036,6 +3038,126 @@ find_symbol_at_address (CORE_ADDR address)
 
 
 
+/* An entry of the line index of a compunit, see
+   build_compunit_line_index.  The PCs from PC up to the PC of the
+   next entry are in the line LINE of SYMTAB, which may be any of the
+   filetabs of the compunit, and that line starts at LINE_PC.  If
+   SYMTAB is NULL, there is no line information for these PCs.  */
+
+struct line_index_entry
+{
+  CORE_ADDR pc;
+  CORE_ADDR line_pc;
+  struct symtab *symtab;
+  int line;
+};
+
+/* The line tables of all the filetabs of a compunit, merged into a
+   single table of PC ranges.  Heavily templated C++ code can have
+   hundreds of filetabs per compunit, and searching each of their line
+   tables for every PC is slow.  */
+
+struct compunit_line_index
+{
+  int nitems;
+  struct line_index_entry *items;
+};
+
+/* Build the line index of CUST.  For every PC at which an entry of
+   some line table starts, compute the result the search of the line
+   tables of all the filetabs would give: the line of the latest entry
+   at or before the PC in each table, ignoring the tables in which
+   this entry ends a sequence (line zero), and preferring the earlier
+   filetab for entries at the same PC.  */
+
+static struct compunit_line_index *
+build_compunit_line_index (struct compunit_symtab *cust)
+{
+  struct objfile *objfile = COMPUNIT_OBJFILE (cust);
+
+  /* An entry of a line table, with the index of its filetab.  */
+  struct merged_entry
+  {
+    CORE_ADDR pc;
+    int file;
+    struct linetable_entry *item;
+  };
+
+  std::vector<struct symtab *> files;
+  std::vector<merged_entry> merged;
+  for (symtab *iter_s : compunit_filetabs (cust))
+    {
+      struct linetable *l = SYMTAB_LINETABLE (iter_s);
+
+      if (l == NULL || l->nitems <= 0)
+	continue;
+
+      int file = files.size ();
+      files.push_back (iter_s);
+      for (int i = 0; i < l->nitems; i++)
+	merged.push_back ({ l->item[i].pc, file, &l->item[i] });
+    }
+
+  /* Each line table is sorted by PC, and keeps the order of the
+     entries at the same PC.  */
+  std::stable_sort (merged.begin (), merged.end (),
+		    [] (const merged_entry &a, const merged_entry &b)
+		    {
+		      return a.pc < b.pc;
+		    });
+
+  /* The current entry of each filetab, and the set of filetabs whose
+     current entry is a real line, keyed so that the last element is
+     the latest of these entries, in the earliest filetab.  */
+  std::vector<struct linetable_entry *> current (files.size ());
+  std::set<std::pair<CORE_ADDR, int>> candidates;
+  std::vector<line_index_entry> index;
+
+  for (size_t i = 0; i < merged.size (); )
+    {
+      CORE_ADDR pc = merged[i].pc;
+
+      for (; i < merged.size () && merged[i].pc == pc; i++)
+	{
+	  int file = merged[i].file;
+
+	  if (current[file] != NULL && current[file]->line != 0)
+	    candidates.erase ({ current[file]->pc, -file });
+	  current[file] = merged[i].item;
+	  if (current[file]->line != 0)
+	    candidates.insert ({ pc, -file });
+	}
+
+      if (candidates.empty ())
+	index.push_back ({ pc, 0, NULL, 0 });
+      else
+	{
+	  const std::pair<CORE_ADDR, int> &best = *candidates.rbegin ();
+
+	  index.push_back ({ pc, best.first, files[-best.second],
+			     current[-best.second]->line });
+	}
+    }
+
+  struct compunit_line_index *result
+    = OBSTACK_ZALLOC (&objfile->objfile_obstack, struct compunit_line_index);
+  result->nitems = index.size ();
+  result->items = XOBNEWVEC (&objfile->objfile_obstack,
+			     struct line_index_entry, index.size ());
+  std::copy (index.begin (), index.end (), result->items);
+  return result;
+}
+
+/* Return the line index of CUST, building it if needed.  */
+
+static const struct compunit_line_index *
+get_compunit_line_index (struct compunit_symtab *cust)
+{
+  if (cust->line_index == NULL)
+    cust->line_index = build_compunit_line_index (cust);
+  return cust->line_index;
+}
+
 /* Find the source file and line number for a given PC value and SECTION.
    Return a structure containing a symtab pointer, a line number,
    and a pc range for the entire source line.
@@ -3049,35 +3171,17 @@ find_symbol_at_address (CORE_ADDR address)
    code in the middle of a subroutine.  To properly find the end of a line's PC
    range, we must search all symtabs associated with this compilation unit, and
    find the one whose first PC is closer than that of the next line in this
-   symtab.  */
+   symtab.  The line index of the compilation unit, see
+   build_compunit_line_index, holds the result of that search for every
+   PC at which a line starts.  */
 
 struct symtab_and_line
 find_pc_sect_line (CORE_ADDR pc, struct obj_section *section, int notcurrent)
 {
   struct compunit_symtab *cust;
-  struct linetable *l;
-  int len;
-  struct linetable_entry *item;
   const struct blockvector *bv;
   struct bound_minimal_symbol msymbol;
 
-  /* Info on best line seen so far, and where it starts, and its file.  */
-
-  struct linetable_entry *best = NULL;
-  CORE_ADDR best_end = 0;
-  struct symtab *best_symtab = 0;
-
-  /* Store here the first line number
-     of a file which contains the line at the smallest pc after PC.
-     If we don't find a line whose range contains PC,
-     we will use a line one less than this,
-     with a range from the start of that file to the first line's pc.  */
-  struct linetable_entry *alt = NULL;
-
-  /* Info on best line seen in this file.  */
-
-  struct linetable_entry *prev;
-
   /* If this pc is not from the current frame,
      it is the address of the end of a call instruction.
      Quite likely that is the start of the following statement.
@@ -3194,98 +3298,40 @@ find_pc_sect_line (CORE_ADDR pc, struct obj_section *section, int notcurrent)
 
   bv = COMPUNIT_BLOCKVECTOR (cust);
 
-  /* Look at all the symtabs that share this blockvector.
-     They all have the same apriori range, that we found was right;
-     but they have different line tables.  */
+  /* Look up PC in the line tables of all the symtabs that share this
+     blockvector.  They all have the same apriori range, that we found
+     was right; but they have different line tables.  */
 
-  for (symtab *iter_s : compunit_filetabs (cust))
-    {
-      /* Find the best line in this symtab.  */
-      l = SYMTAB_LINETABLE (iter_s);
-      if (!l)
-	continue;
-      len = l->nitems;
-      if (len <= 0)
-	{
-	  /* I think len can be zero if the symtab lacks line numbers
-	     (e.g. gcc -g1).  (Either that or the LINETABLE is NULL;
-	     I'm not sure which, and maybe it depends on the symbol
-	     reader).  */
-	  continue;
-	}
-
-      prev = NULL;
-      item = l->item;		/* Get first line info.  */
-
-      /* Is this file's first line closer than the first lines of other files?
-         If so, record this file, and its first line, as best alternate.  */
-      if (item->pc > pc && (!alt || item->pc < alt->pc))
-	alt = item;
-
-      auto pc_compare = [](const CORE_ADDR & comp_pc,
-			   const struct linetable_entry & lhs)->bool
-      {
-	return comp_pc < lhs.pc;
-      };
-
-      struct linetable_entry *first = item;
-      struct linetable_entry *last = item + len;
-      item = std::upper_bound (first, last, pc, pc_compare);
-      if (item != first)
-	prev = item - 1;		/* Found a matching item.  */
-
-      /* At this point, prev points at the line whose start addr is <= pc, and
-         item points at the next line.  If we ran off the end of the linetable
-         (pc >= start of the last line), then prev == item.  If pc < start of
-         the first line, prev will not be set.  */
-
-      /* Is this file's best line closer than the best in the other files?
-         If so, record this file, and its best line, as best so far.  Don't
-         save prev if it represents the end of a function (i.e. line number
-         0) instead of a real line.  */
-
-      if (prev && prev->line && (!best || prev->pc > best->pc))
-	{
-	  best = prev;
-	  best_symtab = iter_s;
-
-	  /* Discard BEST_END if it's before the PC of the current BEST.  */
-	  if (best_end <= best->pc)
-	    best_end = 0;
-	}
-
-      /* If another line (denoted by ITEM) is in the linetable and its
-	 PC is after BEST's PC, but before the current BEST_END, then
-	 use ITEM's PC as the new best_end.  */
-      if (best && item < last && item->pc > best->pc
-	  && (best_end == 0 || best_end > item->pc))
-	best_end = item->pc;
-    }
+  const struct compunit_line_index *index = get_compunit_line_index (cust);
+  const struct line_index_entry *first = index->items;
+  const struct line_index_entry *last = index->items + index->nitems;
+  const struct line_index_entry *item
+    = std::upper_bound (first, last, pc,
+			[] (CORE_ADDR comp_pc, const line_index_entry &lhs)
+			{
+			  return comp_pc < lhs.pc;
+			});
 
-  if (!best_symtab)
+  if (item == first || item[-1].symtab == NULL)
     {
       /* If we didn't find any line number info, just return zeros.
-	 We used to return alt->line - 1 here, but that could be
-	 anywhere; if we don't have line number info for this PC,
-	 don't make some up.  */
-      val.pc = pc;
-    }
-  else if (best->line == 0)
-    {
-      /* If our best fit is in a range of PC's for which no line
-	 number info is available (line number is zero) then we didn't
-	 find any valid line information.  */
+	 We used to return the line before the first line after PC
+	 here, but that could be anywhere; if we don't have line
+	 number info for this PC, don't make some up.  If our best fit
+	 is in a range of PC's for which no line number info is
+	 available (line number is zero) then we didn't find any valid
+	 line information either.  */
       val.pc = pc;
     }
   else
     {
-      val.symtab = best_symtab;
+      const struct line_index_entry *best = item - 1;
+
+      val.symtab = best->symtab;
       val.line = best->line;
-      val.pc = best->pc;
-      if (best_end && (!alt || best_end < alt->pc))
-	val.end = best_end;
-      else if (alt)
-	val.end = alt->pc;
+      val.pc = best->line_pc;
+      if (item < last)
+	val.end = item->pc;
       else
 	val.end = BLOCK_END (BLOCKVECTOR_BLOCK (bv, GLOBAL_BLOCK));
     }
@@ -3308,6 +3354,95 @@ find_pc_line (CORE_ADDR pc, int notcurrent)
 
 /* See symtab.h.  */
 
+std::vector<pc_symbolization>
+symbolize_pcs (gdb::array_view<const CORE_ADDR> pcs)
+{
+  std::vector<pc_symbolization> result (pcs.size ());
+
+  /* Visit the PCs in address order, so that the compunit, function
+     and line of a PC can be reused for the next ones.  */
+  std::vector<size_t> order (pcs.size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::stable_sort (order.begin (), order.end (),
+		    [&] (size_t a, size_t b)
+		    {
+		      return pcs[a] < pcs[b];
+		    });
+
+  /* The previous PC, its symbolization, and the compunit and
+     non-inlined function block containing it.  */
+  CORE_ADDR prev_pc = 0;
+  const pc_symbolization *prev = NULL;
+  struct compunit_symtab *cust = NULL;
+  const struct block *function_block = NULL;
+
+  for (size_t i : order)
+    {
+      CORE_ADDR pc = pcs[i];
+      pc_symbolization &sym = result[i];
+
+      QUIT;
+
+      if (prev != NULL && pc == prev_pc)
+	{
+	  sym = *prev;
+	  continue;
+	}
+
+      /* Since PCs come in increasing order, PC is in the function of
+	 the previous PC if it is before the function's end.  */
+      struct compunit_symtab *prev_cust = cust;
+      if (function_block == NULL
+	  || !BLOCK_CONTIGUOUS_P (function_block)
+	  || pc >= BLOCK_END (function_block))
+	cust = find_pc_compunit_symtab (pc);
+
+      function_block = NULL;
+      if (cust != NULL)
+	{
+	  const struct block *b = NULL;
+
+	  if (blockvector_for_pc_sect (pc, find_pc_mapped_section (pc),
+				       &b, cust) == NULL)
+	    b = NULL;
+	  for (; b != NULL; b = BLOCK_SUPERBLOCK (b))
+	    if (BLOCK_FUNCTION (b) != NULL)
+	      {
+		sym.functions.push_back (BLOCK_FUNCTION (b));
+		if (!block_inlined_p (b))
+		  {
+		    function_block = b;
+		    break;
+		  }
+	      }
+	}
+
+      if (sym.functions.empty ())
+	sym.msymbol = lookup_minimal_symbol_by_pc (pc);
+
+      /* The line of the previous PC extends up to its end, and PC is
+	 after the previous PC.  Only reuse lines that contain the
+	 previous PC, not those find_pc_line redirected elsewhere, e.g.
+	 from a trampoline.  */
+      if (prev != NULL
+	  && cust != NULL
+	  && cust == prev_cust
+	  && prev->sal.symtab != NULL
+	  && prev->sal.pc <= prev_pc
+	  && pc < prev->sal.end)
+	sym.sal = prev->sal;
+      else
+	sym.sal = find_pc_line (pc, 0);
+
+      prev = &sym;
+      prev_pc = pc;
+    }
+
+  return result;
+}
+
+/* See symtab.h.  */
+
 struct symtab *
 find_pc_line_symtab (CORE_ADDR pc)
 {
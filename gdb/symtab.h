@@ -30,6 +30,7 @@
 #include "common/function-view.h"
 #include "common/gdb_optional.h"
 #include "common/next-iterator.h"
+#include "common/array-view.h"
 #include "completer.h"
 
 /* Opaque declarations.  */
@@ -1445,6 +1446,11 @@ struct compunit_symtab
   /* struct call_site entries for this compilation unit or NULL.  */
   htab_t call_site_htab;
 
+  /* The line tables of all the filetabs merged into one index sorted
+     by PC, built the first time find_pc_sect_line needs it, or
+     NULL.  */
+  struct compunit_line_index *line_index;
+
   /* The macro table for this symtab.  Like the blockvector, this
      is shared between different symtabs in a given compilation unit.
      It's debatable whether it *should* be shared among all the symtabs in
@@ -1865,6 +1871,31 @@ extern struct symtab_and_line find_pc_line (CORE_ADDR, int);
 extern struct symtab_and_line find_pc_sect_line (CORE_ADDR,
 						 struct obj_section *, int);
 
+/* The symbolization of a PC, as computed by symbolize_pcs.  */
+
+struct pc_symbolization
+{
+  /* The line containing the PC, as find_pc_line returns it.  */
+  symtab_and_line sal;
+
+  /* The functions of the blocks containing the PC, from the innermost
+     to the first one that is not inlined.  Empty if there is no debug
+     information for the PC.  */
+  std::vector<struct symbol *> functions;
+
+  /* The minimal symbol containing the PC, if FUNCTIONS is empty.  */
+  bound_minimal_symbol msymbol {};
+};
+
+/* Symbolize all of PCS at once, in the current program space, and
+   return the results in the same order.  The PCS need not be sorted.
+   This is much faster than looking up each PC by itself, since
+   consecutive PCs in the same function or line share the lookup of
+   their compunit and line.  */
+
+extern std::vector<pc_symbolization>
+  symbolize_pcs (gdb::array_view<const CORE_ADDR> pcs);
+
 /* Wrapper around find_pc_line to just return the symtab.  */
 
 extern struct symtab *find_pc_line_symtab (CORE_ADDR);
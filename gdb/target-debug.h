@@ -118,6 +118,10 @@
   target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_std_vector_mem_region(X) \
   target_debug_do_print (host_address_to_string (X.data ()))
+#define target_debug_print_const_std_vector_mem_range_r(X) \
+  target_debug_do_print (host_address_to_string (X.data ()))
+#define target_debug_print_std_vector_ULONGEST_p(X) \
+  target_debug_do_print (host_address_to_string (X))
 #define target_debug_print_std_vector_static_tracepoint_marker(X)	\
   target_debug_do_print (host_address_to_string (X.data ()))
 #define target_debug_print_const_struct_target_desc_p(X)	\
@@ -93,6 +93,7 @@ struct dummy_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  bool read_memory_ranges (const std::vector<mem_range> &arg0, gdb_byte *arg1, std::vector<ULONGEST> *arg2) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -100,6 +101,7 @@ struct dummy_target : public target_ops
   ptid_t get_ada_task_ptid (long arg0, long arg1) override;
   int auxv_parse (gdb_byte **arg0, gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  bool supports_native_search_memory () override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -261,6 +263,7 @@ struct debug_target : public target_ops
   CORE_ADDR get_thread_local_address (ptid_t arg0, CORE_ADDR arg1, CORE_ADDR arg2) override;
   enum target_xfer_status xfer_partial (enum target_object arg0, const char *arg1, gdb_byte *arg2, const gdb_byte *arg3, ULONGEST arg4, ULONGEST arg5, ULONGEST *arg6) override;
   ULONGEST get_memory_xfer_limit () override;
+  bool read_memory_ranges (const std::vector<mem_range> &arg0, gdb_byte *arg1, std::vector<ULONGEST> *arg2) override;
   std::vector<mem_region> memory_map () override;
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
@@ -268,6 +271,7 @@ struct debug_target : public target_ops
   ptid_t get_ada_task_ptid (long arg0, long arg1) override;
   int auxv_parse (gdb_byte **arg0, gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  bool supports_native_search_memory () override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -2434,6 +2438,36 @@ debug_target::get_memory_xfer_limit ()
   return result;
 }
 
+bool
+target_ops::read_memory_ranges (const std::vector<mem_range> &arg0, gdb_byte *arg1, std::vector<ULONGEST> *arg2)
+{
+  return this->beneath ()->read_memory_ranges (arg0, arg1, arg2);
+}
+
+bool
+dummy_target::read_memory_ranges (const std::vector<mem_range> &arg0, gdb_byte *arg1, std::vector<ULONGEST> *arg2)
+{
+  return false;
+}
+
+bool
+debug_target::read_memory_ranges (const std::vector<mem_range> &arg0, gdb_byte *arg1, std::vector<ULONGEST> *arg2)
+{
+  bool result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->read_memory_ranges (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->read_memory_ranges (arg0, arg1, arg2);
+  fprintf_unfiltered (gdb_stdlog, "<- %s->read_memory_ranges (", this->beneath ()->shortname ());
+  target_debug_print_const_std_vector_mem_range_r (arg0);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_gdb_byte_p (arg1);
+  fputs_unfiltered (", ", gdb_stdlog);
+  target_debug_print_std_vector_ULONGEST_p (arg2);
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 std::vector<mem_region>
 target_ops::memory_map ()
 {
@@ -2623,6 +2657,31 @@ debug_target::search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2
   return result;
 }
 
+bool
+target_ops::supports_native_search_memory ()
+{
+  return this->beneath ()->supports_native_search_memory ();
+}
+
+bool
+dummy_target::supports_native_search_memory ()
+{
+  return false;
+}
+
+bool
+debug_target::supports_native_search_memory ()
+{
+  bool result;
+  fprintf_unfiltered (gdb_stdlog, "-> %s->supports_native_search_memory (...)\n", this->beneath ()->shortname ());
+  result = this->beneath ()->supports_native_search_memory ();
+  fprintf_unfiltered (gdb_stdlog, "<- %s->supports_native_search_memory (", this->beneath ()->shortname ());
+  fputs_unfiltered (") = ", gdb_stdlog);
+  target_debug_print_bool (result);
+  fputs_unfiltered ("\n", gdb_stdlog);
+  return result;
+}
+
 bool
 target_ops::can_execute_reverse ()
 {
@@ -47,7 +47,11 @@
 #include "event-top.h"
 #include <algorithm>
 #include "common/byte-vector.h"
+#include "common/scope-exit.h"
+#include "common/thread-pool.h"
 #include "terminal.h"
+#include <map>
+#include <set>
 #include <unordered_map>
 
 static void generic_tls_error (void) ATTRIBUTE_NORETURN;
@@ -2356,6 +2360,308 @@ target_search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 				      pattern, pattern_len, found_addrp);
 }
 
+/* Finds all the occurrences of a set of patterns in a buffer.
+
+   Patterns of the same length are looked for together.  Their first
+   eight bytes (or fewer, for shorter patterns) make a key; a bitmap
+   indexed by a hash of the keys rules out most positions of the
+   buffer with a single load and test, and the remaining positions
+   are looked up in a hash table of the keys.  */
+
+class multi_pattern_matcher
+{
+public:
+
+  explicit multi_pattern_matcher
+    (const std::vector<gdb::byte_vector> &patterns);
+
+  /* Append to MATCHES the offset and the pattern index of each
+     occurrence in BUF[0, LEN) that starts before START_LEN, ordered by
+     offset and then by pattern.  */
+  void search (const gdb_byte *buf, size_t len, size_t start_len,
+	       std::vector<std::pair<size_t, size_t>> &matches) const;
+
+private:
+
+  /* The patterns of a given length.  */
+  struct group
+  {
+    /* The length of the patterns, and of their keys.  */
+    size_t len;
+    size_t key_len;
+
+    /* The bitmap of the key hashes, and the shift that maps a hash to
+       a bit.  */
+    std::vector<uint64_t> bitmap;
+    int shift;
+
+    /* The patterns, by key.  */
+    std::unordered_map<uint64_t, std::vector<size_t>> by_key;
+  };
+
+  /* Return the hash of KEY used to index the bitmap of GROUP.  */
+  static size_t bit_of (const group &group, uint64_t key)
+  {
+    return (key * 0x9e3779b97f4a7c15ull) >> group.shift;
+  }
+
+  /* Return the key of the KEY_LEN bytes at P.  */
+  static uint64_t key_at (const gdb_byte *p, size_t key_len)
+  {
+    uint64_t key = 0;
+
+    if (key_len == sizeof (key))
+      memcpy (&key, p, sizeof (key));
+    else
+      memcpy (&key, p, key_len);
+    return key;
+  }
+
+  const std::vector<gdb::byte_vector> &m_patterns;
+  std::vector<group> m_groups;
+};
+
+multi_pattern_matcher::multi_pattern_matcher
+  (const std::vector<gdb::byte_vector> &patterns)
+  : m_patterns (patterns)
+{
+  std::map<size_t, std::vector<size_t>> by_len;
+
+  for (size_t i = 0; i < patterns.size (); ++i)
+    by_len[patterns[i].size ()].push_back (i);
+
+  for (const auto &it : by_len)
+    {
+      group g;
+
+      g.len = it.first;
+      g.key_len = std::min (g.len, sizeof (uint64_t));
+
+      /* Keep the bitmap sparse, but small enough to stay in the
+	 cache.  */
+      int bits = 16;
+      while (bits < 26 && ((size_t) 1 << bits) < 16 * it.second.size ())
+	++bits;
+      g.shift = 64 - bits;
+      g.bitmap.resize (((size_t) 1 << bits) / 64);
+
+      for (size_t i : it.second)
+	{
+	  uint64_t key = key_at (patterns[i].data (), g.key_len);
+	  size_t bit = bit_of (g, key);
+
+	  g.bitmap[bit / 64] |= (uint64_t) 1 << (bit % 64);
+	  g.by_key[key].push_back (i);
+	}
+
+      m_groups.push_back (std::move (g));
+    }
+}
+
+void
+multi_pattern_matcher::search
+  (const gdb_byte *buf, size_t len, size_t start_len,
+   std::vector<std::pair<size_t, size_t>> &matches) const
+{
+  size_t first = matches.size ();
+
+  for (const group &g : m_groups)
+    {
+      if (len < g.len)
+	continue;
+
+      size_t end = std::min (start_len, len - g.len + 1);
+      for (size_t i = 0; i < end; ++i)
+	{
+	  uint64_t key = key_at (buf + i, g.key_len);
+	  size_t bit = bit_of (g, key);
+
+	  if ((g.bitmap[bit / 64] & ((uint64_t) 1 << (bit % 64))) == 0)
+	    continue;
+
+	  auto found = g.by_key.find (key);
+	  if (found == g.by_key.end ())
+	    continue;
+
+	  for (size_t pattern : found->second)
+	    if (g.len == g.key_len
+		|| memcmp (buf + i + g.key_len,
+			   m_patterns[pattern].data () + g.key_len,
+			   g.len - g.key_len) == 0)
+	      matches.emplace_back (i, pattern);
+	}
+    }
+
+  /* The groups were searched one after the other.  */
+  std::sort (matches.begin () + first, matches.end ());
+}
+
+/* Implement search_memory_multi for a target that searches memory
+   itself, by searching for each pattern with target_search_memory.
+   The next match of every pattern is kept, and the first one reported
+   before looking for the next match of its pattern.  Returns 1,
+   without reporting anything, if the first search found out that the
+   target does not search memory itself after all; otherwise returns
+   as search_memory_multi, though an error stops the search at once.  */
+
+static int
+search_memory_multi_native
+  (CORE_ADDR start_addr, ULONGEST search_space_len,
+   const std::vector<gdb::byte_vector> &patterns,
+   gdb::function_view<bool (CORE_ADDR, size_t)> match)
+{
+  /* The next match of each pattern, by address and then by
+     pattern.  */
+  std::set<std::pair<CORE_ADDR, size_t>> next;
+
+  /* Look for PATTERNS[I] from ADDR to the end of the search space.  */
+  auto search = [&] (size_t i, CORE_ADDR addr)
+    {
+      ULONGEST left = search_space_len - (addr - start_addr);
+      CORE_ADDR found_addr;
+
+      if (patterns[i].size () > left)
+	return 0;
+
+      int found = target_search_memory (addr, left, patterns[i].data (),
+					patterns[i].size (), &found_addr);
+      if (found == 1)
+	next.emplace (found_addr, i);
+      return found;
+    };
+
+  for (size_t i = 0; i < patterns.size (); ++i)
+    {
+      if (search (i, start_addr) == -1)
+	return -1;
+      if (!current_top_target ()->supports_native_search_memory ())
+	return 1;
+    }
+
+  while (!next.empty ())
+    {
+      std::pair<CORE_ADDR, size_t> m = *next.begin ();
+
+      next.erase (next.begin ());
+      if (!match (m.first, m.second))
+	return 0;
+      if (search (m.second, m.first + 1) == -1)
+	return -1;
+    }
+
+  return 0;
+}
+
+/* See target.h.  */
+
+int
+search_memory_multi (CORE_ADDR start_addr, ULONGEST search_space_len,
+		     const std::vector<gdb::byte_vector> &patterns,
+		     gdb::function_view<bool (CORE_ADDR, size_t)> match)
+{
+  /* A target that searches memory itself, like a remote stub, is
+     better asked once per pattern than made to send all of its
+     memory.  */
+  if (current_top_target ()->supports_native_search_memory ())
+    {
+      int result = search_memory_multi_native (start_addr,
+					       search_space_len,
+					       patterns, match);
+      if (result != 1)
+	return result;
+    }
+
+  /* Memory is read in large chunks; while a worker thread searches a
+     chunk, the main thread reads the next one.  Each buffer holds a
+     chunk followed by enough of the next one for the longest pattern
+     to start at the end of the chunk.  */
+  const ULONGEST chunk_size = 1024 * 1024;
+  size_t max_len = 0;
+
+  gdb_assert (!patterns.empty ());
+  for (const gdb::byte_vector &pattern : patterns)
+    {
+      gdb_assert (!pattern.empty ());
+      max_len = std::max (max_len, pattern.size ());
+    }
+
+  multi_pattern_matcher matcher (patterns);
+
+  struct chunk
+  {
+    CORE_ADDR addr;
+    gdb::byte_vector buf;
+    size_t start_len;
+    std::vector<std::pair<size_t, size_t>> matches;
+  };
+  chunk chunks[2];
+  std::future<void> pending;
+  chunk *pending_chunk = NULL;
+
+  /* The search task refers to the buffers on this frame.  */
+  auto wait_pending = make_scope_exit ([&] ()
+    {
+      if (pending.valid ())
+	pending.wait ();
+    });
+
+  /* Report the matches of the chunk being searched.  Return false if
+     MATCH asked to stop.  */
+  auto report_pending = [&] ()
+    {
+      if (pending_chunk == NULL)
+	return true;
+
+      pending.get ();
+      chunk *c = pending_chunk;
+      pending_chunk = NULL;
+      for (const auto &m : c->matches)
+	if (!match (c->addr + m.first, m.second))
+	  return false;
+      return true;
+    };
+
+  CORE_ADDR addr = start_addr;
+  ULONGEST left = search_space_len;
+  for (int next = 0; left > 0; next = 1 - next)
+    {
+      chunk &c = chunks[next];
+      ULONGEST start_len = std::min (left, chunk_size);
+      ULONGEST buf_len = std::min (left, start_len + max_len - 1);
+
+      c.addr = addr;
+      c.start_len = start_len;
+      c.buf.resize (buf_len);
+      c.matches.clear ();
+      if (target_read (current_top_target (), TARGET_OBJECT_MEMORY, NULL,
+		       c.buf.data (), addr, buf_len) != buf_len)
+	{
+	  if (!report_pending ())
+	    return 0;
+	  warning (_("Unable to access %s bytes of target "
+		     "memory at %s, halting search."),
+		   pulongest (buf_len), hex_string (addr));
+	  return -1;
+	}
+
+      if (!report_pending ())
+	return 0;
+
+      pending_chunk = &c;
+      pending = gdb::thread_pool::g_thread_pool->post_task ([&matcher, &c] ()
+	{
+	  matcher.search (c.buf.data (), c.buf.size (), c.start_len,
+			  c.matches);
+	});
+
+      addr += start_len;
+      left -= start_len;
+    }
+
+  report_pending ();
+  return 0;
+}
+
 /* Look through the currently pushed targets.  If none of them will
    be able to restart the currently running process, issue an error
    message.  */
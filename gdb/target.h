@@ -43,6 +43,8 @@ struct inferior;
 #include "infrun.h" /* For enum exec_direction_kind.  */
 #include "breakpoint.h" /* For enum bptype.  */
 #include "common/scoped_restore.h"
+#include "common/byte-vector.h"
+#include "common/function-view.h"
 
 /* This include file defines the interface between the main part
    of the debugger, and the part which is target-specific, or
@@ -74,6 +76,7 @@ struct inferior;
 #include "bfd.h"
 #include "symtab.h"
 #include "memattr.h"
+#include "memrange.h"
 #include "common/vec.h"
 #include "common/gdb_signals.h"
 #include "btrace.h"
@@ -776,6 +779,18 @@ struct target_ops
     virtual ULONGEST get_memory_xfer_limit ()
       TARGET_DEFAULT_RETURN (ULONGEST_MAX);
 
+    /* Read the memory RANGES with a single request, storing their
+       contents one after the other in MYADDR.  Set XFERED to the
+       number of bytes read from each range; ranges left out of it
+       were not read.  Return false if the target can't read several
+       ranges at once, in which case the caller should use
+       xfer_partial.  */
+
+    virtual bool read_memory_ranges (const std::vector<mem_range> &ranges,
+				     gdb_byte *myaddr,
+				     std::vector<ULONGEST> *xfered)
+      TARGET_DEFAULT_RETURN (false);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
@@ -840,6 +855,11 @@ struct target_ops
 			       CORE_ADDR *found_addrp)
       TARGET_DEFAULT_FUNC (default_search_memory);
 
+    /* Return true if search_memory searches memory without reading
+       it into GDB, for instance with a remote packet.  */
+    virtual bool supports_native_search_memory ()
+      TARGET_DEFAULT_RETURN (false);
+
     /* Can target execute in reverse?  */
     virtual bool can_execute_reverse ()
       TARGET_DEFAULT_RETURN (false);
@@ -2094,6 +2114,20 @@ extern int target_search_memory (CORE_ADDR start_addr,
                                  ULONGEST pattern_len,
                                  CORE_ADDR *found_addrp);
 
+/* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for all the
+   occurrences of all of PATTERNS, which must not be empty, reading
+   memory only once.  Call MATCH (ADDR, I) for each occurrence of
+   PATTERNS[I] at ADDR, by increasing address and then by pattern,
+   until it returns false.
+
+   The result is 0 if the search completed or was stopped by MATCH,
+   and -1 if there was an error reading memory, in which case the
+   matches before the unreadable memory have been reported.  */
+extern int search_memory_multi
+  (CORE_ADDR start_addr, ULONGEST search_space_len,
+   const std::vector<gdb::byte_vector> &patterns,
+   gdb::function_view<bool (CORE_ADDR, size_t)> match);
+
 /* Target file operations.  */
 
 /* Return nonzero if the filesystem seen by the current inferior
@@ -0,0 +1,52 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+volatile int counter;
+
+#define DEFINE_FUNC(N)				\
+  void						\
+  func ## N (void)				\
+  {						\
+    counter += N;				\
+  }
+
+DEFINE_FUNC (0)
+DEFINE_FUNC (1)
+DEFINE_FUNC (2)
+DEFINE_FUNC (3)
+DEFINE_FUNC (4)
+DEFINE_FUNC (5)
+DEFINE_FUNC (6)
+DEFINE_FUNC (7)
+DEFINE_FUNC (8)
+DEFINE_FUNC (9)
+
+int
+main (void)
+{
+  func0 ();
+  func1 ();
+  func2 ();
+  func3 ();
+  func4 ();
+  func5 ();
+  func6 ();
+  func7 ();
+  func8 ();
+  func9 ();
+  return 0;
+}
@@ -0,0 +1,54 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct item
+{
+  int key;
+  long value;
+};
+
+struct item items[20];
+volatile int sum;
+
+int
+is_odd (int n)
+{
+  return n % 2;
+}
+
+void
+visit (struct item *item, int i)
+{
+  sum += item->value;	/* visit-line */
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 20; i++)
+    {
+      items[i].key = i;
+      items[i].value = i * 10;
+    }
+
+  for (i = 0; i < 20; i++)
+    visit (&items[i], i);
+
+  return 0;	/* done-line */
+}
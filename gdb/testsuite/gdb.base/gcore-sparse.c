@@ -0,0 +1,35 @@
+/* Copyright 2019 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+#define BUF_SIZE (3 * 1024 * 1024)
+
+/* Mostly zero, with a few marked pages, so that gcore leaves holes
+   and writes data in the same chunk.  */
+char buf[BUF_SIZE];
+
+int
+main (void)
+{
+  buf[0] = 1;
+  memset (buf + 1024 * 1024 + 4096, 2, 4096);
+  buf[BUF_SIZE - 1] = 3;
+
+  return 0; /* break-here */
+}
@@ -0,0 +1,34 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Enough types to make .debug_info large enough to be mapped.  */
+
+#define S(n) struct s##n { int a; long b; char c[n]; double d; } v##n;
+#define S10(n) S(n##0) S(n##1) S(n##2) S(n##3) S(n##4) \
+  S(n##5) S(n##6) S(n##7) S(n##8) S(n##9)
+#define S100(n) S10(n##0) S10(n##1) S10(n##2) S10(n##3) S10(n##4) \
+  S10(n##5) S10(n##6) S10(n##7) S10(n##8) S10(n##9)
+
+S100 (1)
+S100 (2)
+S100 (3)
+
+int
+main ()
+{
+  return 0;
+}
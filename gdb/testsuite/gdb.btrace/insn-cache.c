@@ -0,0 +1,45 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+#include <sys/mman.h>
+
+/* nop; nop; nop; nop; nop; ret  */
+static const unsigned char code1[] = { 0x90, 0x90, 0x90, 0x90, 0x90, 0xc3 };
+
+/* mov $1, %eax; ret  */
+static const unsigned char code2[] = { 0xb8, 0x01, 0x00, 0x00, 0x00, 0xc3 };
+
+int
+main (void)
+{
+  void *buf = mmap (NULL, 4096, PROT_READ | PROT_WRITE | PROT_EXEC,
+		    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  int (*fun) (void) = (int (*) (void)) buf;
+
+  if (buf == MAP_FAILED)
+    return 1;
+
+  memcpy (buf, code1, sizeof (code1));
+  fun ();
+
+  /* Replace the code the trace went through.  */
+  memcpy (buf, code2, sizeof (code2)); /* bp.1 */
+  fun ();
+
+  return 0; /* bp.2 */
+}
@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int glob[64];
+char big[100000];
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i, s = 0;
+
+  for (i = 0; i < 64; i++)
+    glob[i] = i;
+  marker ();
+  for (i = 0; i < sizeof (big); i += 7)
+    big[i] = 'y';
+  marker ();
+  for (i = 0; i < 64; i++)
+    s += glob[i];
+  glob[0] = s;
+  return 0;	/* end of main */
+}
@@ -0,0 +1,58 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Holds different contents in each process and image, at the same
+   address.  */
+char image[32];
+
+void
+marker (void)
+{
+}
+
+int
+main (int argc, char **argv)
+{
+  pid_t pid;
+
+  if (argc > 1)
+    {
+      strcpy (image, "after exec");
+      marker ();
+      return 0;
+    }
+
+  strcpy (image, "before fork");
+  marker ();
+
+  pid = fork ();
+  if (pid == 0)
+    {
+      strcpy (image, "child");
+      marker ();
+      execl (argv[0], argv[0], "exec", (char *) NULL);
+      abort ();
+    }
+
+  waitpid (pid, NULL, 0);
+  return 0;
+}
@@ -0,0 +1,63 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2019 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <unistd.h>
+#include <pthread.h>
+
+#define NUM 4
+#define ITERATIONS 50
+
+volatile int counter;
+
+void
+tick (int n)
+{
+  counter += n;		/* tick line */
+}
+
+void *
+thread_function (void *arg)
+{
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)
+    tick (i);
+
+  return NULL;
+}
+
+void
+all_done (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM];
+  int i;
+
+  alarm (60);
+
+  for (i = 0; i < NUM; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+  for (i = 0; i < NUM; i++)
+    pthread_join (threads[i], NULL);
+
+  all_done ();
+  return 0;
+}